@@ -0,0 +1,131 @@
+#include "BenchReporter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string_view>
+
+namespace
+{
+	//JSONの文字列にする
+	std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+		escaped.reserve(text.size() + 2);
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+			{
+				escaped += '\\';
+			}
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	//JSONの数値にする(有効数字を落とさない)
+	std::string FormatNumber(double value)
+	{
+		char text[64];
+		std::snprintf(text, sizeof(text), "%.6g", value);
+		return text;
+	}
+}
+
+BenchReporter::BenchReporter(const std::string& suiteName, int argc, char** argv)
+	: suiteName(suiteName)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument = argv[i];
+		if (argument.starts_with("--json="))
+		{
+			jsonPath = argument.substr(7);
+		}
+		else if (argument.starts_with("--filter="))
+		{
+			filter = argument.substr(9);
+		}
+		else if (argument.starts_with("--min-time="))
+		{
+			minTime = std::atof(std::string(argument.substr(11)).c_str());
+		}
+		else if (argument.starts_with("--trials="))
+		{
+			trialCount = static_cast<uint32_t>((std::max)(std::atoi(std::string(argument.substr(9)).c_str()), 1));
+		}
+	}
+	std::printf("[%s]\n", suiteName.c_str());
+}
+
+//計測結果以外の値を記録する
+void BenchReporter::AddValue(const std::string& name, double value)
+{
+	if (!IsEnabled(name))
+	{
+		return;
+	}
+	values.emplace_back(name, value);
+	std::printf("  %-48s %14s\n", name.c_str(), FormatNumber(value).c_str());
+}
+
+//JSONを書き出す
+int BenchReporter::Finish()
+{
+	if (jsonPath.empty())
+	{
+		return 0;
+	}
+
+	std::ofstream file(jsonPath, std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::fprintf(stderr, "cannot open %s\n", jsonPath.c_str());
+		return 1;
+	}
+	file << "{\n  \"suite\": \"" << EscapeJson(suiteName) << "\",\n  \"results\": [";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+		const double itemsPerSecond = result.itemsPerOp * 1.0e9 / result.nsPerOp;
+		file << (i == 0 ? "\n" : ",\n");
+		file << "    {\"name\": \"" << EscapeJson(result.name) << "\", \"ns_per_op\": " << FormatNumber(result.nsPerOp)
+			<< ", \"items_per_op\": " << FormatNumber(result.itemsPerOp) << ", \"item_unit\": \"" << EscapeJson(result.itemUnit)
+			<< "\", \"items_per_second\": " << FormatNumber(itemsPerSecond);
+		if (result.bytesPerOp > 0.0)
+		{
+			file << ", \"bytes_per_second\": " << FormatNumber(result.bytesPerOp * 1.0e9 / result.nsPerOp);
+		}
+		file << ", \"iterations\": " << result.iterations << "}";
+	}
+	file << "\n  ],\n  \"values\": {";
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		file << (i == 0 ? "\n" : ",\n") << "    \"" << EscapeJson(values[i].first) << "\": " << FormatNumber(values[i].second);
+	}
+	file << "\n  }\n}\n";
+	return file.good() ? 0 : 1;
+}
+
+//フィルタに合うか
+bool BenchReporter::IsEnabled(const std::string& name) const
+{
+	return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+//結果を記録して表示する
+void BenchReporter::AddResult(Result result)
+{
+	const double itemsPerSecond = result.itemsPerOp * 1.0e9 / result.nsPerOp;
+	if (result.bytesPerOp > 0.0)
+	{
+		std::printf("  %-48s %12.2f ns/op %12.4g %s/s %10.1f MB/s\n", result.name.c_str(), result.nsPerOp, itemsPerSecond, result.itemUnit.c_str(), result.bytesPerOp * 1.0e3 / result.nsPerOp);
+	}
+	else
+	{
+		std::printf("  %-48s %12.2f ns/op %12.4g %s/s\n", result.name.c_str(), result.nsPerOp, itemsPerSecond, result.itemUnit.c_str());
+	}
+	std::fflush(stdout);
+	results.push_back(std::move(result));
+}
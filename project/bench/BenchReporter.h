@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+//計測した値を最適化で消されないようにする
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	static_cast<void>(*reinterpret_cast<const volatile char*>(&value));
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+//ベンチマークの計測と結果の出力(ns/opと1秒あたりの処理量を表にして、--json=<path>があればJSONでも書き出す)
+class BenchReporter
+{
+public:
+	//1つの計測結果
+	struct Result {
+		std::string name;
+		//1回あたりの時間(試行の中央値)
+		double nsPerOp;
+		//1回あたりの処理量(頂点数・行列数など)と単位
+		double itemsPerOp;
+		std::string itemUnit;
+		//1回あたりに読むバイト数(0なら出さない)
+		double bytesPerOp;
+		uint64_t iterations;
+	};
+
+	/// <summary>
+	/// コマンドライン引数を読む
+	/// </summary>
+	/// <param name="suiteName">JSONに書くベンチマークの名前</param>
+	/// <param name="argc">--json=<path>:JSONの書き出し先 --filter=<文字列>:名前に含むものだけ計測 --min-time=<秒>:1試行の最短時間 --trials=<回数>:試行の回数</param>
+	BenchReporter(const std::string& suiteName, int argc, char** argv);
+
+	/// <summary>
+	/// 計測する(1試行が最短時間を超えるまで回数を増やし、試行の中央値を取る)
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <param name="itemsPerOp">1回あたりの処理量</param>
+	/// <param name="itemUnit">処理量の単位</param>
+	/// <param name="bytesPerOp">1回あたりのバイト数(0なら出さない)</param>
+	/// <param name="function">1回分の処理(引数は何回目か。入力をずらして定数畳み込みされないようにする)</param>
+	template<typename Function>
+	void Run(const std::string& name, double itemsPerOp, const std::string& itemUnit, double bytesPerOp, Function&& function);
+
+	//計測結果以外の値を記録する(精度など)
+	void AddValue(const std::string& name, double value);
+
+	//JSONを書き出す。終了コードを返す
+	int Finish();
+
+	//計測結果
+	const std::vector<Result>& GetResults() const { return results; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	//フィルタに合うか
+	bool IsEnabled(const std::string& name) const;
+	//結果を記録して表示する
+	void AddResult(Result result);
+
+	std::string suiteName;
+	std::string jsonPath;
+	std::string filter;
+	double minTime = 0.05;
+	uint32_t trialCount = 5;
+	std::vector<Result> results;
+	std::vector<std::pair<std::string, double>> values;
+};
+
+template<typename Function>
+void BenchReporter::Run(const std::string& name, double itemsPerOp, const std::string& itemUnit, double bytesPerOp, Function&& function)
+{
+	if (!IsEnabled(name))
+	{
+		return;
+	}
+
+	//1試行が最短時間を超える回数を探す(最初の1回はキャッシュを温めるのも兼ねる)
+	uint64_t iterations = 1;
+	for (;;)
+	{
+		const Clock::time_point begin = Clock::now();
+		for (uint64_t i = 0; i < iterations; ++i)
+		{
+			function(static_cast<size_t>(i));
+		}
+		const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+		if (seconds >= minTime || iterations >= (1ull << 40))
+		{
+			break;
+		}
+		//短すぎるときは一気に増やす
+		const double scale = seconds > 0.0 ? minTime * 1.2 / seconds : 100.0;
+		iterations = static_cast<uint64_t>(static_cast<double>(iterations) * (scale < 2.0 ? 2.0 : (scale > 100.0 ? 100.0 : scale)));
+	}
+
+	std::vector<double> nsPerOp(trialCount);
+	for (double& trialNsPerOp : nsPerOp)
+	{
+		const Clock::time_point begin = Clock::now();
+		for (uint64_t i = 0; i < iterations; ++i)
+		{
+			function(static_cast<size_t>(i));
+		}
+		trialNsPerOp = std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / static_cast<double>(iterations);
+	}
+	//外れ値に強い中央値を使う
+	std::nth_element(nsPerOp.begin(), nsPerOp.begin() + nsPerOp.size() / 2, nsPerOp.end());
+
+	AddResult({ name, nsPerOp[nsPerOp.size() / 2], itemsPerOp, itemUnit, bytesPerOp, iterations });
+}
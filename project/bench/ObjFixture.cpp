@@ -0,0 +1,75 @@
+#include "ObjFixture.h"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+//UV球のobjとmtlを書き出す
+bool ObjFixture::WriteSphere(const std::string& directoryPath, const std::string& filename, uint32_t segmentCount)
+{
+	std::error_code error;
+	std::filesystem::create_directories(directoryPath, error);
+
+	const std::string materialFilename = std::filesystem::path(filename).replace_extension(".mtl").string();
+	{
+		std::ofstream file(directoryPath + "/" + materialFilename, std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		file << "newmtl North\nKd 0.8 0.8 0.8\nmap_Kd uvChecker.png\n\nnewmtl South\nKd 0.8 0.8 0.8\nmap_Kd monsterBall.png\n";
+	}
+
+	std::ofstream file(directoryPath + "/" + filename, std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	constexpr float kPi = 3.14159265358979f;
+	const uint32_t longitudeCount = segmentCount < 3 ? 3 : segmentCount;
+	const uint32_t latitudeCount = longitudeCount / 2 < 2 ? 2 : longitudeCount / 2;
+	char line[128];
+	file << "mtllib " << materialFilename << "\no Sphere\n";
+
+	//頂点は緯線ごとに(経度方向に1つ余分に置いてUVの継ぎ目を作る)
+	for (uint32_t latitude = 0; latitude <= latitudeCount; ++latitude)
+	{
+		const float theta = kPi * static_cast<float>(latitude) / static_cast<float>(latitudeCount);
+		for (uint32_t longitude = 0; longitude <= longitudeCount; ++longitude)
+		{
+			const float phi = 2.0f * kPi * static_cast<float>(longitude) / static_cast<float>(longitudeCount);
+			const float x = std::sin(theta) * std::cos(phi);
+			const float y = std::cos(theta);
+			const float z = std::sin(theta) * std::sin(phi);
+			std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x, y, z);
+			file << line;
+			std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", static_cast<float>(longitude) / static_cast<float>(longitudeCount), 1.0f - static_cast<float>(latitude) / static_cast<float>(latitudeCount));
+			file << line;
+			std::snprintf(line, sizeof(line), "vn %.4f %.4f %.4f\n", x, y, z);
+			file << line;
+		}
+	}
+
+	//面(objの番号は1から。頂点・UV・法線は同じ番号)
+	const uint32_t stride = longitudeCount + 1;
+	for (uint32_t latitude = 0; latitude < latitudeCount; ++latitude)
+	{
+		if (latitude == 0 || latitude == latitudeCount / 2)
+		{
+			file << "usemtl " << (latitude == 0 ? "North" : "South") << "\n";
+		}
+		for (uint32_t longitude = 0; longitude < longitudeCount; ++longitude)
+		{
+			const uint32_t i0 = latitude * stride + longitude + 1;
+			const uint32_t i1 = i0 + 1;
+			const uint32_t i2 = i0 + stride;
+			const uint32_t i3 = i2 + 1;
+			std::snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i0, i0, i0, i2, i2, i2, i1, i1, i1);
+			file << line;
+			std::snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i1, i1, i1, i2, i2, i2, i3, i3, i3);
+			file << line;
+		}
+	}
+	return file.good();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+//計測・確認用のobj/mtlファイルを書き出す
+namespace ObjFixture
+{
+	/// <summary>
+	/// UV球のobjと、それが使うmtlを書き出す(北半球と南半球でマテリアルを分ける)
+	/// </summary>
+	/// <param name="directoryPath">書き出し先のディレクトリ(無ければ作る)</param>
+	/// <param name="filename">objのファイル名(mtlは拡張子を.mtlにしたもの)</param>
+	/// <param name="segmentCount">経度方向の分割数(緯度方向はその半分。三角形の数はおよそsegmentCount^2)</param>
+	/// <returns>書き出せたか</returns>
+	bool WriteSphere(const std::string& directoryPath, const std::string& filename, uint32_t segmentCount);
+}
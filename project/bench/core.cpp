@@ -0,0 +1,91 @@
+#include "BenchReporter.h"
+#include "ObjFixture.h"
+#include "ModelLoader.h"
+#include "MyMath.h"
+#include "SpriteGeometry.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//エンジンのDirectX12に依存しない部分(行列・スプライトの頂点・モデル読み込み)の計測
+int main(int argc, char** argv)
+{
+	BenchReporter reporter("core", argc, argv);
+	MyMath myMath;
+
+	//===行列===
+	//入力を毎回ずらして、同じ計算を使い回されないようにする
+	constexpr size_t kInputCount = 64;
+	std::vector<Transform> transforms(kInputCount);
+	std::vector<Matrix4x4> matrices(kInputCount);
+	for (size_t i = 0; i < kInputCount; ++i)
+	{
+		const float t = static_cast<float>(i);
+		transforms[i] = { { 1.0f + t * 0.01f,1.0f,1.0f + t * 0.02f },{ t * 0.1f,t * 0.2f,t * 0.3f },{ t,-t,t * 0.5f } };
+		matrices[i] = myMath.MakeAffineMatrix(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+	}
+	const Matrix4x4 viewProjection = myMath.Multiply(myMath.Inverse(matrices[1]), myMath.MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+
+	reporter.Run("MyMath::Multiply", 1.0, "matrix", 0.0, [&](size_t i) {
+		Matrix4x4 result = myMath.Multiply(matrices[i % kInputCount], matrices[(i + 1) % kInputCount]);
+		DoNotOptimize(result);
+	});
+	reporter.Run("MyMath::Inverse", 1.0, "matrix", 0.0, [&](size_t i) {
+		Matrix4x4 result = myMath.Inverse(matrices[i % kInputCount]);
+		DoNotOptimize(result);
+	});
+	reporter.Run("MyMath::MakeAffineMatrix", 1.0, "matrix", 0.0, [&](size_t i) {
+		const Transform& transform = transforms[i % kInputCount];
+		Matrix4x4 result = myMath.MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+		DoNotOptimize(result);
+	});
+	reporter.Run("MyMath::MakePerspectiveFovMatrix", 1.0, "matrix", 0.0, [&](size_t i) {
+		Matrix4x4 result = myMath.MakePerspectiveFovMatrix(0.45f + static_cast<float>(i % kInputCount) * 0.001f, 16.0f / 9.0f, 0.1f, 100.0f);
+		DoNotOptimize(result);
+	});
+
+	//まとめて作る場合(1024個)
+	constexpr size_t kBatchCount = 1024;
+	std::vector<Transform> batchTransforms(kBatchCount);
+	std::vector<TransformationMatrix> batchMatrices(kBatchCount);
+	for (size_t i = 0; i < kBatchCount; ++i)
+	{
+		batchTransforms[i] = transforms[i % kInputCount];
+	}
+	reporter.Run("MyMath::MakeTransformationMatrices/1024", static_cast<double>(kBatchCount), "matrix", 0.0, [&](size_t) {
+		myMath.MakeTransformationMatrices(batchTransforms, viewProjection, batchMatrices);
+		DoNotOptimize(batchMatrices[0]);
+	});
+
+	//===スプライトの頂点===
+	reporter.Run("SpriteGeometry::MakeVertices", 4.0, "vertex", 0.0, [&](size_t i) {
+		SpriteVertexData vertices[4];
+		const float offset = static_cast<float>(i % kInputCount);
+		SpriteGeometry::MakeVertices({ 0.5f,0.5f }, (i & 1) != 0, (i & 2) != 0, { offset,0.0f }, { 64.0f,64.0f }, { 512.0f,512.0f }, vertices);
+		DoNotOptimize(vertices);
+	});
+
+	//===モデル読み込み===
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "ge3_bench_core").generic_string();
+	if (!ObjFixture::WriteSphere(directoryPath, "sphere.obj", 256))
+	{
+		return 1;
+	}
+	const double objBytes = static_cast<double>(std::filesystem::file_size(directoryPath + "/sphere.obj"));
+	const double mtlBytes = static_cast<double>(std::filesystem::file_size(directoryPath + "/sphere.mtl"));
+	const ModelData modelData = ModelLoader::LoadObjFile(directoryPath, "sphere.obj");
+	reporter.Run("ModelLoader::LoadObjFile", static_cast<double>(modelData.indices.size() / 3), "triangle", objBytes, [&](size_t) {
+		ModelData result = ModelLoader::LoadObjFile(directoryPath, "sphere.obj");
+		DoNotOptimize(result.vertices.data());
+	});
+	reporter.Run("ModelLoader::LoadMaterialTemplateFile", 2.0, "material", mtlBytes, [&](size_t) {
+		std::vector<MaterialData> result = ModelLoader::LoadMaterialTemplateFile(directoryPath, "sphere.mtl");
+		DoNotOptimize(result.data());
+	});
+
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+	return reporter.Finish();
+}
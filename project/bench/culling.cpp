@@ -0,0 +1,115 @@
+#include "BenchReporter.h"
+#include "Culling.h"
+#include "MyMath.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr float kClientWidth = 1280.0f;
+	constexpr float kClientHeight = 720.0f;
+
+	//1個ずつ判定する場合(AoSの配列を平面ごとに早期終了しながら判定する)
+	uint32_t CullSpheresScalar(const std::vector<Sphere>& spheres, const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices)
+	{
+		outVisibleIndices.clear();
+		for (uint32_t i = 0; i < static_cast<uint32_t>(spheres.size()); ++i)
+		{
+			const Sphere& sphere = spheres[i];
+			bool visible = true;
+			for (const Vector4& plane : frustum.planes)
+			{
+				if (sphere.center.x * plane.x + sphere.center.y * plane.y + sphere.center.z * plane.z + plane.w < -sphere.radius)
+				{
+					visible = false;
+					break;
+				}
+			}
+			if (visible)
+			{
+				outVisibleIndices.push_back(i);
+			}
+		}
+		return static_cast<uint32_t>(outVisibleIndices.size());
+	}
+}
+
+//10万個のカリングの計測(スプライトのスクリーン矩形、3Dのスフィア・AABBを平行投影/透視投影の視錐台で判定する)
+int main(int argc, char** argv)
+{
+	BenchReporter reporter("culling", argc, argv);
+	MyMath myMath;
+
+	constexpr uint32_t kObjectCount = 100000;
+	std::mt19937 random(1);
+
+	//===スプライト(画面の3倍の範囲にばらまく)===
+	std::uniform_real_distribution<float> screenX(-kClientWidth, kClientWidth * 2.0f);
+	std::uniform_real_distribution<float> screenY(-kClientHeight, kClientHeight * 2.0f);
+	std::uniform_real_distribution<float> spriteSize(16.0f, 128.0f);
+	ScreenRectBounds screenRects;
+	for (uint32_t i = 0; i < kObjectCount; ++i)
+	{
+		const Vector2 min = { screenX(random),screenY(random) };
+		screenRects.Add(min, { min.x + spriteSize(random),min.y + spriteSize(random) });
+	}
+
+	//===3D(カメラの前後左右にばらまく)===
+	std::uniform_real_distribution<float> worldPosition(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> objectRadius(0.5f, 4.0f);
+	std::vector<Sphere> spheres(kObjectCount);
+	SphereBounds sphereBounds;
+	AABBBounds aabbBounds;
+	for (Sphere& sphere : spheres)
+	{
+		sphere = { { worldPosition(random),worldPosition(random) * 0.25f,worldPosition(random) },objectRadius(random) };
+		sphereBounds.Add(sphere);
+		const Vector3 extent = { sphere.radius,sphere.radius,sphere.radius };
+		aabbBounds.Add({ { sphere.center.x - extent.x,sphere.center.y - extent.y,sphere.center.z - extent.z },{ sphere.center.x + extent.x,sphere.center.y + extent.y,sphere.center.z + extent.z } });
+	}
+
+	const Matrix4x4 perspective = myMath.MakePerspectiveFovMatrix(0.45f, kClientWidth / kClientHeight, 0.1f, 300.0f);
+	const Frustum perspectiveFrustum = Culling::MakeFrustum(perspective);
+	const Frustum orthographicFrustum = Culling::MakeFrustum(myMath.MakeOrthographicMatrix(-100.0f, 60.0f, 100.0f, -60.0f, 0.0f, 300.0f));
+
+	std::vector<uint32_t> visibleIndices;
+	visibleIndices.reserve(kObjectCount);
+	std::vector<uint32_t> referenceIndices;
+	referenceIndices.reserve(kObjectCount);
+
+	reporter.Run("CullScreenRects/100k", kObjectCount, "object", 0.0, [&](size_t) {
+		Culling::CullScreenRects(screenRects, 0.0f, 0.0f, kClientWidth, kClientHeight, visibleIndices);
+		DoNotOptimize(visibleIndices.data());
+	});
+	reporter.AddValue("visible ratio ScreenRects", static_cast<double>(visibleIndices.size()) / kObjectCount);
+
+	reporter.Run("CullSpheres (perspective)/100k", kObjectCount, "object", 0.0, [&](size_t) {
+		Culling::CullSpheres(sphereBounds, perspectiveFrustum, visibleIndices);
+		DoNotOptimize(visibleIndices.data());
+	});
+	reporter.AddValue("visible ratio Spheres (perspective)", static_cast<double>(visibleIndices.size()) / kObjectCount);
+	reporter.Run("scalar AoS spheres (perspective)/100k", kObjectCount, "object", 0.0, [&](size_t) {
+		CullSpheresScalar(spheres, perspectiveFrustum, referenceIndices);
+		DoNotOptimize(referenceIndices.data());
+	});
+	//まとめて判定した結果が1個ずつ判定した結果と同じか
+	Culling::CullSpheres(sphereBounds, perspectiveFrustum, visibleIndices);
+	CullSpheresScalar(spheres, perspectiveFrustum, referenceIndices);
+	reporter.AddValue("CullSpheres matches scalar", visibleIndices == referenceIndices ? 1.0 : 0.0);
+
+	reporter.Run("CullSpheres (orthographic)/100k", kObjectCount, "object", 0.0, [&](size_t) {
+		Culling::CullSpheres(sphereBounds, orthographicFrustum, visibleIndices);
+		DoNotOptimize(visibleIndices.data());
+	});
+	reporter.AddValue("visible ratio Spheres (orthographic)", static_cast<double>(visibleIndices.size()) / kObjectCount);
+
+	reporter.Run("CullAABBs (perspective)/100k", kObjectCount, "object", 0.0, [&](size_t) {
+		Culling::CullAABBs(aabbBounds, perspectiveFrustum, visibleIndices);
+		DoNotOptimize(visibleIndices.data());
+	});
+	reporter.AddValue("visible ratio AABBs (perspective)", static_cast<double>(visibleIndices.size()) / kObjectCount);
+
+	return reporter.Finish();
+}
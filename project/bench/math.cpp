@@ -0,0 +1,63 @@
+#include "BenchReporter.h"
+#include "MathUtility.h"
+#include "MyMath.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+//MyMath::Multiply / MyMath::Inverse の計測
+//bench_mathは選ばれたSIMD版、bench_math_scalarはMYMATH_FORCE_SCALARでビルドしたスカラー版を計測する
+int main(int argc, char** argv)
+{
+#ifdef MYMATH_FORCE_SCALAR
+	BenchReporter reporter("math_scalar", argc, argv);
+#else
+	BenchReporter reporter("math", argc, argv);
+#endif
+	MyMath myMath;
+
+	//入力を毎回ずらして、同じ計算を使い回されないようにする
+	constexpr size_t kInputCount = 256;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	std::vector<Matrix4x4> matrices(kInputCount);
+	for (Matrix4x4& matrix : matrices)
+	{
+		const Vector3 rotate = { distribution(random) * 3.0f,distribution(random) * 3.0f,distribution(random) * 3.0f };
+		const Vector3 scale = { 1.5f + distribution(random),1.5f + distribution(random),1.5f + distribution(random) };
+		const Vector3 translate = { distribution(random) * 10.0f,distribution(random) * 10.0f,distribution(random) * 10.0f };
+		matrix = myMath.MakeAffineMatrix(scale, rotate, translate);
+	}
+
+	reporter.Run("MyMath::Multiply", 1.0, "matrix", 0.0, [&](size_t i) {
+		Matrix4x4 result = myMath.Multiply(matrices[i % kInputCount], matrices[(i + 1) % kInputCount]);
+		DoNotOptimize(result);
+	});
+	reporter.Run("MyMath::Inverse", 1.0, "matrix", 0.0, [&](size_t i) {
+		Matrix4x4 result = myMath.Inverse(matrices[i % kInputCount]);
+		DoNotOptimize(result);
+	});
+	//前の結果を次に使う場合(レイテンシ)
+	Matrix4x4 chain = matrices[0];
+	reporter.Run("MyMath::Multiply (dependent chain)", 1.0, "matrix", 0.0, [&](size_t i) {
+		chain = myMath.Multiply(chain, matrices[i % kInputCount]);
+		chain.m[3][3] = 1.0f;
+		DoNotOptimize(chain);
+	});
+	//インライン展開されるスカラーの参照実装(コンパイラの自動ベクトル化との比較)
+	reporter.Run("MathUtility::Multiply (inline scalar)", 1.0, "matrix", 0.0, [&](size_t i) {
+		Matrix4x4 result = MathUtility::Multiply(matrices[i % kInputCount], matrices[(i + 1) % kInputCount]);
+		DoNotOptimize(result);
+	});
+
+	//スプライト1枚分の行列の計算(World * View * Projection と、カメラ行列の逆行列)
+	const Matrix4x4 projection = myMath.MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f);
+	reporter.Run("Multiply x2 + Inverse (sprite WVP)", 1.0, "sprite", 0.0, [&](size_t i) {
+		const Matrix4x4 view = myMath.Inverse(matrices[(i + 3) % kInputCount]);
+		Matrix4x4 result = myMath.Multiply(matrices[i % kInputCount], myMath.Multiply(view, projection));
+		DoNotOptimize(result);
+	});
+
+	return reporter.Finish();
+}
@@ -0,0 +1,57 @@
+#include "BenchReporter.h"
+#include "ObjFixture.h"
+#include "Culling.h"
+#include "MeshletBuilder.h"
+#include "ModelLoader.h"
+#include "MyMath.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+//メッシュレットの作成と、メッシュレット単位のカリング(視錐台のみ/視錐台+法線コーン)の計測
+int main(int argc, char** argv)
+{
+	BenchReporter reporter("meshlet", argc, argv);
+	MyMath myMath;
+
+	//約3万三角形のUV球
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "ge3_bench_meshlet").generic_string();
+	if (!ObjFixture::WriteSphere(directoryPath, "sphere.obj", 128))
+	{
+		return 1;
+	}
+	const ModelData modelData = ModelLoader::LoadObjFile(directoryPath, "sphere.obj");
+	const double triangleCount = static_cast<double>(modelData.indices.size() / 3);
+
+	reporter.Run("Build", triangleCount, "triangle", 0.0, [&](size_t) {
+		MeshletData meshletData = MeshletBuilder::Build(modelData, modelData.submeshes);
+		DoNotOptimize(meshletData.meshlets.data());
+	});
+
+	const MeshletData meshletData = MeshletBuilder::Build(modelData, modelData.submeshes);
+	const double meshletCount = static_cast<double>(meshletData.meshlets.size());
+	reporter.AddValue("meshlets", meshletCount);
+	reporter.AddValue("triangles per meshlet", triangleCount / meshletCount);
+
+	//球の半分ほどが画面に入るように、近くから見る
+	const Vector3 cameraPosition = { 0.0f,0.0f,-2.0f };
+	const Matrix4x4 viewMatrix = myMath.Inverse(myMath.MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{ 0.0f,0.0f,0.0f }, cameraPosition));
+	const Matrix4x4 projectionMatrix = myMath.MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+	const Frustum frustum = Culling::MakeFrustum(myMath.Multiply(viewMatrix, projectionMatrix));
+
+	MeshletCullResult result;
+	for (bool enableConeCulling : { false, true })
+	{
+		const std::string name = enableConeCulling ? "CullMeshlets/frustum+cone" : "CullMeshlets/frustum";
+		reporter.Run(name, meshletCount, "meshlet", 0.0, [&](size_t) {
+			DoNotOptimize(Culling::CullMeshlets(meshletData, frustum, cameraPosition, enableConeCulling, result));
+		});
+		//残した三角形の割合
+		reporter.AddValue(name + " visible triangles", static_cast<double>(result.indices.size() / 3) / triangleCount);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+	return reporter.Finish();
+}
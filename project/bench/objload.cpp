@@ -0,0 +1,66 @@
+#include "BenchReporter.h"
+#include "ObjFixture.h"
+#include "ModelLoader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+//LoadObjFileのスレッド数ごとの計測(1スレッドから論理コア数まで)
+int main(int argc, char** argv)
+{
+	BenchReporter reporter("objload", argc, argv);
+
+	//大きめのモデル(約13万三角形、十数MB)
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "ge3_bench_objload").generic_string();
+	if (!ObjFixture::WriteSphere(directoryPath, "sphere.obj", 512))
+	{
+		return 1;
+	}
+	const double objBytes = static_cast<double>(std::filesystem::file_size(directoryPath + "/sphere.obj"));
+	const double triangleCount = static_cast<double>(ModelLoader::LoadObjFile(directoryPath, "sphere.obj").indices.size() / 3);
+
+	//2の累乗と論理コア数(コアが少なくても並列の経路を通るように4までは測る)
+	const uint32_t hardwareThreadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+	std::vector<uint32_t> threadCounts;
+	for (uint32_t threadCount = 1; threadCount <= (std::max)(hardwareThreadCount, 4u); threadCount *= 2)
+	{
+		threadCounts.push_back(threadCount);
+	}
+	if (std::find(threadCounts.begin(), threadCounts.end(), hardwareThreadCount) == threadCounts.end())
+	{
+		threadCounts.push_back(hardwareThreadCount);
+	}
+
+	double serialNsPerOp = 0.0;
+	for (uint32_t threadCount : threadCounts)
+	{
+		const std::string name = "LoadObjFile/threads:" + std::to_string(threadCount);
+		reporter.Run(name, triangleCount, "triangle", objBytes, [&](size_t) {
+			ModelData modelData = ModelLoader::LoadObjFile(directoryPath, "sphere.obj", threadCount);
+			DoNotOptimize(modelData.vertices.data());
+		});
+		if (reporter.GetResults().empty() || reporter.GetResults().back().name != name)
+		{
+			continue;
+		}
+		//1スレッドに対して何倍速いか
+		const double nsPerOp = reporter.GetResults().back().nsPerOp;
+		if (threadCount == 1)
+		{
+			serialNsPerOp = nsPerOp;
+		}
+		else if (serialNsPerOp > 0.0)
+		{
+			reporter.AddValue("speedup threads:" + std::to_string(threadCount), serialNsPerOp / nsPerOp);
+		}
+	}
+	reporter.AddValue("hardware threads", hardwareThreadCount);
+
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+	return reporter.Finish();
+}
@@ -0,0 +1,75 @@
+#include "BenchReporter.h"
+#include "SinCos.h"
+#include "SinCosAccuracy.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//SinCosの計測(標準ライブラリのsin/cosと、1個ずつ・まとめて計算する場合)
+int main(int argc, char** argv)
+{
+	BenchReporter reporter("sincos", argc, argv);
+
+	//回転の更新で使う範囲(|x| <= 2π)と、範囲縮小が効く大きい角度
+	constexpr size_t kCount = 4096;
+	std::vector<float> radians(kCount);
+	std::vector<float> largeRadians(kCount);
+	for (size_t i = 0; i < kCount; ++i)
+	{
+		radians[i] = -6.2831853f + 12.566370f * static_cast<float>(i) / static_cast<float>(kCount);
+		largeRadians[i] = radians[i] * 1000.0f;
+	}
+	std::vector<float> sins(kCount);
+	std::vector<float> coss(kCount);
+
+	reporter.Run("std::sin + std::cos/4096", static_cast<double>(kCount), "angle", 0.0, [&](size_t) {
+		for (size_t i = 0; i < kCount; ++i)
+		{
+			sins[i] = std::sin(radians[i]);
+			coss[i] = std::cos(radians[i]);
+		}
+		DoNotOptimize(sins[0]);
+	});
+	reporter.Run("MathUtility::SinCos (scalar)/4096", static_cast<double>(kCount), "angle", 0.0, [&](size_t) {
+		for (size_t i = 0; i < kCount; ++i)
+		{
+			MathUtility::SinCos(radians[i], &sins[i], &coss[i]);
+		}
+		DoNotOptimize(sins[0]);
+	});
+	reporter.Run("MathUtility::SinCos (batch)/4096", static_cast<double>(kCount), "angle", 0.0, [&](size_t) {
+		MathUtility::SinCos(radians.data(), sins.data(), coss.data(), kCount);
+		DoNotOptimize(sins[0]);
+	});
+	reporter.Run("std::sin + std::cos (|x| <= 6283)/4096", static_cast<double>(kCount), "angle", 0.0, [&](size_t) {
+		for (size_t i = 0; i < kCount; ++i)
+		{
+			sins[i] = std::sin(largeRadians[i]);
+			coss[i] = std::cos(largeRadians[i]);
+		}
+		DoNotOptimize(sins[0]);
+	});
+	reporter.Run("MathUtility::SinCos (batch, |x| <= 6283)/4096", static_cast<double>(kCount), "angle", 0.0, [&](size_t) {
+		MathUtility::SinCos(largeRadians.data(), sins.data(), coss.data(), kCount);
+		DoNotOptimize(sins[0]);
+	});
+
+	//精度(倍精度で求めた真値との差)
+	SinCosAccuracy::Result sinResult;
+	SinCosAccuracy::Result cosResult;
+	constexpr size_t kSampleCount = 1000001;
+	for (size_t i = 0; i < kSampleCount; ++i)
+	{
+		const float radian = static_cast<float>(-3.14159265 + 6.2831853 * static_cast<double>(i) / static_cast<double>(kSampleCount - 1));
+		float sinValue = 0.0f;
+		float cosValue = 0.0f;
+		MathUtility::SinCos(radian, &sinValue, &cosValue);
+		SinCosAccuracy::Accumulate(sinResult, sinValue, std::sin(static_cast<double>(radian)));
+		SinCosAccuracy::Accumulate(cosResult, cosValue, std::cos(static_cast<double>(radian)));
+	}
+	reporter.AddValue("max ulp sin (|x| <= pi)", sinResult.maxUlp);
+	reporter.AddValue("max ulp cos (|x| <= pi)", cosResult.maxUlp);
+
+	return reporter.Finish();
+}
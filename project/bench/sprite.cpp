@@ -0,0 +1,106 @@
+#include "BenchReporter.h"
+#include "MathUtility.h"
+#include "MyMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	constexpr float kClientWidth = 1280.0f;
+	constexpr float kClientHeight = 720.0f;
+
+	//1枚分の入力
+	struct SpriteInput {
+		Vector2 position;
+		float rotation;
+		Vector2 size;
+	};
+}
+
+//スプライトの行列計算の計測(4x4行列で作る以前の方法と、2次元のAffine変換で合成する今の方法)
+int main(int argc, char** argv)
+{
+	BenchReporter reporter("sprite", argc, argv);
+	MyMath myMath;
+
+	constexpr size_t kSpriteCount = 1024;
+	std::vector<SpriteInput> sprites(kSpriteCount);
+	for (size_t i = 0; i < kSpriteCount; ++i)
+	{
+		const float t = static_cast<float>(i);
+		sprites[i] = { { std::fmod(t * 37.0f,kClientWidth),std::fmod(t * 53.0f,kClientHeight) },t * 0.01f,{ 32.0f + std::fmod(t,64.0f),48.0f } };
+	}
+	//定数バッファに書き込む先(Sprite::transformationMatrixDataの代わり)
+	std::vector<TransformationMatrix> constants(kSpriteCount);
+
+	//以前の方法: X/Y/Zの回転行列を掛けてWorldを作り、View(単位行列)と平行投影を毎回作って掛ける
+	reporter.Run("4x4 (MakeRotateX/Y/Z + 2 Multiply)/1024", static_cast<double>(kSpriteCount), "sprite", 0.0, [&](size_t) {
+		for (size_t i = 0; i < kSpriteCount; ++i)
+		{
+			const SpriteInput& sprite = sprites[i];
+			Matrix4x4 worldMatrix = myMath.Multiply(myMath.Multiply(myMath.MakeRotateXMatrix(0.0f), myMath.MakeRotateYMatrix(0.0f)), myMath.MakeRotateZMatrix(sprite.rotation));
+			for (int column = 0; column < 3; ++column)
+			{
+				worldMatrix.m[0][column] *= sprite.size.x;
+				worldMatrix.m[1][column] *= sprite.size.y;
+			}
+			worldMatrix.m[3][0] = sprite.position.x;
+			worldMatrix.m[3][1] = sprite.position.y;
+			worldMatrix.m[3][2] = 0.0f;
+			const Matrix4x4 viewMatrix = myMath.MakeIdentity4x4();
+			const Matrix4x4 projectionMatrix = myMath.MakeOrthographicMatrix(0.0f, 0.0f, kClientWidth, kClientHeight, 0.0f, 100.0f);
+			constants[i].WVP = myMath.Multiply(worldMatrix, myMath.Multiply(viewMatrix, projectionMatrix));
+			constants[i].World = worldMatrix;
+		}
+		DoNotOptimize(constants[0]);
+	});
+
+	//4x4のMakeAffineMatrix(SinCosでまとめて作る)に平行投影を掛ける
+	const Matrix4x4 projection4x4 = myMath.MakeOrthographicMatrix(0.0f, 0.0f, kClientWidth, kClientHeight, 0.0f, 100.0f);
+	reporter.Run("4x4 (MakeAffineMatrix + Multiply)/1024", static_cast<double>(kSpriteCount), "sprite", 0.0, [&](size_t) {
+		for (size_t i = 0; i < kSpriteCount; ++i)
+		{
+			const SpriteInput& sprite = sprites[i];
+			const Matrix4x4 worldMatrix = myMath.MakeAffineMatrix(Vector3{ sprite.size.x,sprite.size.y,1.0f }, Vector3{ 0.0f,0.0f,sprite.rotation }, Vector3{ sprite.position.x,sprite.position.y,0.0f });
+			constants[i].WVP = myMath.Multiply(worldMatrix, projection4x4);
+			constants[i].World = worldMatrix;
+		}
+		DoNotOptimize(constants[0]);
+	});
+
+	//今の方法(Sprite::Update): 2次元のAffine変換で合成し、書き込むときだけ4x4に展開する
+	constexpr Matrix3x2 kProjectionMatrix = MathUtility::MakeOrthographicMatrix2D(0.0f, 0.0f, kClientWidth, kClientHeight);
+	reporter.Run("Affine2D (MakeAffineMatrix2D + Multiply)/1024", static_cast<double>(kSpriteCount), "sprite", 0.0, [&](size_t) {
+		for (size_t i = 0; i < kSpriteCount; ++i)
+		{
+			const SpriteInput& sprite = sprites[i];
+			const Matrix3x2 worldMatrix = MathUtility::MakeAffineMatrix2D(sprite.size, sprite.rotation, sprite.position);
+			constants[i].WVP = MathUtility::MakeMatrix4x4(MathUtility::Multiply(worldMatrix, kProjectionMatrix));
+			constants[i].World = MathUtility::MakeMatrix4x4(worldMatrix);
+		}
+		DoNotOptimize(constants[0]);
+	});
+
+	//同じ結果になっているか(Z=0の頂点に掛かるWVPの成分の差の最大)
+	float maxDifference = 0.0f;
+	for (const SpriteInput& sprite : sprites)
+	{
+		const Matrix4x4 worldMatrix = myMath.MakeAffineMatrix(Vector3{ sprite.size.x,sprite.size.y,1.0f }, Vector3{ 0.0f,0.0f,sprite.rotation }, Vector3{ sprite.position.x,sprite.position.y,0.0f });
+		const Matrix4x4 expected = myMath.Multiply(worldMatrix, projection4x4);
+		const Matrix4x4 actual = MathUtility::MakeMatrix4x4(MathUtility::Multiply(MathUtility::MakeAffineMatrix2D(sprite.size, sprite.rotation, sprite.position), kProjectionMatrix));
+		//スプライトの頂点はZ=0なので、3行目(Zに掛かる行)は使わない
+		for (int row : { 0,1,3 })
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				maxDifference = (std::max)(maxDifference, std::abs(expected.m[row][column] - actual.m[row][column]));
+			}
+		}
+	}
+	reporter.AddValue("max |WVP(4x4) - WVP(Affine2D)|", maxDifference);
+
+	return reporter.Finish();
+}
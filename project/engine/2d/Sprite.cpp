@@ -1,9 +1,23 @@
 #include "Sprite.h"
 #include "SpriteBase.h"
+#include "MathUtility.h"
+#include "SpriteGeometry.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+	//スプライト用の平行投影(画面サイズは固定なのでコンパイル時に定数になる)
+	constexpr Matrix3x2 kProjectionMatrix = MathUtility::MakeOrthographicMatrix2D(0.0f, 0.0f, float(WindowsAPI::kClientWidth), float(WindowsAPI::kClientHeight));
+	//TransformGraphのワールド行列(4x4)に掛ける用
+	constexpr Matrix4x4 kProjectionMatrix4x4 = MathUtility::MakeMatrix4x4(kProjectionMatrix);
+}
 
 void Sprite::AdjustTextureSize()
 {
-	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetaData(textureIndex);
+	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetaData(textureHandle);
 
 	textureSize.x = static_cast<float>(metadata.width);
 	textureSize.y = static_cast<float>(metadata.height);
@@ -18,7 +32,7 @@ void Sprite::Initialize(SpriteBase* spriteBase, std::string textureFilePath)
 
 	///=====頂点リソースの作成=====///
 	//★===VertexResourceを作る===
-	vertexBuffer = this->spriteBase->GetDirectXBase()->CreateBufferResource(sizeof(VertexData) * 4);
+	vertexBuffer = this->spriteBase->GetDirectXBase()->CreateBufferResource(sizeof(SpriteVertexData) * 4);
 
 	//★===IndexResourceを作る===
 	indexBuffer = this->spriteBase->GetDirectXBase()->CreateBufferResource(sizeof(uint32_t) * 6);
@@ -27,9 +41,9 @@ void Sprite::Initialize(SpriteBase* spriteBase, std::string textureFilePath)
 	//リソースの先頭のアドレスから使う
 	vertexBufferView.BufferLocation = vertexBuffer->GetGPUVirtualAddress();
 	//使用するリソースのサイズは頂点6つ分のサイズ
-	vertexBufferView.SizeInBytes = sizeof(VertexData) * 4;
+	vertexBufferView.SizeInBytes = sizeof(SpriteVertexData) * 4;
 	//1頂点当たりのサイズ
-	vertexBufferView.StrideInBytes = sizeof(VertexData);
+	vertexBufferView.StrideInBytes = sizeof(SpriteVertexData);
 
 	//★===IndexBufferViewを作成する(値を設定するだけ)===
 	//リソースの先頭のアドレスから使う
@@ -46,17 +60,19 @@ void Sprite::Initialize(SpriteBase* spriteBase, std::string textureFilePath)
 	//★===IndexResourceにデータを書き込むためのアドレスを取得してindexDataに割り当てる===
 	//インデックスリソースにデータを書き込む
 	indexBuffer->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+	//インデックスは変わらないので最初に一度だけ書き込む
+	std::memcpy(indexData, SpriteGeometry::kIndices, sizeof(SpriteGeometry::kIndices));
 
 	///=====マテリアルの作成=====///
 	//マテリアルリソースを作る
-	materialBuffer = this->spriteBase->GetDirectXBase()->CreateBufferResource(sizeof(Vector4));
+	materialBuffer = this->spriteBase->GetDirectXBase()->CreateBufferResource(sizeof(Material));
 	//materialBufferに書き込むためのアドレスを取得して、materialDataにデータを書き込む
 	materialBuffer->Map(0, nullptr, reinterpret_cast<void**>(&materialData));
 
 	//マテリアルデータの初期値を書き込む
 	materialData->color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
 	materialData->enableLighting = false;
-	materialData->uvTransform = myMath->MakeIdentity4x4();
+	materialData->uvTransform = MathUtility::MakeIdentity4x4();
 
 	///=====座標変換行列=====///
 	//座標変換行列リソースを作る
@@ -65,95 +81,75 @@ void Sprite::Initialize(SpriteBase* spriteBase, std::string textureFilePath)
 	transformationMatrixBuffer->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData));
 
 	//単位行列を書き込んでおく
-	transformationMatrixData->WVP = myMath->MakeIdentity4x4();
-	transformationMatrixData->World = myMath->MakeIdentity4x4();
+	transformationMatrixData->WVP = MathUtility::MakeIdentity4x4();
+	transformationMatrixData->World = MathUtility::MakeIdentity4x4();
 
-
-	// 頂点データ回りを一度更新
-	Update();
-
-	//単位行列を書き込んでおく
-	textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
+	//テクスチャのハンドルを取得する(Updateで大きさを使うので先に取る)
+	textureHandle = TextureManager::GetInstance()->GetTextureHandle(textureFilePath);
 
 	//テクスチャサイズをイメージに合わせる
 	AdjustTextureSize();
+
+	// 頂点データ回りを一度更新
+	Update();
 }
 
 void Sprite::Update()
 {
-	//アンカーポイント
-	float left = 0.0f - anchorPoint.x;
-	float right = 1.0f - anchorPoint.x;
-	float top = 0.0f - anchorPoint.y;
-	float bottom = 1.0f - anchorPoint.y;
-
-	//左右反転
-	if (isFlipX_)
-	{
-		left = -left;
-		right = -right;
-	}
+	//Initializeでテクスチャを取得していること
+	assert(textureHandle.IsValid());
 
-	//上下反転
-	if (isFlipY_)
-	{
-		top = -top;
-		bottom = -bottom;
-	}
+	//===頂点の計算===
+	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetaData(textureHandle);
+	SpriteVertexData vertices[4];
+	SpriteGeometry::MakeVertices(anchorPoint, isFlipX_, isFlipY_, textureLeftTop, textureSize, { static_cast<float>(metadata.width),static_cast<float>(metadata.height) }, vertices);
 
-	//===テクスチャ範囲指定===
-	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetaData(textureIndex);
-
-	float tex_left = textureLeftTop.x / metadata.width;
-	float tex_right = (textureLeftTop.x + textureSize.x) / metadata.width;
-	float tex_top = textureLeftTop.y / metadata.height;
-	float tex_bottom = (textureLeftTop.y + textureSize.y) / metadata.height;
-
-	//頂点リソースにデータを書き込む
-	vertexData[0].position = { left,bottom,0.0f,1.0f };//左下
-	vertexData[0].texcoord = { tex_left,tex_bottom };
-	vertexData[0].normal = { 0.0f,0.0f,-1.0f };
-
-	vertexData[1].position = { left,top,0.0f,1.0f };//左上
-	vertexData[1].texcoord = { tex_left,tex_top };
-	vertexData[1].normal = { 0.0f,0.0f,-1.0f };
-	
-	vertexData[2].position = { right,bottom,0.0f,1.0f };//右下
-	vertexData[2].texcoord = { tex_right,tex_bottom };
-	vertexData[2].normal = { 0.0f,0.0f,-1.0f };
-	
-	vertexData[3].position = { right,top,0.0f,1.0f };//右上
-	vertexData[3].texcoord = { tex_right,tex_top };
-	vertexData[3].normal = { 0.0f,0.0f,-1.0f };
+	//頂点リソースにデータをまとめて書き込む
+	std::memcpy(vertexData, vertices, sizeof(vertices));
 
-	//インデックスリソースにデータを書き込む
-	indexData[0] = 0;
-	indexData[1] = 1;
-	indexData[2] = 2;
-	indexData[3] = 1;
-	indexData[4] = 3;
-	indexData[5] = 2;
+	//左上と右下(反転していれば逆になるが、矩形の計算では四隅を見るので問題ない)
+	const Vector2& leftTop = vertices[1].position;
+	const Vector2& rightBottom = vertices[2].position;
 
 	//Transform関数を作る
-	transform.scale = { size.x,size.y,1.0f };
+	//大きさは四角形だけに掛けるので、ノードには入れない(入れると子のスプライトまで拡大される)
+	transform.scale = { 1.0f,1.0f,1.0f };
 	transform.translate = { position.x,position.y,0.0f };
 	transform.rotate = { 0.0f,0.0f,rotation };
 
 	transform = { transform.scale,transform.rotate,transform.translate };
 
-	//TransformからWorldMatrixを作る
-	Matrix4x4 worldMatrix = myMath->MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-	//ViewMatrixを作って単位行列を代入
-	Matrix4x4 viewMatrix = myMath->MakeIdentity4x4();
-	//ProfectionMatrixを作って平行投影行列を書き込む
-	Matrix4x4 projectionMatrix = myMath->MakeOrthographicMatrix(0.0f, 0.0f, float(WindowsAPI::kClientWidth), float(WindowsAPI::kClientHeight), 0.0f, 100.0f);
-	
-	transformationMatrixData->WVP = myMath->Multiply(worldMatrix, myMath->Multiply(viewMatrix, projectionMatrix));
-	transformationMatrixData->World = worldMatrix;
+	if (transformGraph != nullptr)
+	{
+		//変更があった時(自分か親のTransformか大きさが変わった時)だけ行列を書き込む
+		transformGraph->SetLocalTransform(transformNode, transform);
+		uint32_t worldVersion = transformGraph->GetWorldVersion(transformNode);
+		const Matrix4x4 worldMatrix = SpriteGeometry::MakeQuadWorldMatrix(transformGraph->GetWorldMatrix(transformNode), size);
+		//画面上の矩形はアンカーポイントや反転でも変わるので毎フレーム求める
+		UpdateScreenRect({ { { worldMatrix.m[0][0],worldMatrix.m[0][1] },{ worldMatrix.m[1][0],worldMatrix.m[1][1] },{ worldMatrix.m[3][0],worldMatrix.m[3][1] } } }, leftTop, rightBottom);
+		if (worldVersion != writtenWorldVersion || size.x != writtenSize.x || size.y != writtenSize.y)
+		{
+			transformationMatrixData->WVP = MathUtility::Multiply(worldMatrix, kProjectionMatrix4x4);
+			transformationMatrixData->World = worldMatrix;
+			writtenWorldVersion = worldVersion;
+			writtenSize = size;
+		}
+		return;
+	}
+
+	//スプライトはZ軸回転とXY平行移動しか持たないので、2次元のAffine変換で合成して定数バッファへ書き込むときだけ4x4に展開する
+	Matrix3x2 worldMatrix = MathUtility::MakeAffineMatrix2D(size, rotation, position);
+	UpdateScreenRect(worldMatrix, leftTop, rightBottom);
+	//ViewMatrixは単位行列なので、WVPはWorldに平行投影を掛けるだけ
+	transformationMatrixData->WVP = MathUtility::MakeMatrix4x4(MathUtility::Multiply(worldMatrix, kProjectionMatrix));
+	transformationMatrixData->World = MathUtility::MakeMatrix4x4(worldMatrix);
 }
 
 void Sprite::Draw()
 {
+	//Initializeでテクスチャを取得していること
+	assert(textureHandle.IsValid());
+
 	//VertexBufferViewを設定
 	spriteBase->GetDirectXBase()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
 	//IndexBufferViewを設定
@@ -164,8 +160,42 @@ void Sprite::Draw()
 	//マテリアルCBufferの場所を設定
 	spriteBase->GetDirectXBase()->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialBuffer->GetGPUVirtualAddress());
 
-	spriteBase->GetDirectXBase()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex));
+	spriteBase->GetDirectXBase()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureHandle));
 	//描画
 	//spriteBase->GetDxBase()->commandList->DrawInstanced(6, 1, 0, 0);
 	spriteBase->GetDirectXBase()->GetCommandList()->DrawIndexedInstanced(6, 1, 0, 0, 0);
-}
\ No newline at end of file
+}
+
+void Sprite::UpdateScreenRect(const Matrix3x2& worldMatrix, const Vector2& localLeftTop, const Vector2& localRightBottom)
+{
+	const Vector2 corners[4] = {
+		{ localLeftTop.x,localLeftTop.y },
+		{ localRightBottom.x,localLeftTop.y },
+		{ localLeftTop.x,localRightBottom.y },
+		{ localRightBottom.x,localRightBottom.y },
+	};
+
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		Vector2 screen = {
+			corners[i].x * worldMatrix.m[0][0] + corners[i].y * worldMatrix.m[1][0] + worldMatrix.m[2][0],
+			corners[i].x * worldMatrix.m[0][1] + corners[i].y * worldMatrix.m[1][1] + worldMatrix.m[2][1],
+		};
+		if (i == 0)
+		{
+			screenRectMin = screen;
+			screenRectMax = screen;
+			continue;
+		}
+		screenRectMin = { (std::min)(screenRectMin.x,screen.x),(std::min)(screenRectMin.y,screen.y) };
+		screenRectMax = { (std::max)(screenRectMax.x,screen.x),(std::max)(screenRectMax.y,screen.y) };
+	}
+}
+
+void Sprite::AttachTransformGraph(TransformGraph* transformGraph, uint32_t parent)
+{
+	this->transformGraph = transformGraph;
+	transformNode = transformGraph->CreateNode(parent);
+	//次のUpdateで必ず書き込む
+	writtenWorldVersion = transformGraph->GetWorldVersion(transformNode) - 1;
+}
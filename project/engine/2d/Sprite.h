@@ -2,6 +2,8 @@
 #include "MyMath.h"
 #include "DirectXBase.h"
 #include "TextureManager.h"
+#include "TransformGraph.h"
+#include "SpriteGeometry.h"
 #include <d3d12.h>
 #include <wrl.h>
 
@@ -15,6 +17,11 @@ struct Material
 	float padding[3];
 	Matrix4x4 uvTransform;
 };
+//HLSLの定数バッファと同じ配置になっているか確認する
+static_assert(offsetof(Material, color) == 0);
+static_assert(offsetof(Material, enableLighting) == 16);
+static_assert(offsetof(Material, uvTransform) == 32);
+static_assert(sizeof(Material) == 96);
 
 class Sprite
 {
@@ -28,12 +35,19 @@ public://メンバ変数
 	//描画
 	void Draw();
 
+	/// <summary>
+	/// TransformGraphに接続する(以降は親のワールド行列を引き継ぎ、変更があった時だけ行列を書き込む)
+	/// </summary>
+	/// <param name="transformGraph">接続先</param>
+	/// <param name="parent">親のノード番号</param>
+	void AttachTransformGraph(TransformGraph* transformGraph, uint32_t parent = TransformGraph::kNoParent);
+
 	//トランスポイント
 	Transform transform{};
 
 	//getter
 	Microsoft::WRL::ComPtr<ID3D12Resource> GetVertexBuffer() const { return vertexBuffer.Get(); }
-	VertexData* GetVertexData() const { return vertexData; }
+	SpriteVertexData* GetVertexData() const { return vertexData; }
 	Material* GetMaterialData() const { return materialData; }
 
 	const Vector2& GetPosition() const { return position; }
@@ -46,6 +60,10 @@ public://メンバ変数
 	bool GetIsFilpY() const { return isFlipY_; }
 	const Vector2& GetTextureLeftTop() const { return textureLeftTop; }
 	const Vector2& GetTextureSize() const { return textureSize; }
+	uint32_t GetTransformNode() const { return transformNode; }
+	//画面上の矩形(Updateで計算したもの。カリングに使う)
+	const Vector2& GetScreenRectMin() const { return screenRectMin; }
+	const Vector2& GetScreenRectMax() const { return screenRectMax; }
 
 	//setter
 	void SetPosition(const Vector2& position) { this->position = position; }
@@ -61,7 +79,6 @@ public://メンバ変数
 
 private:
 	SpriteBase* spriteBase = nullptr;
-	MyMath* myMath = nullptr;
 
 	//バッファリソース
 	Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer{};
@@ -69,7 +86,7 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12Resource> materialBuffer{};
 	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixBuffer{};
 	//バッファリソース内のデータを指すポインタ
-	VertexData* vertexData = nullptr;
+	SpriteVertexData* vertexData = nullptr;
 	uint32_t* indexData = nullptr;
 	Material* materialData = nullptr;
 	TransformationMatrix* transformationMatrixData = nullptr;
@@ -77,11 +94,20 @@ private:
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
 	D3D12_INDEX_BUFFER_VIEW indexBufferView{};
 
-	D3D12_CPU_DESCRIPTOR_HANDLE textureSrvHandleCPU{};
-	D3D12_GPU_DESCRIPTOR_HANDLE textureSrvHandleGPU{};
+	//テクスチャ
+	TextureHandle textureHandle{};
+
+	//接続しているTransformGraph(nullptrなら毎フレーム行列を作り直す)
+	TransformGraph* transformGraph = nullptr;
+	uint32_t transformNode = TransformGraph::kNoParent;
+	//最後に定数バッファへ書き込んだワールド行列の更新回数
+	uint32_t writtenWorldVersion = 0;
+	//最後に定数バッファへ書き込んだ大きさ(大きさはノードに入れないので別に見る)
+	Vector2 writtenSize = { 0.0f,0.0f };
 
-	//テクスチャ番号
-	uint32_t textureIndex = 0;
+	//画面上の矩形(定数バッファは書き込み専用なので読み返さずにここへ保存しておく)
+	Vector2 screenRectMin = { 0.0f,0.0f };
+	Vector2 screenRectMax = { 0.0f,0.0f };
 
 	//座標
 	Vector2 position = { 600.0f,300.0f };
@@ -110,4 +136,7 @@ private:
 
 	//テクスチャサイズをイメージに合わせる
 	void AdjustTextureSize();
+
+	//頂点の四隅をワールド行列で変換して画面上の矩形を求める
+	void UpdateScreenRect(const Matrix3x2& worldMatrix, const Vector2& localLeftTop, const Vector2& localRightBottom);
 };
\ No newline at end of file
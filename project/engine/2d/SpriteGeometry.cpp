@@ -0,0 +1,55 @@
+#include "SpriteGeometry.h"
+
+// 四角形の頂点を作る
+void SpriteGeometry::MakeVertices(const Vector2& anchorPoint, bool isFlipX, bool isFlipY, const Vector2& textureLeftTop, const Vector2& textureSize, const Vector2& imageSize, SpriteVertexData* outVertices)
+{
+	//アンカーポイント
+	float left = 0.0f - anchorPoint.x;
+	float right = 1.0f - anchorPoint.x;
+	float top = 0.0f - anchorPoint.y;
+	float bottom = 1.0f - anchorPoint.y;
+
+	//左右反転
+	if (isFlipX)
+	{
+		left = -left;
+		right = -right;
+	}
+
+	//上下反転
+	if (isFlipY)
+	{
+		top = -top;
+		bottom = -bottom;
+	}
+
+	//===テクスチャ範囲指定===
+	float tex_left = textureLeftTop.x / imageSize.x;
+	float tex_right = (textureLeftTop.x + textureSize.x) / imageSize.x;
+	float tex_top = textureLeftTop.y / imageSize.y;
+	float tex_bottom = (textureLeftTop.y + textureSize.y) / imageSize.y;
+
+	//テクスチャ座標は半精度で持つ
+	const uint16_t halfLeft = VertexCompression::FloatToHalf(tex_left);
+	const uint16_t halfRight = VertexCompression::FloatToHalf(tex_right);
+	const uint16_t halfTop = VertexCompression::FloatToHalf(tex_top);
+	const uint16_t halfBottom = VertexCompression::FloatToHalf(tex_bottom);
+
+	outVertices[0] = { { left,bottom },{ halfLeft,halfBottom } };//左下
+	outVertices[1] = { { left,top },{ halfLeft,halfTop } };//左上
+	outVertices[2] = { { right,bottom },{ halfRight,halfBottom } };//右下
+	outVertices[3] = { { right,top },{ halfRight,halfTop } };//右上
+}
+
+// ノードのワールド行列に四角形の大きさを掛けた行列を作る
+Matrix4x4 SpriteGeometry::MakeQuadWorldMatrix(const Matrix4x4& nodeWorldMatrix, const Vector2& size)
+{
+	//左から拡縮行列を掛けるのは、X軸とY軸の行をそれぞれ拡大するのと同じ
+	Matrix4x4 result = nodeWorldMatrix;
+	for (int column = 0; column < 4; ++column)
+	{
+		result.m[0][column] *= size.x;
+		result.m[1][column] *= size.y;
+	}
+	return result;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MyMath.h"
+#include "VertexCompression.h"
+
+#include <cstdint>
+
+//スプライトの頂点(12バイト)
+//position: XY座標(DXGI_FORMAT_R32G32_FLOAT。シェーダーではZ=0,W=1で補われる)
+//texcoord: 半精度浮動小数点(DXGI_FORMAT_R16G16_FLOAT)
+struct SpriteVertexData
+{
+	Vector2 position;
+	uint16_t texcoord[2];
+};
+static_assert(sizeof(SpriteVertexData) == 12);
+
+//スプライトの頂点計算(DirectX12に依存しないので単体で計測・確認できる)
+namespace SpriteGeometry
+{
+	//四角形のインデックス(左下,左上,右下 / 左上,右上,右下)
+	constexpr uint32_t kIndices[6] = { 0,1,2,1,3,2 };
+
+	/// <summary>
+	/// 四角形の頂点を作る(頂点の並びは 左下,左上,右下,右上)
+	/// </summary>
+	/// <param name="anchorPoint">アンカーポイント</param>
+	/// <param name="isFlipX">左右反転</param>
+	/// <param name="isFlipY">上下反転</param>
+	/// <param name="textureLeftTop">テクスチャ左上座標(ピクセル)</param>
+	/// <param name="textureSize">テクスチャ切り出しサイズ(ピクセル)</param>
+	/// <param name="imageSize">テクスチャ画像のサイズ(ピクセル)</param>
+	/// <param name="outVertices">書き込み先(4つ)</param>
+	void MakeVertices(const Vector2& anchorPoint, bool isFlipX, bool isFlipY, const Vector2& textureLeftTop, const Vector2& textureSize, const Vector2& imageSize, SpriteVertexData* outVertices);
+
+	/// <summary>
+	/// ノードのワールド行列に四角形の大きさを掛けた行列を作る(大きさはノードに入れないので子には伝わらない)
+	/// </summary>
+	/// <param name="nodeWorldMatrix">TransformGraphのワールド行列</param>
+	/// <param name="size">四角形の大きさ(ピクセル)</param>
+	/// <returns>四角形のワールド行列(Scale(size) * nodeWorldMatrix)</returns>
+	Matrix4x4 MakeQuadWorldMatrix(const Matrix4x4& nodeWorldMatrix, const Vector2& size);
+}
@@ -0,0 +1,326 @@
+#include "CookedMesh.h"
+#include "ModelLoader.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	//変換元ファイルの大きさと更新日時
+	struct SourceStamp
+	{
+		uint64_t size;
+		int64_t timestamp;
+	};
+
+	bool GetSourceStamp(const std::string& sourcePath, SourceStamp* outStamp)
+	{
+		std::error_code error;
+		uintmax_t size = std::filesystem::file_size(sourcePath, error);
+		if (error)
+		{
+			return false;
+		}
+		std::filesystem::file_time_type time = std::filesystem::last_write_time(sourcePath, error);
+		if (error)
+		{
+			return false;
+		}
+		outStamp->size = static_cast<uint64_t>(size);
+		outStamp->timestamp = static_cast<int64_t>(time.time_since_epoch().count());
+		return true;
+	}
+
+	uint64_t AlignUp(uint64_t value)
+	{
+		return (value + CookedMesh::kAlignment - 1) & ~(CookedMesh::kAlignment - 1);
+	}
+
+	//ブロックを境界に揃えて追加し、その位置を返す
+	uint64_t AppendBlock(std::vector<uint8_t>& buffer, const void* data, size_t size)
+	{
+		uint64_t offset = AlignUp(buffer.size());
+		buffer.resize(static_cast<size_t>(offset) + size);
+		if (size != 0)
+		{
+			std::memcpy(buffer.data() + offset, data, size);
+		}
+		return offset;
+	}
+
+	//読み込んだときに無かったファイルの大きさ
+	constexpr uint64_t kMissingSize = UINT64_MAX;
+
+	//依存するファイルの大きさと更新日時(無ければkMissingSize)
+	SourceStamp GetDependencyStamp(const std::string& path)
+	{
+		SourceStamp stamp{};
+		if (!GetSourceStamp(path, &stamp))
+		{
+			stamp = { kMissingSize, 0 };
+		}
+		return stamp;
+	}
+
+	//[offset, offset + size)がファイルに収まっているか
+	bool IsInside(const MappedFile& file, uint64_t offset, uint64_t size)
+	{
+		return offset <= file.GetSize() && size <= file.GetSize() - offset;
+	}
+}
+
+std::string CookedMesh::GetCookedPath(const std::string& sourcePath)
+{
+	return sourcePath + kExtension;
+}
+
+bool CookedMesh::Cook(const ModelData& modelData, const std::string& sourcePath, const std::string& cookedPath)
+{
+	SourceStamp stamp{};
+	if (!GetSourceStamp(sourcePath, &stamp))
+	{
+		return false;
+	}
+
+	//Indexは頂点数に合わせて16bitか32bitで持つ
+	const uint32_t indexStride = ModelLoader::GetIndexStride(modelData);
+	std::vector<uint8_t> indexBlob(ModelLoader::GetIndexBufferSize(modelData));
+	ModelLoader::WriteIndices(modelData, indexBlob.data());
+
+	//マテリアルごとの描画範囲(無ければ全体を1つの範囲にする)
+	std::vector<SubmeshEntry> submeshes;
+	for (const SubmeshData& submesh : modelData.submeshes)
+	{
+		submeshes.push_back({ submesh.indexOffset, submesh.indexCount, submesh.materialIndex, 0 });
+	}
+	if (submeshes.empty())
+	{
+		submeshes.push_back({ 0, static_cast<uint32_t>(modelData.indices.size()), 0, 0 });
+	}
+	std::vector<LodEntry> lods;
+	for (const LodData& lod : modelData.lods)
+	{
+		lods.push_back({ lod.submeshOffset, lod.submeshCount, lod.error, 0 });
+	}
+	//mtlはobjのディレクトリからの相対パスで記録する(ディレクトリごと移しても使えるように)
+	const std::filesystem::path sourceDirectory = std::filesystem::path(sourcePath).parent_path();
+	std::vector<DependencyEntry> dependencies(modelData.materialLibraryPaths.size());
+	std::vector<std::string> dependencyPaths;
+	for (size_t i = 0; i < dependencies.size(); ++i)
+	{
+		const std::string& path = modelData.materialLibraryPaths[i];
+		const SourceStamp dependencyStamp = GetDependencyStamp(path);
+		dependencies[i].size = dependencyStamp.size;
+		dependencies[i].timestamp = dependencyStamp.timestamp;
+		std::filesystem::path relativePath = std::filesystem::path(path).lexically_relative(sourceDirectory);
+		dependencyPaths.push_back(relativePath.empty() ? path : relativePath.generic_string());
+	}
+	std::vector<MaterialEntry> materials(modelData.materials.size());
+
+	FileHeader header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.sourceSize = stamp.size;
+	header.sourceTimestamp = stamp.timestamp;
+	header.vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+	header.vertexStride = static_cast<uint32_t>(sizeof(VertexData));
+	header.indexCount = static_cast<uint32_t>(modelData.indices.size());
+	header.indexStride = indexStride;
+	header.submeshCount = static_cast<uint32_t>(submeshes.size());
+	header.materialCount = static_cast<uint32_t>(materials.size());
+	header.lodCount = static_cast<uint32_t>(lods.size());
+	header.dependencyCount = static_cast<uint32_t>(dependencies.size());
+
+	std::vector<uint8_t> buffer(sizeof(FileHeader));
+	header.vertexOffset = AppendBlock(buffer, modelData.vertices.data(), modelData.vertices.size() * sizeof(VertexData));
+	header.indexOffset = AppendBlock(buffer, indexBlob.data(), indexBlob.size());
+	header.submeshOffset = AppendBlock(buffer, submeshes.data(), submeshes.size() * sizeof(SubmeshEntry));
+	header.lodOffset = AppendBlock(buffer, lods.data(), lods.size() * sizeof(LodEntry));
+	header.dependencyOffset = AppendBlock(buffer, dependencies.data(), dependencies.size() * sizeof(DependencyEntry));
+	header.materialOffset = AlignUp(buffer.size());
+	buffer.resize(static_cast<size_t>(header.materialOffset) + materials.size() * sizeof(MaterialEntry));
+	//文字列はマテリアルの後ろにまとめて置く
+	for (size_t i = 0; i < materials.size(); ++i)
+	{
+		const MaterialData& materialData = modelData.materials[i];
+		materials[i].nameOffset = buffer.size();
+		materials[i].nameLength = static_cast<uint32_t>(materialData.name.size());
+		buffer.insert(buffer.end(), materialData.name.begin(), materialData.name.end());
+		materials[i].textureFilePathOffset = buffer.size();
+		materials[i].textureFilePathLength = static_cast<uint32_t>(materialData.textureFilePath.size());
+		buffer.insert(buffer.end(), materialData.textureFilePath.begin(), materialData.textureFilePath.end());
+	}
+	for (size_t i = 0; i < dependencies.size(); ++i)
+	{
+		dependencies[i].pathOffset = buffer.size();
+		dependencies[i].pathLength = static_cast<uint32_t>(dependencyPaths[i].size());
+		buffer.insert(buffer.end(), dependencyPaths[i].begin(), dependencyPaths[i].end());
+	}
+	if (!materials.empty())
+	{
+		std::memcpy(buffer.data() + header.materialOffset, materials.data(), materials.size() * sizeof(MaterialEntry));
+	}
+	if (!dependencies.empty())
+	{
+		std::memcpy(buffer.data() + header.dependencyOffset, dependencies.data(), dependencies.size() * sizeof(DependencyEntry));
+	}
+	std::memcpy(buffer.data(), &header, sizeof(header));
+
+	std::ofstream file(cookedPath, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	return file.good();
+}
+
+bool CookedMesh::Map(const MappedFile& file, const std::string& sourcePath, MeshView* outView)
+{
+	if (!file.IsOpen() || file.GetSize() < sizeof(FileHeader))
+	{
+		return false;
+	}
+
+	FileHeader header{};
+	std::memcpy(&header, file.GetData(), sizeof(header));
+	if (header.magic != kMagic || header.version != kVersion || header.vertexStride != sizeof(VertexData))
+	{
+		return false;
+	}
+	if (header.indexStride != sizeof(uint16_t) && header.indexStride != sizeof(uint32_t))
+	{
+		return false;
+	}
+
+	//変換元が更新されていたら古いとみなす(変換元が無い場合は変換済みファイルだけで使う)
+	SourceStamp stamp{};
+	const bool hasSource = GetSourceStamp(sourcePath, &stamp);
+	if (hasSource && (stamp.size != header.sourceSize || stamp.timestamp != header.sourceTimestamp))
+	{
+		return false;
+	}
+
+	//各ブロックがファイルに収まっていて、境界に揃っているか
+	const uint64_t offsets[] = { header.vertexOffset, header.indexOffset, header.submeshOffset, header.materialOffset, header.lodOffset, header.dependencyOffset };
+	const uint64_t sizes[] = {
+		uint64_t(header.vertexCount) * sizeof(VertexData),
+		uint64_t(header.indexCount) * header.indexStride,
+		uint64_t(header.submeshCount) * sizeof(SubmeshEntry),
+		uint64_t(header.materialCount) * sizeof(MaterialEntry),
+		uint64_t(header.lodCount) * sizeof(LodEntry),
+		uint64_t(header.dependencyCount) * sizeof(DependencyEntry),
+	};
+	for (size_t i = 0; i < std::size(offsets); ++i)
+	{
+		if (offsets[i] % kAlignment != 0 || !IsInside(file, offsets[i], sizes[i]))
+		{
+			return false;
+		}
+	}
+
+	const uint8_t* data = file.GetData();
+	MeshView view{};
+	view.vertices = { reinterpret_cast<const VertexData*>(data + header.vertexOffset), header.vertexCount };
+	view.indices = data + header.indexOffset;
+	view.indexCount = header.indexCount;
+	view.indexStride = header.indexStride;
+	view.submeshes = { reinterpret_cast<const SubmeshEntry*>(data + header.submeshOffset), header.submeshCount };
+	view.materials = { reinterpret_cast<const MaterialEntry*>(data + header.materialOffset), header.materialCount };
+	view.lods = { reinterpret_cast<const LodEntry*>(data + header.lodOffset), header.lodCount };
+	view.fileData = data;
+
+	for (const SubmeshEntry& submesh : view.submeshes)
+	{
+		if (uint64_t(submesh.indexOffset) + submesh.indexCount > header.indexCount || (header.materialCount != 0 && submesh.materialIndex >= header.materialCount))
+		{
+			return false;
+		}
+	}
+	for (const LodEntry& lod : view.lods)
+	{
+		if (uint64_t(lod.submeshOffset) + lod.submeshCount > header.submeshCount)
+		{
+			return false;
+		}
+	}
+	for (const MaterialEntry& material : view.materials)
+	{
+		if (!IsInside(file, material.nameOffset, material.nameLength) || !IsInside(file, material.textureFilePathOffset, material.textureFilePathLength))
+		{
+			return false;
+		}
+	}
+
+	//objが読み込んだmtlが更新・追加・削除されていても古いとみなす(objがあるときだけ確認する)
+	if (hasSource)
+	{
+		const std::filesystem::path sourceDirectory = std::filesystem::path(sourcePath).parent_path();
+		const std::span<const DependencyEntry> dependencies = { reinterpret_cast<const DependencyEntry*>(data + header.dependencyOffset), header.dependencyCount };
+		for (const DependencyEntry& dependency : dependencies)
+		{
+			if (!IsInside(file, dependency.pathOffset, dependency.pathLength))
+			{
+				return false;
+			}
+			const std::string path(reinterpret_cast<const char*>(data + dependency.pathOffset), dependency.pathLength);
+			const SourceStamp dependencyStamp = GetDependencyStamp((sourceDirectory / path).generic_string());
+			if (dependencyStamp.size != dependency.size || dependencyStamp.timestamp != dependency.timestamp)
+			{
+				return false;
+			}
+		}
+	}
+
+	*outView = view;
+	return true;
+}
+
+MaterialData CookedMesh::GetMaterialData(const MeshView& view, const MaterialEntry& material)
+{
+	MaterialData materialData;
+	materialData.name.assign(reinterpret_cast<const char*>(view.fileData + material.nameOffset), material.nameLength);
+	materialData.textureFilePath.assign(reinterpret_cast<const char*>(view.fileData + material.textureFilePathOffset), material.textureFilePathLength);
+	return materialData;
+}
+
+ModelData CookedMesh::CopyDrawRanges(const MeshView& view)
+{
+	ModelData modelData;
+	for (const SubmeshEntry& submesh : view.submeshes)
+	{
+		modelData.submeshes.push_back({ submesh.indexOffset, submesh.indexCount, submesh.materialIndex });
+	}
+	for (const MaterialEntry& material : view.materials)
+	{
+		modelData.materials.push_back(GetMaterialData(view, material));
+	}
+	for (const LodEntry& lod : view.lods)
+	{
+		modelData.lods.push_back({ lod.submeshOffset, lod.submeshCount, lod.error });
+	}
+	return modelData;
+}
+
+ModelData CookedMesh::ToModelData(const MeshView& view)
+{
+	ModelData modelData = CopyDrawRanges(view);
+	modelData.vertices.assign(view.vertices.begin(), view.vertices.end());
+
+	modelData.indices.resize(view.indexCount);
+	if (view.indexStride == sizeof(uint32_t))
+	{
+		std::memcpy(modelData.indices.data(), view.indices, view.indexCount * sizeof(uint32_t));
+	}
+	else
+	{
+		const uint16_t* indices16 = static_cast<const uint16_t*>(view.indices);
+		for (uint32_t i = 0; i < view.indexCount; ++i)
+		{
+			modelData.indices[i] = indices16[i];
+		}
+	}
+	return modelData;
+}
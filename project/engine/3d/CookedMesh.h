@@ -0,0 +1,135 @@
+#pragma once
+
+#include "MyMath.h"
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+//変換済みのバイナリメッシュ(テキストのobjを毎回解析しないためのキャッシュ)
+//ファイルの並び: FileHeader → 頂点 → Index → SubmeshEntry[] → LodEntry[] → DependencyEntry[] → MaterialEntry[] → 文字列
+//各ブロックはkAlignmentバイト境界から始まるので、マップしたメモリをそのままアップロードバッファへコピーできる
+namespace CookedMesh
+{
+	//ファイルの識別子と版(中身の並びを変えたら版を上げる)
+	constexpr uint32_t kMagic = 0x534D4547;//"GEMS"
+	//2: 三角形と頂点の並びを最適化したもの
+	//3: マテリアルごとの描画範囲とマテリアル名
+	//4: 詳細度(LOD)ごとの描画範囲
+	//5: mtlファイルの大きさと更新日時、頂点の法線
+	constexpr uint32_t kVersion = 5;
+	//各ブロックの境界
+	constexpr uint64_t kAlignment = 16;
+	//変換済みファイルの拡張子(元ファイル名の後ろに付ける)
+	constexpr const char* kExtension = ".mesh";
+
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		//変換元ファイルの大きさと更新日時(変わっていたら作り直す)
+		uint64_t sourceSize;
+		int64_t sourceTimestamp;
+		uint32_t vertexCount;
+		uint32_t vertexStride;
+		uint32_t indexCount;
+		uint32_t indexStride;
+		uint32_t submeshCount;
+		uint32_t materialCount;
+		uint32_t lodCount;
+		uint32_t dependencyCount;
+		//各ブロックのファイル先頭からの位置
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+		uint64_t submeshOffset;
+		uint64_t materialOffset;
+		uint64_t lodOffset;
+		uint64_t dependencyOffset;
+	};
+
+	//ファイルの並びが変わっていないか確認する
+	static_assert(sizeof(FileHeader) == 104);
+
+	//Indexバッファ内の描画単位
+	struct SubmeshEntry
+	{
+		uint32_t indexOffset;
+		uint32_t indexCount;
+		uint32_t materialIndex;
+		uint32_t padding;
+	};
+
+	//詳細度1段分(SubmeshEntryの範囲)
+	struct LodEntry
+	{
+		uint32_t submeshOffset;
+		uint32_t submeshCount;
+		float error;
+		uint32_t padding;
+	};
+
+	//変換元が読み込んだファイル(mtl)の大きさと更新日時(パスはobjのディレクトリからの相対パスで、ファイル先頭からの位置と長さ)
+	struct DependencyEntry
+	{
+		uint64_t size;
+		int64_t timestamp;
+		uint64_t pathOffset;
+		uint32_t pathLength;
+		uint32_t padding;
+	};
+
+	//マテリアル(文字列はファイル先頭からの位置と長さ)
+	struct MaterialEntry
+	{
+		uint64_t nameOffset;
+		uint64_t textureFilePathOffset;
+		uint32_t nameLength;
+		uint32_t textureFilePathLength;
+	};
+
+	//マップしたファイルの中身を指すだけのもの(コピーしない)
+	struct MeshView
+	{
+		std::span<const VertexData> vertices;
+		//indexStrideバイトずつ並んだIndex
+		const void* indices;
+		uint32_t indexCount;
+		uint32_t indexStride;
+		std::span<const SubmeshEntry> submeshes;
+		std::span<const LodEntry> lods;
+		std::span<const MaterialEntry> materials;
+		//マテリアルの文字列を引くための先頭アドレス
+		const uint8_t* fileData;
+	};
+
+	//変換済みファイルのパス
+	std::string GetCookedPath(const std::string& sourcePath);
+
+	/// <summary>
+	/// ModelDataを変換済みファイルに書き出す
+	/// </summary>
+	/// <param name="modelData">書き出すモデル(materialLibraryPathsのmtlファイルも大きさと更新日時を記録する)</param>
+	/// <param name="sourcePath">変換元のobjファイル(大きさと更新日時を記録する)</param>
+	/// <param name="cookedPath">書き出し先</param>
+	/// <returns>書き出せたか</returns>
+	bool Cook(const ModelData& modelData, const std::string& sourcePath, const std::string& cookedPath);
+
+	/// <summary>
+	/// マップしたファイルを確認して中身を指すMeshViewを作る
+	/// </summary>
+	/// <param name="file">マップ済みの変換済みファイル</param>
+	/// <param name="sourcePath">変換元のobjファイル(objか、objが読み込んだmtlの記録と違えば古いとみなす)</param>
+	/// <param name="outView">書き込み先</param>
+	/// <returns>壊れている、版が違う、古い場合はfalse</returns>
+	bool Map(const MappedFile& file, const std::string& sourcePath, MeshView* outView);
+
+	//マテリアルを文字列に戻す
+	MaterialData GetMaterialData(const MeshView& view, const MaterialEntry& material);
+
+	//描画範囲とマテリアルだけをModelDataにコピーする(頂点とIndexは空のまま)
+	ModelData CopyDrawRanges(const MeshView& view);
+
+	//MeshViewをModelDataにコピーする(16bitのIndexは32bitに広げる)
+	ModelData ToModelData(const MeshView& view);
+}
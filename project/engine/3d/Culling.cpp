@@ -0,0 +1,277 @@
+#include "Culling.h"
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+//SIMD命令セットはコンパイル時に選択する
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// 正規化した平面
+	Vector4 NormalizePlane(float a, float b, float c, float d)
+	{
+		float length = std::sqrt(a * a + b * b + c * c);
+		float recpLength = length != 0.0f ? 1.0f / length : 0.0f;
+		return { a * recpLength, b * recpLength, c * recpLength, d * recpLength };
+	}
+
+#ifdef CULLING_USE_SSE2
+	// 判定結果のマスクから見えている番号を書き込む
+	inline void AppendVisible(int mask, uint32_t baseIndex, std::vector<uint32_t>& outVisibleIndices)
+	{
+		while (mask != 0)
+		{
+			int bit = 0;
+			while ((mask & (1 << bit)) == 0)
+			{
+				++bit;
+			}
+			outVisibleIndices.push_back(baseIndex + bit);
+			mask &= mask - 1;
+		}
+	}
+#endif
+}
+
+// View * Projection行列から視錐台を作る
+Frustum Culling::MakeFrustum(const Matrix4x4& viewProjection)
+{
+	//行ベクトルに掛けるので、クリップ座標の各成分は行列の列との内積になる
+	const Matrix4x4& m = viewProjection;
+	auto column = [&m](int j, int i) { return m.m[i][j]; };
+
+	Frustum frustum{};
+	//左 (w + x >= 0)
+	frustum.planes[0] = NormalizePlane(column(3, 0) + column(0, 0), column(3, 1) + column(0, 1), column(3, 2) + column(0, 2), column(3, 3) + column(0, 3));
+	//右 (w - x >= 0)
+	frustum.planes[1] = NormalizePlane(column(3, 0) - column(0, 0), column(3, 1) - column(0, 1), column(3, 2) - column(0, 2), column(3, 3) - column(0, 3));
+	//下 (w + y >= 0)
+	frustum.planes[2] = NormalizePlane(column(3, 0) + column(1, 0), column(3, 1) + column(1, 1), column(3, 2) + column(1, 2), column(3, 3) + column(1, 3));
+	//上 (w - y >= 0)
+	frustum.planes[3] = NormalizePlane(column(3, 0) - column(1, 0), column(3, 1) - column(1, 1), column(3, 2) - column(1, 2), column(3, 3) - column(1, 3));
+	//近 (z >= 0)
+	frustum.planes[4] = NormalizePlane(column(2, 0), column(2, 1), column(2, 2), column(2, 3));
+	//遠 (w - z >= 0)
+	frustum.planes[5] = NormalizePlane(column(3, 0) - column(2, 0), column(3, 1) - column(2, 1), column(3, 2) - column(2, 2), column(3, 3) - column(2, 3));
+	return frustum;
+}
+
+// スクリーン矩形と表示領域の重なり判定
+uint32_t Culling::CullScreenRects(const ScreenRectBounds& bounds, float left, float top, float right, float bottom, std::vector<uint32_t>& outVisibleIndices)
+{
+	outVisibleIndices.clear();
+	const uint32_t count = static_cast<uint32_t>(bounds.Size());
+	uint32_t i = 0;
+
+#ifdef CULLING_USE_SSE2
+	const __m128 leftV = _mm_set1_ps(left);
+	const __m128 topV = _mm_set1_ps(top);
+	const __m128 rightV = _mm_set1_ps(right);
+	const __m128 bottomV = _mm_set1_ps(bottom);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 visible = _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxX[i]), leftV);
+		visible = _mm_and_ps(visible, _mm_cmple_ps(_mm_loadu_ps(&bounds.minX[i]), rightV));
+		visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_loadu_ps(&bounds.maxY[i]), topV));
+		visible = _mm_and_ps(visible, _mm_cmple_ps(_mm_loadu_ps(&bounds.minY[i]), bottomV));
+		AppendVisible(_mm_movemask_ps(visible), i, outVisibleIndices);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		if (bounds.maxX[i] >= left && bounds.minX[i] <= right && bounds.maxY[i] >= top && bounds.minY[i] <= bottom)
+		{
+			outVisibleIndices.push_back(i);
+		}
+	}
+	return static_cast<uint32_t>(outVisibleIndices.size());
+}
+
+// バウンディングスフィアと視錐台の判定
+uint32_t Culling::CullSpheres(const SphereBounds& bounds, const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices)
+{
+	outVisibleIndices.clear();
+	const uint32_t count = static_cast<uint32_t>(bounds.Size());
+	uint32_t i = 0;
+
+#ifdef CULLING_USE_SSE2
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 centerX = _mm_loadu_ps(&bounds.centerX[i]);
+		const __m128 centerY = _mm_loadu_ps(&bounds.centerY[i]);
+		const __m128 centerZ = _mm_loadu_ps(&bounds.centerZ[i]);
+		const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&bounds.radius[i]));
+
+		//全ての平面について、中心までの距離が -半径 以上なら見えている
+		__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Vector4& plane : frustum.planes)
+		{
+			__m128 distance = _mm_mul_ps(centerX, _mm_set1_ps(plane.x));
+			distance = _mm_add_ps(distance, _mm_mul_ps(centerY, _mm_set1_ps(plane.y)));
+			distance = _mm_add_ps(distance, _mm_mul_ps(centerZ, _mm_set1_ps(plane.z)));
+			distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+			visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negativeRadius));
+		}
+		AppendVisible(_mm_movemask_ps(visible), i, outVisibleIndices);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		bool visible = true;
+		for (const Vector4& plane : frustum.planes)
+		{
+			float distance = bounds.centerX[i] * plane.x + bounds.centerY[i] * plane.y + bounds.centerZ[i] * plane.z + plane.w;
+			visible = visible && distance >= -bounds.radius[i];
+		}
+		if (visible)
+		{
+			outVisibleIndices.push_back(i);
+		}
+	}
+	return static_cast<uint32_t>(outVisibleIndices.size());
+}
+
+// AABBと視錐台の判定
+uint32_t Culling::CullAABBs(const AABBBounds& bounds, const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices)
+{
+	outVisibleIndices.clear();
+	const uint32_t count = static_cast<uint32_t>(bounds.Size());
+
+	//平面ごとに、法線方向に最も進んだ頂点(min/maxのどちらを使うか)を先に決めておく
+	const std::vector<float>* positiveX[6];
+	const std::vector<float>* positiveY[6];
+	const std::vector<float>* positiveZ[6];
+	for (int p = 0; p < 6; ++p)
+	{
+		positiveX[p] = frustum.planes[p].x >= 0.0f ? &bounds.maxX : &bounds.minX;
+		positiveY[p] = frustum.planes[p].y >= 0.0f ? &bounds.maxY : &bounds.minY;
+		positiveZ[p] = frustum.planes[p].z >= 0.0f ? &bounds.maxZ : &bounds.minZ;
+	}
+
+	uint32_t i = 0;
+#ifdef CULLING_USE_SSE2
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < 6; ++p)
+		{
+			const Vector4& plane = frustum.planes[p];
+			__m128 distance = _mm_mul_ps(_mm_loadu_ps(&(*positiveX[p])[i]), _mm_set1_ps(plane.x));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(&(*positiveY[p])[i]), _mm_set1_ps(plane.y)));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(&(*positiveZ[p])[i]), _mm_set1_ps(plane.z)));
+			distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+			visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+		}
+		AppendVisible(_mm_movemask_ps(visible), i, outVisibleIndices);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		bool visible = true;
+		for (int p = 0; p < 6; ++p)
+		{
+			const Vector4& plane = frustum.planes[p];
+			float distance = (*positiveX[p])[i] * plane.x + (*positiveY[p])[i] * plane.y + (*positiveZ[p])[i] * plane.z + plane.w;
+			visible = visible && distance >= 0.0f;
+		}
+		if (visible)
+		{
+			outVisibleIndices.push_back(i);
+		}
+	}
+	return static_cast<uint32_t>(outVisibleIndices.size());
+}
+
+// メッシュレットを判定して、見えているものだけのIndexを詰める
+uint32_t Culling::CullMeshlets(const MeshletData& meshletData, const Frustum& frustum, const Vector3& cameraPosition, bool enableConeCulling, MeshletCullResult& outResult)
+{
+	outResult.indices.clear();
+	outResult.submeshes.clear();
+
+	//視錐台の判定はまとめて行う
+	CullSpheres(meshletData.sphereBounds, frustum, outResult.visibleMeshlets);
+
+	uint32_t visibleCount = 0;
+	uint32_t lastGroupIndex = UINT32_MAX;
+	for (uint32_t meshletIndex : outResult.visibleMeshlets)
+	{
+		if (enableConeCulling)
+		{
+			//カメラから中心への向きが法線コーンの内側なら、球のどこから見ても全ての三角形が裏を向いている
+			const SphereBounds& spheres = meshletData.sphereBounds;
+			const ConeBounds& cones = meshletData.coneBounds;
+			float dx = spheres.centerX[meshletIndex] - cameraPosition.x;
+			float dy = spheres.centerY[meshletIndex] - cameraPosition.y;
+			float dz = spheres.centerZ[meshletIndex] - cameraPosition.z;
+			float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+			float axisDot = dx * cones.axisX[meshletIndex] + dy * cones.axisY[meshletIndex] + dz * cones.axisZ[meshletIndex];
+			if (axisDot >= cones.cutoff[meshletIndex] * distance + spheres.radius[meshletIndex])
+			{
+				continue;
+			}
+		}
+		outResult.visibleMeshlets[visibleCount++] = meshletIndex;
+
+		//メッシュレットはグループの順に並んでいるので、グループが変わったら描画範囲を分ける
+		const Meshlet& meshlet = meshletData.meshlets[meshletIndex];
+		if (meshlet.groupIndex != lastGroupIndex)
+		{
+			outResult.submeshes.push_back({ static_cast<uint32_t>(outResult.indices.size()), 0, meshletData.groups[meshlet.groupIndex].materialIndex });
+			lastGroupIndex = meshlet.groupIndex;
+		}
+		auto meshletBegin = meshletData.indices.begin() + meshlet.indexOffset;
+		outResult.indices.insert(outResult.indices.end(), meshletBegin, meshletBegin + meshlet.indexCount);
+		outResult.submeshes.back().indexCount += meshlet.indexCount;
+	}
+	outResult.visibleMeshlets.resize(visibleCount);
+	return visibleCount;
+}
+
+// モデルのAABB
+AABB Culling::ComputeAABB(std::span<const VertexData> vertices)
+{
+	if (vertices.empty())
+	{
+		return { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+	}
+
+	AABB aabb = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+	for (const VertexData& vertex : vertices)
+	{
+		aabb.min.x = (std::min)(aabb.min.x, vertex.position.x);
+		aabb.min.y = (std::min)(aabb.min.y, vertex.position.y);
+		aabb.min.z = (std::min)(aabb.min.z, vertex.position.z);
+		aabb.max.x = (std::max)(aabb.max.x, vertex.position.x);
+		aabb.max.y = (std::max)(aabb.max.y, vertex.position.y);
+		aabb.max.z = (std::max)(aabb.max.z, vertex.position.z);
+	}
+	return aabb;
+}
+
+// モデルのバウンディングスフィア
+Sphere Culling::ComputeBoundingSphere(std::span<const VertexData> vertices)
+{
+	AABB aabb = ComputeAABB(vertices);
+	Sphere sphere{};
+	sphere.center = { (aabb.min.x + aabb.max.x) * 0.5f, (aabb.min.y + aabb.max.y) * 0.5f, (aabb.min.z + aabb.max.z) * 0.5f };
+
+	float maxDistanceSq = 0.0f;
+	for (const VertexData& vertex : vertices)
+	{
+		float dx = vertex.position.x - sphere.center.x;
+		float dy = vertex.position.y - sphere.center.y;
+		float dz = vertex.position.z - sphere.center.z;
+		maxDistanceSq = (std::max)(maxDistanceSq, dx * dx + dy * dy + dz * dz);
+	}
+	sphere.radius = std::sqrt(maxDistanceSq);
+	return sphere;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "MyMath.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//バウンディングスフィア
+struct Sphere {
+	Vector3 center;
+	float radius;
+};
+
+//軸平行境界ボックス
+struct AABB {
+	Vector3 min;
+	Vector3 max;
+};
+
+//スクリーン矩形の配列(スプライト用、SoA)
+struct ScreenRectBounds {
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+
+	void Add(const Vector2& min, const Vector2& max) {
+		minX.push_back(min.x);
+		minY.push_back(min.y);
+		maxX.push_back(max.x);
+		maxY.push_back(max.y);
+	}
+	void Clear() { minX.clear(); minY.clear(); maxX.clear(); maxY.clear(); }
+	size_t Size() const { return minX.size(); }
+};
+
+//バウンディングスフィアの配列(SoA)
+struct SphereBounds {
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radius;
+
+	void Add(const Sphere& sphere) {
+		centerX.push_back(sphere.center.x);
+		centerY.push_back(sphere.center.y);
+		centerZ.push_back(sphere.center.z);
+		radius.push_back(sphere.radius);
+	}
+	void Clear() { centerX.clear(); centerY.clear(); centerZ.clear(); radius.clear(); }
+	size_t Size() const { return radius.size(); }
+};
+
+//AABBの配列(SoA)
+struct AABBBounds {
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> minZ;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+	std::vector<float> maxZ;
+
+	void Add(const AABB& aabb) {
+		minX.push_back(aabb.min.x);
+		minY.push_back(aabb.min.y);
+		minZ.push_back(aabb.min.z);
+		maxX.push_back(aabb.max.x);
+		maxY.push_back(aabb.max.y);
+		maxZ.push_back(aabb.max.z);
+	}
+	void Clear() { minX.clear(); minY.clear(); minZ.clear(); maxX.clear(); maxY.clear(); maxZ.clear(); }
+	size_t Size() const { return minX.size(); }
+};
+
+//法線コーン(三角形の法線がaxisの周りに収まっている範囲。cutoffは裏向き判定に使う値で、1なら判定しない)
+struct Cone {
+	Vector3 axis;
+	float cutoff;
+};
+
+//法線コーンの配列(SoA)
+struct ConeBounds {
+	std::vector<float> axisX;
+	std::vector<float> axisY;
+	std::vector<float> axisZ;
+	std::vector<float> cutoff;
+
+	void Add(const Cone& cone) {
+		axisX.push_back(cone.axis.x);
+		axisY.push_back(cone.axis.y);
+		axisZ.push_back(cone.axis.z);
+		cutoff.push_back(cone.cutoff);
+	}
+	void Clear() { axisX.clear(); axisY.clear(); axisZ.clear(); cutoff.clear(); }
+	size_t Size() const { return cutoff.size(); }
+};
+
+struct MeshletData;
+struct MeshletCullResult;
+
+//視錐台(各平面は ax + by + cz + d >= 0 の側が内側。(a,b,c)は正規化済み)
+struct Frustum {
+	Vector4 planes[6];
+};
+
+//まとめてカリングを行う(SSE2が使える場合は4個ずつ判定する)
+//結果は見えているものの番号を詰めてoutVisibleIndicesに書き込み、その数を返す
+namespace Culling
+{
+	// View * Projection行列から視錐台を作る(MakeOrthographicMatrix / MakePerspectiveFovMatrixのどちらでもよい)
+	Frustum MakeFrustum(const Matrix4x4& viewProjection);
+
+	// スクリーン矩形と表示領域(left, top, right, bottom)の重なり判定
+	uint32_t CullScreenRects(const ScreenRectBounds& bounds, float left, float top, float right, float bottom, std::vector<uint32_t>& outVisibleIndices);
+
+	// バウンディングスフィアと視錐台の判定
+	uint32_t CullSpheres(const SphereBounds& bounds, const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices);
+
+	// AABBと視錐台の判定
+	uint32_t CullAABBs(const AABBBounds& bounds, const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices);
+
+	/// <summary>
+	/// メッシュレットを視錐台と法線コーンで判定し、見えているものだけのIndexを詰める
+	/// </summary>
+	/// <param name="meshletData">MeshletBuilder::Buildで作ったもの</param>
+	/// <param name="frustum">モデルのローカル座標での視錐台(World * View * Projectionから作る)</param>
+	/// <param name="cameraPosition">モデルのローカル座標でのカメラの位置</param>
+	/// <param name="enableConeCulling">裏向きのメッシュレットを除くか(裏面カリングしないパイプラインではfalse)</param>
+	/// <param name="outResult">書き込み先(毎フレーム使い回せば確保し直さない)</param>
+	/// <returns>見えているメッシュレットの数</returns>
+	uint32_t CullMeshlets(const MeshletData& meshletData, const Frustum& frustum, const Vector3& cameraPosition, bool enableConeCulling, MeshletCullResult& outResult);
+
+	// モデルのAABB(ローカル座標)
+	AABB ComputeAABB(std::span<const VertexData> vertices);
+
+	// モデルのバウンディングスフィア(ローカル座標。AABBの中心を中心とする)
+	Sphere ComputeBoundingSphere(std::span<const VertexData> vertices);
+}
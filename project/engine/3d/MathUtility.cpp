@@ -0,0 +1,58 @@
+#include "MathUtility.h"
+
+//MathUtilityのコンパイル時テスト
+namespace
+{
+	constexpr bool Equal(const Matrix4x4& m1, const Matrix4x4& m2)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				if (m1.m[row][column] != m2.m[row][column])
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	constexpr Matrix4x4 kIdentity = MathUtility::MakeIdentity4x4();
+	constexpr Matrix4x4 kScaleTranslate = MathUtility::MakeScaleTranslateMatrix({ 2.0f, 3.0f, 4.0f }, { 5.0f, 6.0f, 7.0f });
+
+	//単位行列を掛けても変わらない
+	static_assert(Equal(MathUtility::Multiply(kIdentity, kIdentity), kIdentity));
+	static_assert(Equal(MathUtility::Multiply(kScaleTranslate, kIdentity), kScaleTranslate));
+	static_assert(Equal(MathUtility::Multiply(kIdentity, kScaleTranslate), kScaleTranslate));
+
+	//回転0のAffine変換は拡大縮小+平行移動と一致する
+	static_assert(Equal(MathUtility::MakeAffineMatrix({ 2.0f, 3.0f, 4.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f }, { 5.0f, 6.0f, 7.0f }), kScaleTranslate));
+
+	//拡大縮小してから平行移動する
+	constexpr Matrix4x4 kScale = MathUtility::MakeScaleTranslateMatrix({ 2.0f, 3.0f, 4.0f }, { 0.0f, 0.0f, 0.0f });
+	constexpr Matrix4x4 kTranslate = MathUtility::MakeScaleTranslateMatrix({ 1.0f, 1.0f, 1.0f }, { 5.0f, 6.0f, 7.0f });
+	static_assert(Equal(MathUtility::Multiply(kScale, kTranslate), kScaleTranslate));
+
+	//スプライト用の平行投影は画面の左上(0,0)を(-1,1)、右下(1280,720)を(1,-1)に移す
+	constexpr Matrix4x4 kSpriteProjection = MathUtility::MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f);
+	static_assert(kSpriteProjection.m[3][0] == -1.0f && kSpriteProjection.m[3][1] == 1.0f);
+	static_assert(1280.0f * kSpriteProjection.m[0][0] + kSpriteProjection.m[3][0] == 1.0f);
+	static_assert(720.0f * kSpriteProjection.m[1][1] + kSpriteProjection.m[3][1] == -1.0f);
+
+	//2次元版は4x4版のXY成分と一致する
+	static_assert(Equal(MathUtility::MakeMatrix4x4(MathUtility::MakeOrthographicMatrix2D(0.0f, 0.0f, 1280.0f, 720.0f)),
+		MathUtility::MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f)));
+
+	//2次元のAffine変換を展開したものは4x4のAffine変換と一致する
+	static_assert(Equal(MathUtility::MakeMatrix4x4(MathUtility::MakeAffineMatrix2D({ 2.0f, 3.0f }, 1.0f, 0.0f, { 5.0f, 6.0f })),
+		MathUtility::MakeAffineMatrix({ 2.0f, 3.0f, 1.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 0.0f }, { 5.0f, 6.0f, 0.0f })));
+	static_assert(Equal(MathUtility::MakeMatrix4x4(MathUtility::Multiply(
+		MathUtility::MakeAffineMatrix2D({ 2.0f, 3.0f }, 0.0f, 1.0f, { 5.0f, 6.0f }), MathUtility::MakeAffineMatrix2D({ 1.0f, 1.0f }, 0.0f, 1.0f, { 1.0f, 2.0f }))),
+		MathUtility::MakeScaleTranslateMatrix({ 2.0f, 3.0f, 1.0f }, { 6.0f, 8.0f, 0.0f })));
+
+	//透視投影は近クリップ面を深度0、遠クリップ面を深度1に移す
+	constexpr Matrix4x4 kPerspective = MathUtility::MakePerspectiveMatrix(1.0f, 1.0f, 1.0f, 2.0f);
+	static_assert(1.0f * kPerspective.m[2][2] + kPerspective.m[3][2] == 0.0f);
+	static_assert((2.0f * kPerspective.m[2][2] + kPerspective.m[3][2]) / 2.0f == 1.0f);
+}
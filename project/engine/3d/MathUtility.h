@@ -0,0 +1,172 @@
+#pragma once
+
+#include "MyMath.h"
+#include "SinCos.h"
+
+//状態を持たない行列計算
+//三角関数を使わないものはconstexprなので、固定の行列はコンパイル時に定数になる
+//実行時に大量に掛け算する場合はSIMD版のMyMath::Multiplyを使う
+namespace MathUtility
+{
+	// 単位行列
+	constexpr Matrix4x4 MakeIdentity4x4()
+	{
+		return
+		{
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f,
+		};
+	}
+
+	// 4x4の掛け算
+	constexpr Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
+	{
+		Matrix4x4 result{};
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				result.m[row][column] = m1.m[row][0] * m2.m[0][column] + m1.m[row][1] * m2.m[1][column] + m1.m[row][2] * m2.m[2][column] + m1.m[row][3] * m2.m[3][column];
+			}
+		}
+		return result;
+	}
+
+	// 拡大縮小と平行移動だけのAffine変換(回転なし)
+	constexpr Matrix4x4 MakeScaleTranslateMatrix(const Vector3& scale, const Vector3& translate)
+	{
+		return
+		{
+			scale.x, 0.0f, 0.0f, 0.0f,
+			0.0f, scale.y, 0.0f, 0.0f,
+			0.0f, 0.0f, scale.z, 0.0f,
+			translate.x, translate.y, translate.z, 1.0f,
+		};
+	}
+
+	// sin/cos計算済みの回転からAffine変換(X→Y→Zの回転行列の積を展開したもの)
+	constexpr Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& sinRotate, const Vector3& cosRotate, const Vector3& translate)
+	{
+		const float sx = sinRotate.x, sy = sinRotate.y, sz = sinRotate.z;
+		const float cx = cosRotate.x, cy = cosRotate.y, cz = cosRotate.z;
+		return
+		{
+			cy * cz * scale.x, cy * sz * scale.x, -sy * scale.x, 0.0f,
+			(sx * sy * cz - cx * sz) * scale.y, (sx * sy * sz + cx * cz) * scale.y, sx * cy * scale.y, 0.0f,
+			(cx * sy * cz + sx * sz) * scale.z, (cx * sy * sz - sx * cz) * scale.z, cx * cy * scale.z, 0.0f,
+			translate.x, translate.y, translate.z, 1.0f,
+		};
+	}
+
+	// 透視投影(cotHalfFovYには1/tan(fovY/2)を渡す)
+	constexpr Matrix4x4 MakePerspectiveMatrix(float cotHalfFovY, float aspectRatio, float nearClip, float farClip)
+	{
+		return
+		{
+			(cotHalfFovY / aspectRatio), 0.0f, 0.0f, 0.0f,
+			0.0f, cotHalfFovY, 0.0f, 0.0f,
+			0.0f, 0.0f, farClip / (farClip - nearClip), 1.0f,
+			0.0f, 0.0f, -(nearClip * farClip) / (farClip - nearClip), 0.0f,
+		};
+	}
+
+	//平行投影
+	constexpr Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip)
+	{
+		return
+		{
+			2.0f / (right - left), 0.0f, 0.0f, 0.0f,
+			0.0f, 2.0f / (top - bottom), 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f / (farClip - nearClip), 0.0f,
+			(left + right) / (left - right), (top + bottom) / (bottom - top), nearClip / (nearClip - farClip), 1.0f,
+		};
+	}
+
+	// sin/cos計算済みの回転から2次元Affine変換
+	constexpr Matrix3x2 MakeAffineMatrix2D(const Vector2& scale, float sinRotate, float cosRotate, const Vector2& translate)
+	{
+		return
+		{
+			cosRotate * scale.x, sinRotate * scale.x,
+			-sinRotate * scale.y, cosRotate * scale.y,
+			translate.x, translate.y,
+		};
+	}
+
+	// 3x2の掛け算
+	constexpr Matrix3x2 Multiply(const Matrix3x2& m1, const Matrix3x2& m2)
+	{
+		return
+		{
+			m1.m[0][0] * m2.m[0][0] + m1.m[0][1] * m2.m[1][0], m1.m[0][0] * m2.m[0][1] + m1.m[0][1] * m2.m[1][1],
+			m1.m[1][0] * m2.m[0][0] + m1.m[1][1] * m2.m[1][0], m1.m[1][0] * m2.m[0][1] + m1.m[1][1] * m2.m[1][1],
+			m1.m[2][0] * m2.m[0][0] + m1.m[2][1] * m2.m[1][0] + m2.m[2][0], m1.m[2][0] * m2.m[0][1] + m1.m[2][1] * m2.m[1][1] + m2.m[2][1],
+		};
+	}
+
+	// 2次元の平行投影(MakeOrthographicMatrixのXY成分)
+	constexpr Matrix3x2 MakeOrthographicMatrix2D(float left, float top, float right, float bottom)
+	{
+		return
+		{
+			2.0f / (right - left), 0.0f,
+			0.0f, 2.0f / (top - bottom),
+			(left + right) / (left - right), (top + bottom) / (bottom - top),
+		};
+	}
+
+	// 3x2を4x4に展開する(Zはそのまま通す)
+	constexpr Matrix4x4 MakeMatrix4x4(const Matrix3x2& m)
+	{
+		return
+		{
+			m.m[0][0], m.m[0][1], 0.0f, 0.0f,
+			m.m[1][0], m.m[1][1], 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			m.m[2][0], m.m[2][1], 0.0f, 1.0f,
+		};
+	}
+
+	// クォータニオンの積(rhsの回転の後にlhsの回転)
+	constexpr Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs)
+	{
+		return
+		{
+			lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+			lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+			lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+			lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
+		};
+	}
+
+	// 単位クォータニオンからAffine変換(回転行列の行を拡大縮小して平行移動を入れる)
+	constexpr Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate)
+	{
+		const float xx = rotate.x * rotate.x, yy = rotate.y * rotate.y, zz = rotate.z * rotate.z;
+		const float xy = rotate.x * rotate.y, xz = rotate.x * rotate.z, yz = rotate.y * rotate.z;
+		const float wx = rotate.w * rotate.x, wy = rotate.w * rotate.y, wz = rotate.w * rotate.z;
+		return
+		{
+			(1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy + wz) * scale.x, 2.0f * (xz - wy) * scale.x, 0.0f,
+			2.0f * (xy - wz) * scale.y, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz + wx) * scale.y, 0.0f,
+			2.0f * (xz + wy) * scale.z, 2.0f * (yz - wx) * scale.z, (1.0f - 2.0f * (xx + yy)) * scale.z, 0.0f,
+			translate.x, translate.y, translate.z, 1.0f,
+		};
+	}
+
+	// 単位クォータニオンから回転行列
+	constexpr Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion)
+	{
+		return MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, quaternion, { 0.0f, 0.0f, 0.0f });
+	}
+
+	// 2次元Affine変換(Z軸回転のみ。三角関数を使うので実行時のみ)
+	inline Matrix3x2 MakeAffineMatrix2D(const Vector2& scale, float rotate, const Vector2& translate)
+	{
+		float sinRotate, cosRotate;
+		SinCos(rotate, &sinRotate, &cosRotate);
+		return MakeAffineMatrix2D(scale, sinRotate, cosRotate, translate);
+	}
+}
@@ -0,0 +1,584 @@
+#include "MeshLod.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+	//二次誤差 Q(p) = pᵀAp + 2b・p + c (Aは対称なので6要素だけ持つ)
+	struct Quadric
+	{
+		float a00, a11, a22, a01, a02, a12;
+		float b0, b1, b2;
+		float c;
+		//足し合わせた三角形の面積
+		float weight;
+	};
+
+	//UVの1成分の誤差 Σ weight * (g・p + d - s)^2 (gとdは三角形上でUVを表す一次式、sは縮約先の頂点のUV)
+	struct AttributeQuadric
+	{
+		Quadric quadric;
+		Vector3 gradientSum;
+		float offsetSum;
+	};
+
+	//頂点ごとの誤差
+	struct VertexQuadric
+	{
+		Quadric position;
+		AttributeQuadric texcoord[2];
+	};
+
+	//頂点vを頂点tにまとめる候補
+	struct Collapse
+	{
+		uint32_t vertex;
+		uint32_t target;
+		float cost;
+	};
+
+	Vector3 Subtract(const Vector3& v1, const Vector3& v2) { return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z }; }
+	Vector3 Cross(const Vector3& v1, const Vector3& v2) { return { v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x }; }
+	float Dot(const Vector3& v1, const Vector3& v2) { return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; }
+
+	// weight * (g・p + d)^2 を表す二次誤差
+	Quadric MakeQuadric(const Vector3& g, float d, float weight)
+	{
+		return {
+			g.x * g.x * weight, g.y * g.y * weight, g.z * g.z * weight,
+			g.x * g.y * weight, g.x * g.z * weight, g.y * g.z * weight,
+			g.x * d * weight, g.y * d * weight, g.z * d * weight,
+			d * d * weight,
+			weight,
+		};
+	}
+
+	void Accumulate(Quadric& quadric, const Quadric& other)
+	{
+		quadric.a00 += other.a00; quadric.a11 += other.a11; quadric.a22 += other.a22;
+		quadric.a01 += other.a01; quadric.a02 += other.a02; quadric.a12 += other.a12;
+		quadric.b0 += other.b0; quadric.b1 += other.b1; quadric.b2 += other.b2;
+		quadric.c += other.c;
+		quadric.weight += other.weight;
+	}
+
+	void Accumulate(AttributeQuadric& quadric, const AttributeQuadric& other)
+	{
+		Accumulate(quadric.quadric, other.quadric);
+		quadric.gradientSum = { quadric.gradientSum.x + other.gradientSum.x, quadric.gradientSum.y + other.gradientSum.y, quadric.gradientSum.z + other.gradientSum.z };
+		quadric.offsetSum += other.offsetSum;
+	}
+
+	void Accumulate(VertexQuadric& quadric, const VertexQuadric& other)
+	{
+		Accumulate(quadric.position, other.position);
+		Accumulate(quadric.texcoord[0], other.texcoord[0]);
+		Accumulate(quadric.texcoord[1], other.texcoord[1]);
+	}
+
+	float Evaluate(const Quadric& q, const Vector3& p)
+	{
+		return p.x * p.x * q.a00 + p.y * p.y * q.a11 + p.z * p.z * q.a22
+			+ 2.0f * (p.x * p.y * q.a01 + p.x * p.z * q.a02 + p.y * p.z * q.a12)
+			+ 2.0f * (p.x * q.b0 + p.y * q.b1 + p.z * q.b2)
+			+ q.c;
+	}
+
+	float Evaluate(const AttributeQuadric& q, const Vector3& p, float attribute)
+	{
+		return Evaluate(q.quadric, p) - 2.0f * attribute * (Dot(q.gradientSum, p) + q.offsetSum) + attribute * attribute * q.quadric.weight;
+	}
+
+	// vとtの誤差をまとめてtの位置とUVで測る(面積で割って、1三角形あたりの二乗誤差にする)
+	float EvaluateCollapse(const VertexQuadric& v, const VertexQuadric& t, const Vector3& position, const Vector2& texcoord)
+	{
+		VertexQuadric q = v;
+		Accumulate(q, t);
+		if (q.position.weight <= 0.0f)
+		{
+			return 0.0f;
+		}
+		float positionError = Evaluate(q.position, position);
+		float texcoordError = Evaluate(q.texcoord[0], position, texcoord.x) + Evaluate(q.texcoord[1], position, texcoord.y);
+		return (std::max)(0.0f, positionError + MeshLod::kTexcoordWeight * texcoordError) / q.position.weight;
+	}
+
+	// 三角形の頂点のうちvertexと一致するものの位置を置き換えた法線
+	Vector3 ComputeNormal(const Vector3* positions, const uint32_t* triangle, uint32_t vertex, const Vector3& replacement)
+	{
+		const Vector3& p0 = triangle[0] == vertex ? replacement : positions[triangle[0]];
+		const Vector3& p1 = triangle[1] == vertex ? replacement : positions[triangle[1]];
+		const Vector3& p2 = triangle[2] == vertex ? replacement : positions[triangle[2]];
+		return Cross(Subtract(p1, p0), Subtract(p2, p0));
+	}
+
+	// 位置が同じ頂点に同じ番号を振る(UVが違うだけの頂点を同じ点として扱うため)
+	std::vector<uint32_t> BuildPositionIds(std::span<const VertexData> vertices)
+	{
+		struct PositionHash
+		{
+			size_t operator()(const Vector3& p) const
+			{
+				//比較は==なので-0と0は同じ位置になる。0を足して-0を0にそろえてからビットを見る
+				const float canonical[3] = { p.x + 0.0f, p.y + 0.0f, p.z + 0.0f };
+				uint32_t bits[3];
+				std::memcpy(bits, canonical, sizeof(bits));
+				return (size_t(bits[0]) * 73856093u) ^ (size_t(bits[1]) * 19349663u) ^ (size_t(bits[2]) * 83492791u);
+			}
+		};
+		struct PositionEqual
+		{
+			bool operator()(const Vector3& p1, const Vector3& p2) const { return p1.x == p2.x && p1.y == p2.y && p1.z == p2.z; }
+		};
+
+		std::unordered_map<Vector3, uint32_t, PositionHash, PositionEqual> firstVertices;
+		firstVertices.reserve(vertices.size());
+		std::vector<uint32_t> positionIds(vertices.size());
+		for (uint32_t i = 0; i < vertices.size(); ++i)
+		{
+			const Vector4& p = vertices[i].position;
+			positionIds[i] = firstVertices.try_emplace({ p.x, p.y, p.z }, i).first->second;
+		}
+		return positionIds;
+	}
+}
+
+//二次誤差で辺を縮約して三角形を減らす
+//Garland, Heckbert "Surface Simplification Using Quadric Error Metrics" (1997)
+//UVはHoppe "New Quadric Metric for Simplifying Meshes with Appearance Attributes" (1999)の考え方で誤差に含める
+//縮約は片方の頂点をもう片方へ寄せるだけにして(half-edge collapse)、新しい頂点を作らない
+std::vector<uint32_t> MeshLod::Simplify(std::span<const VertexData> vertices, std::span<const uint32_t> indices, uint32_t targetIndexCount, float maxError, float* outError)
+{
+	const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	float resultErrorSq = 0.0f;
+
+	//＝＝＝1.バウンディングスフィアの中心と半径で位置を正規化する(ずれを半径に対する割合で測るため)＝＝＝
+	Vector3 minPosition{ FLT_MAX, FLT_MAX, FLT_MAX };
+	Vector3 maxPosition{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (const VertexData& vertex : vertices)
+	{
+		minPosition = { (std::min)(minPosition.x, vertex.position.x), (std::min)(minPosition.y, vertex.position.y), (std::min)(minPosition.z, vertex.position.z) };
+		maxPosition = { (std::max)(maxPosition.x, vertex.position.x), (std::max)(maxPosition.y, vertex.position.y), (std::max)(maxPosition.z, vertex.position.z) };
+	}
+	const Vector3 center{ (minPosition.x + maxPosition.x) * 0.5f, (minPosition.y + maxPosition.y) * 0.5f, (minPosition.z + maxPosition.z) * 0.5f };
+	float radiusSq = 0.0f;
+	for (const VertexData& vertex : vertices)
+	{
+		Vector3 d = Subtract({ vertex.position.x, vertex.position.y, vertex.position.z }, center);
+		radiusSq = (std::max)(radiusSq, Dot(d, d));
+	}
+	const float inverseRadius = radiusSq > 0.0f ? 1.0f / std::sqrt(radiusSq) : 1.0f;
+	std::vector<Vector3> positions(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		positions[i] = Subtract({ vertices[i].position.x, vertices[i].position.y, vertices[i].position.z }, center);
+		positions[i] = { positions[i].x * inverseRadius, positions[i].y * inverseRadius, positions[i].z * inverseRadius };
+	}
+
+	//位置が重なる三角形(面積0)は最初に取り除く
+	const std::vector<uint32_t> positionIds = BuildPositionIds(vertices);
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32_t a = positionIds[indices[i]];
+		uint32_t b = positionIds[indices[i + 1]];
+		uint32_t c = positionIds[indices[i + 2]];
+		if (a != b && b != c && c != a)
+		{
+			result.insert(result.end(), indices.begin() + i, indices.begin() + i + 3);
+		}
+	}
+
+	//＝＝＝2.動かしてよい頂点を決める＝＝＝
+	//UVの継ぎ目(同じ位置に複数の頂点がある)と、開いた縁や3枚以上の三角形が接する辺の頂点は形とUVを保つために動かさない
+	std::vector<uint32_t> wedgeCounts(vertexCount, 0);
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		++wedgeCounts[positionIds[i]];
+	}
+	std::unordered_map<uint64_t, uint32_t> edgeCounts;
+	edgeCounts.reserve(result.size());
+	for (size_t i = 0; i < result.size(); i += 3)
+	{
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t a = positionIds[result[i + corner]];
+			uint32_t b = positionIds[result[i + (corner + 1) % 3]];
+			++edgeCounts[(uint64_t((std::min)(a, b)) << 32) | (std::max)(a, b)];
+		}
+	}
+	std::vector<bool> isBorder(vertexCount, false);
+	for (const auto& [edge, count] : edgeCounts)
+	{
+		if (count != 2)
+		{
+			isBorder[static_cast<uint32_t>(edge >> 32)] = true;
+			isBorder[static_cast<uint32_t>(edge & 0xFFFFFFFF)] = true;
+		}
+	}
+	//縮約先にできるのは継ぎ目でない頂点、縮約できるのはさらに縁でもない頂点
+	std::vector<bool> canBeTarget(vertexCount, false);
+	std::vector<bool> canCollapse(vertexCount, false);
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		canBeTarget[i] = wedgeCounts[positionIds[i]] == 1;
+		canCollapse[i] = canBeTarget[i] && !isBorder[positionIds[i]];
+	}
+
+	//＝＝＝3.三角形の平面とUVの一次式から、頂点ごとの誤差を作る＝＝＝
+	std::vector<VertexQuadric> quadrics(vertexCount, VertexQuadric{});
+	for (size_t i = 0; i < result.size(); i += 3)
+	{
+		const uint32_t triangle[3] = { result[i], result[i + 1], result[i + 2] };
+		const Vector3& p0 = positions[triangle[0]];
+		Vector3 e1 = Subtract(positions[triangle[1]], p0);
+		Vector3 e2 = Subtract(positions[triangle[2]], p0);
+		Vector3 normal = Cross(e1, e2);
+		float length = std::sqrt(Dot(normal, normal));
+		if (length <= 0.0f)
+		{
+			continue;
+		}
+		normal = { normal.x / length, normal.y / length, normal.z / length };
+		const float area = length * 0.5f;
+
+		VertexQuadric quadric{};
+		quadric.position = MakeQuadric(normal, -Dot(normal, p0), area);
+
+		//UVの勾配g(三角形の平面上)を、辺に沿ったUVの変化から求める
+		float e11 = Dot(e1, e1);
+		float e12 = Dot(e1, e2);
+		float e22 = Dot(e2, e2);
+		float determinant = e11 * e22 - e12 * e12;
+		if (determinant > 0.0f)
+		{
+			const Vector2& t0 = vertices[triangle[0]].texcoord;
+			const Vector2& t1 = vertices[triangle[1]].texcoord;
+			const Vector2& t2 = vertices[triangle[2]].texcoord;
+			const float deltas[2][3] = { { t0.x, t1.x - t0.x, t2.x - t0.x }, { t0.y, t1.y - t0.y, t2.y - t0.y } };
+			for (uint32_t component = 0; component < 2; ++component)
+			{
+				float a = (deltas[component][1] * e22 - deltas[component][2] * e12) / determinant;
+				float b = (deltas[component][2] * e11 - deltas[component][1] * e12) / determinant;
+				Vector3 gradient{ e1.x * a + e2.x * b, e1.y * a + e2.y * b, e1.z * a + e2.z * b };
+				float offset = deltas[component][0] - Dot(gradient, p0);
+				quadric.texcoord[component].quadric = MakeQuadric(gradient, offset, area);
+				quadric.texcoord[component].gradientSum = { gradient.x * area, gradient.y * area, gradient.z * area };
+				quadric.texcoord[component].offsetSum = offset * area;
+			}
+		}
+		for (uint32_t vertex : triangle)
+		{
+			Accumulate(quadrics[vertex], quadric);
+		}
+	}
+
+	//＝＝＝4.誤差の小さい辺から縮約する(1回の走査では周りが動いていない頂点だけを縮約し、目標に届くまで繰り返す)＝＝＝
+	const uint32_t targetTriangleCount = targetIndexCount / 3;
+	const float maxErrorSq = maxError * maxError;
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> collapseTargets(vertexCount);
+	std::vector<bool> isLocked(vertexCount);
+	std::vector<uint32_t> neighbors;
+	std::vector<uint32_t> targetNeighbors;
+	while (result.size() / 3 > targetTriangleCount)
+	{
+		const uint32_t triangleCount = static_cast<uint32_t>(result.size() / 3);
+
+		//頂点ごとに、その頂点を使う三角形の一覧を作る
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (uint32_t index : result)
+		{
+			++adjacencyOffsets[index + 1];
+		}
+		for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+		}
+		adjacency.resize(result.size());
+		{
+			std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+			{
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					adjacency[cursors[result[triangle * 3 + corner]]++] = triangle;
+				}
+			}
+		}
+
+		//縮約の候補(内側の辺は両側の三角形から逆向きに1回ずつ出てくる)
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				uint32_t vertex = result[i + corner];
+				uint32_t target = result[i + (corner + 1) % 3];
+				if (canCollapse[vertex] && canBeTarget[target])
+				{
+					collapses.push_back({ vertex, target, EvaluateCollapse(quadrics[vertex], quadrics[target], positions[target], vertices[target].texcoord) });
+				}
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& c1, const Collapse& c2) { return c1.cost < c2.cost; });
+
+		for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			collapseTargets[vertex] = vertex;
+		}
+		std::fill(isLocked.begin(), isLocked.end(), false);
+		const uint32_t removeGoal = triangleCount - targetTriangleCount;
+		uint32_t removedCount = 0;
+		for (const Collapse& collapse : collapses)
+		{
+			if (removedCount >= removeGoal || collapse.cost > maxErrorSq)
+			{
+				break;
+			}
+			const uint32_t vertex = collapse.vertex;
+			const uint32_t target = collapse.target;
+			if (isLocked[vertex] || isLocked[target])
+			{
+				continue;
+			}
+
+			//vの周りの頂点(位置の番号で比べる)
+			neighbors.clear();
+			uint32_t sharedTriangleCount = 0;
+			for (uint32_t k = adjacencyOffsets[vertex]; k < adjacencyOffsets[vertex + 1]; ++k)
+			{
+				const uint32_t* triangle = &result[adjacency[k] * 3];
+				bool hasTarget = triangle[0] == target || triangle[1] == target || triangle[2] == target;
+				sharedTriangleCount += hasTarget ? 1 : 0;
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					if (triangle[corner] != vertex && triangle[corner] != target)
+					{
+						neighbors.push_back(positionIds[triangle[corner]]);
+					}
+				}
+			}
+			std::sort(neighbors.begin(), neighbors.end());
+			neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+			//tの周りの頂点
+			targetNeighbors.clear();
+			for (uint32_t k = adjacencyOffsets[target]; k < adjacencyOffsets[target + 1]; ++k)
+			{
+				const uint32_t* triangle = &result[adjacency[k] * 3];
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					if (triangle[corner] != vertex && triangle[corner] != target)
+					{
+						targetNeighbors.push_back(positionIds[triangle[corner]]);
+					}
+				}
+			}
+			std::sort(targetNeighbors.begin(), targetNeighbors.end());
+			targetNeighbors.erase(std::unique(targetNeighbors.begin(), targetNeighbors.end()), targetNeighbors.end());
+
+			//vとtの両方に隣接する頂点が、辺vtを挟む三角形の頂点だけであること(そうでないと縮約後に面が重なる)
+			uint32_t commonCount = 0;
+			for (size_t a = 0, b = 0; a < neighbors.size() && b < targetNeighbors.size();)
+			{
+				if (neighbors[a] < targetNeighbors[b]) { ++a; }
+				else if (targetNeighbors[b] < neighbors[a]) { ++b; }
+				else { ++commonCount; ++a; ++b; }
+			}
+			if (sharedTriangleCount == 0 || commonCount != sharedTriangleCount)
+			{
+				continue;
+			}
+
+			//vを使う三角形が裏返ったり大きく傾いたりしないこと
+			bool isFlipped = false;
+			for (uint32_t k = adjacencyOffsets[vertex]; k < adjacencyOffsets[vertex + 1] && !isFlipped; ++k)
+			{
+				const uint32_t* triangle = &result[adjacency[k] * 3];
+				if (triangle[0] == target || triangle[1] == target || triangle[2] == target)
+				{
+					continue;
+				}
+				Vector3 before = ComputeNormal(positions.data(), triangle, vertex, positions[vertex]);
+				Vector3 after = ComputeNormal(positions.data(), triangle, vertex, positions[target]);
+				isFlipped = Dot(before, after) <= 0.25f * std::sqrt(Dot(before, before) * Dot(after, after));
+			}
+			if (isFlipped)
+			{
+				continue;
+			}
+
+			//縮約する(周りの三角形が変わるので、この走査ではvの周りの頂点を動かさない)
+			collapseTargets[vertex] = target;
+			Accumulate(quadrics[target], quadrics[vertex]);
+			isLocked[vertex] = true;
+			isLocked[target] = true;
+			for (uint32_t k = adjacencyOffsets[vertex]; k < adjacencyOffsets[vertex + 1]; ++k)
+			{
+				const uint32_t* triangle = &result[adjacency[k] * 3];
+				isLocked[triangle[0]] = true;
+				isLocked[triangle[1]] = true;
+				isLocked[triangle[2]] = true;
+			}
+			removedCount += sharedTriangleCount;
+			resultErrorSq = (std::max)(resultErrorSq, collapse.cost);
+		}
+		if (removedCount == 0)
+		{
+			break;
+		}
+
+		//縮約した頂点を付け替えて、潰れた三角形を取り除く
+		size_t writeIndex = 0;
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			uint32_t a = collapseTargets[result[i]];
+			uint32_t b = collapseTargets[result[i + 1]];
+			uint32_t c = collapseTargets[result[i + 2]];
+			if (a != b && b != c && c != a)
+			{
+				result[writeIndex++] = a;
+				result[writeIndex++] = b;
+				result[writeIndex++] = c;
+			}
+		}
+		result.resize(writeIndex);
+	}
+
+	if (outError != nullptr)
+	{
+		*outError = std::sqrt(resultErrorSq);
+	}
+	return result;
+}
+
+//submeshesごとに簡略化してLODを追加する
+uint32_t MeshLod::GenerateLods(ModelData& modelData, std::span<const float> triangleRatios, float maxError)
+{
+	assert(modelData.lods.empty());
+	if (modelData.indices.empty())
+	{
+		return 0;
+	}
+	if (modelData.submeshes.empty())
+	{
+		modelData.submeshes.push_back({ 0, static_cast<uint32_t>(modelData.indices.size()), 0 });
+	}
+
+	//元のメッシュが0段目
+	const uint32_t baseSubmeshCount = static_cast<uint32_t>(modelData.submeshes.size());
+	modelData.lods.push_back({ 0, baseSubmeshCount, 0.0f });
+
+	size_t previousIndexCount = modelData.indices.size();
+	std::vector<uint32_t> levelIndices;
+	std::vector<SubmeshData> levelSubmeshes;
+	for (float ratio : triangleRatios)
+	{
+		levelIndices.clear();
+		levelSubmeshes.clear();
+		float levelError = 0.0f;
+		//マテリアルの境目は各範囲の縁になるので動かない
+		for (uint32_t i = 0; i < baseSubmeshCount; ++i)
+		{
+			const SubmeshData base = modelData.submeshes[i];
+			const uint32_t targetIndexCount = static_cast<uint32_t>(static_cast<float>(base.indexCount / 3) * ratio) * 3;
+			float error = 0.0f;
+			std::vector<uint32_t> simplified = Simplify(modelData.vertices, std::span(modelData.indices).subspan(base.indexOffset, base.indexCount), targetIndexCount, maxError, &error);
+			if (simplified.empty())
+			{
+				continue;
+			}
+			levelSubmeshes.push_back({ static_cast<uint32_t>(modelData.indices.size() + levelIndices.size()), static_cast<uint32_t>(simplified.size()), base.materialIndex });
+			levelIndices.insert(levelIndices.end(), simplified.begin(), simplified.end());
+			levelError = (std::max)(levelError, error);
+		}
+
+		//前の段からほとんど減らなければ、それ以上作っても意味がないので打ち切る
+		if (levelIndices.empty() || levelIndices.size() * 10 > previousIndexCount * 9)
+		{
+			break;
+		}
+		modelData.lods.push_back({ static_cast<uint32_t>(modelData.submeshes.size()), static_cast<uint32_t>(levelSubmeshes.size()), levelError });
+		modelData.submeshes.insert(modelData.submeshes.end(), levelSubmeshes.begin(), levelSubmeshes.end());
+		modelData.indices.insert(modelData.indices.end(), levelIndices.begin(), levelIndices.end());
+		previousIndexCount = levelIndices.size();
+	}
+	return static_cast<uint32_t>(modelData.lods.size());
+}
+
+//その段で描画する範囲
+std::span<const SubmeshData> MeshLod::GetSubmeshes(const ModelData& modelData, uint32_t lod)
+{
+	if (modelData.lods.empty())
+	{
+		return modelData.submeshes;
+	}
+	const LodData& lodData = modelData.lods[(std::min)(lod, static_cast<uint32_t>(modelData.lods.size() - 1))];
+	return std::span(modelData.submeshes).subspan(lodData.submeshOffset, lodData.submeshCount);
+}
+
+//バウンディングスフィアの画面上の大きさ
+float MeshLod::ComputeScreenSize(const Sphere& sphere, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix)
+{
+	//行ベクトルに右から掛けるので、ビュー座標のzは3列目との内積
+	const Vector3& c = sphere.center;
+	float viewZ = c.x * viewMatrix.m[0][2] + c.y * viewMatrix.m[1][2] + c.z * viewMatrix.m[2][2] + viewMatrix.m[3][2];
+	//射影後のw(透視投影ならビュー座標のz、平行投影なら1)
+	float w = viewZ * projectionMatrix.m[2][3] + projectionMatrix.m[3][3];
+	bool isPerspective = projectionMatrix.m[2][3] != 0.0f;
+	if (w <= 0.0f || (isPerspective && viewZ <= sphere.radius))
+	{
+		return FLT_MAX;
+	}
+	//NDCの高さは2なので、半径をNDCに直した値が画面の高さに対する直径の割合になる
+	return sphere.radius * projectionMatrix.m[1][1] / w;
+}
+
+//画面上のずれが許容ピクセル数以下になる一番粗い段を選ぶ
+uint32_t MeshLod::SelectLod(std::span<const LodData> lods, float screenSize, float screenHeight, float maxPixelError)
+{
+	//LODのずれは半径に対する割合なので、半径が画面上で何ピクセルになるかを掛ける
+	const float radiusInPixels = screenSize * screenHeight * 0.5f;
+	for (uint32_t lod = static_cast<uint32_t>(lods.size()); lod-- > 1;)
+	{
+		if (lods[lod].error * radiusInPixels <= maxPixelError)
+		{
+			return lod;
+		}
+	}
+	return 0;
+}
+
+//物体1つ分の段を選ぶ
+uint32_t MeshLod::SelectObjectLod(std::span<const LodData> lods, const Sphere& localSphere, const Matrix4x4& worldMatrix, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, float screenHeight, float maxPixelError)
+{
+	if (lods.size() <= 1)
+	{
+		return 0;
+	}
+	//行ベクトルに右から掛けるので、中心は4行目まで含めて変換し、各軸の拡大率は1～3行目の長さ
+	const Vector3& c = localSphere.center;
+	const Matrix4x4& m = worldMatrix;
+	Sphere worldSphere{};
+	worldSphere.center = {
+		c.x * m.m[0][0] + c.y * m.m[1][0] + c.z * m.m[2][0] + m.m[3][0],
+		c.x * m.m[0][1] + c.y * m.m[1][1] + c.z * m.m[2][1] + m.m[3][1],
+		c.x * m.m[0][2] + c.y * m.m[1][2] + c.z * m.m[2][2] + m.m[3][2],
+	};
+	float maxScaleSq = 0.0f;
+	for (uint32_t row = 0; row < 3; ++row)
+	{
+		maxScaleSq = (std::max)(maxScaleSq, m.m[row][0] * m.m[row][0] + m.m[row][1] * m.m[row][1] + m.m[row][2] * m.m[row][2]);
+	}
+	worldSphere.radius = localSphere.radius * std::sqrt(maxScaleSq);
+	return SelectLod(lods, ComputeScreenSize(worldSphere, viewMatrix, projectionMatrix), screenHeight, maxPixelError);
+}
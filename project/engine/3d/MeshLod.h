@@ -0,0 +1,66 @@
+#pragma once
+
+#include "MyMath.h"
+#include "Culling.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//メッシュを簡略化して詳細度(LOD)を作り、画面上の大きさから使う段を選ぶ
+namespace MeshLod
+{
+	//LODを作るときの三角形の割合(元のメッシュに対して)
+	constexpr float kDefaultTriangleRatios[] = { 0.5f, 0.25f, 0.125f };
+	//簡略化で許すずれの上限(バウンディングスフィアの半径に対する割合)
+	constexpr float kDefaultMaxError = 0.05f;
+	//UVのずれを位置のずれに対してどれだけ重く見るか
+	constexpr float kTexcoordWeight = 1.0f;
+
+	/// <summary>
+	/// 二次誤差(QEM)で辺を縮約して三角形を減らす。頂点は元の頂点をそのまま使うので、頂点バッファは元のメッシュと共有できる
+	/// </summary>
+	/// <param name="vertices">頂点</param>
+	/// <param name="indices">三角形リスト</param>
+	/// <param name="targetIndexCount">目標のIndex数(ずれが上限を超えるとそこで止まる)</param>
+	/// <param name="maxError">許すずれの上限(バウンディングスフィアの半径に対する割合)</param>
+	/// <param name="outError">実際のずれ。不要ならnullptr</param>
+	/// <returns>簡略化した三角形リスト</returns>
+	std::vector<uint32_t> Simplify(std::span<const VertexData> vertices, std::span<const uint32_t> indices, uint32_t targetIndexCount, float maxError = kDefaultMaxError, float* outError = nullptr);
+
+	/// <summary>
+	/// submeshesごとに簡略化して、LODのIndexと描画範囲をmodelDataの後ろに追加する
+	/// </summary>
+	/// <param name="modelData">元のメッシュ。lodsが空であること</param>
+	/// <param name="triangleRatios">各段の三角形の割合(大きい順)</param>
+	/// <param name="maxError">許すずれの上限</param>
+	/// <returns>作った段の数(元のメッシュを含む)。前の段からほとんど減らなければそこで打ち切る</returns>
+	uint32_t GenerateLods(ModelData& modelData, std::span<const float> triangleRatios = kDefaultTriangleRatios, float maxError = kDefaultMaxError);
+
+	// その段で描画する範囲(lodsが空なら全体)
+	std::span<const SubmeshData> GetSubmeshes(const ModelData& modelData, uint32_t lod);
+
+	// バウンディングスフィア(ワールド座標)の画面上の直径(画面の高さに対する割合。カメラが球の中なら大きな値を返す)
+	float ComputeScreenSize(const Sphere& sphere, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix);
+
+	/// <summary>
+	/// 画面上のずれが許容ピクセル数以下になる一番粗い段を選ぶ
+	/// </summary>
+	/// <param name="lods">ModelData::lods</param>
+	/// <param name="screenSize">ComputeScreenSizeで求めた画面上の大きさ</param>
+	/// <param name="screenHeight">画面の高さ(ピクセル)</param>
+	/// <param name="maxPixelError">許容するずれ(ピクセル)</param>
+	uint32_t SelectLod(std::span<const LodData> lods, float screenSize, float screenHeight, float maxPixelError = 1.0f);
+
+	/// <summary>
+	/// 物体1つ分の段を選ぶ(ローカル座標のバウンディングスフィアをワールド座標に移して、ComputeScreenSizeとSelectLodで選ぶ)
+	/// </summary>
+	/// <param name="lods">ModelData::lods</param>
+	/// <param name="localSphere">モデルのバウンディングスフィア(ローカル座標)</param>
+	/// <param name="worldMatrix">物体のワールド行列(半径は一番大きい軸の拡大率で広げる)</param>
+	/// <param name="viewMatrix">ビュー行列</param>
+	/// <param name="projectionMatrix">射影行列</param>
+	/// <param name="screenHeight">画面の高さ(ピクセル)</param>
+	/// <param name="maxPixelError">許容するずれ(ピクセル)</param>
+	uint32_t SelectObjectLod(std::span<const LodData> lods, const Sphere& localSphere, const Matrix4x4& worldMatrix, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, float screenHeight, float maxPixelError = 1.0f);
+}
@@ -0,0 +1,331 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+//FIFOの頂点キャッシュを再現してACMR/ATVRを求める
+MeshOptimizer::VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStatistics statistics{ 0.0f, 0.0f };
+	if (indices.size() < 3 || vertexCount == 0)
+	{
+		return statistics;
+	}
+
+	//頂点がキャッシュに入った時刻(cacheSize以上前ならキャッシュから追い出されている)
+	std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+	std::vector<bool> isUsed(vertexCount, false);
+	uint32_t timestamp = cacheSize + 1;
+	uint32_t missCount = 0;
+	uint32_t usedVertexCount = 0;
+	for (uint32_t index : indices)
+	{
+		if (timestamp - cacheTimestamps[index] > cacheSize)
+		{
+			cacheTimestamps[index] = timestamp++;
+			++missCount;
+		}
+		if (!isUsed[index])
+		{
+			isUsed[index] = true;
+			++usedVertexCount;
+		}
+	}
+
+	statistics.acmr = static_cast<float>(missCount) / static_cast<float>(indices.size() / 3);
+	statistics.atvr = static_cast<float>(missCount) / static_cast<float>(usedVertexCount);
+	return statistics;
+}
+
+//頂点キャッシュに合わせて三角形を並べ替える
+//Sander, Nehab, Barczak "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (2007)
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>* outClusterOffsets)
+{
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (outClusterOffsets != nullptr)
+	{
+		outClusterOffsets->clear();
+	}
+	if (triangleCount == 0 || vertexCount == 0)
+	{
+		return;
+	}
+
+	//＝＝＝1.頂点ごとに、その頂点を使う三角形の一覧を作る＝＝＝
+	std::vector<uint32_t> liveTriangleCounts(vertexCount, 0);
+	for (uint32_t index : indices)
+	{
+		++liveTriangleCounts[index];
+	}
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangleCounts[vertex];
+	}
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				adjacency[cursors[indices[triangle * 3 + corner]]++] = triangle;
+			}
+		}
+	}
+
+	//＝＝＝2.キャッシュに残っている頂点の周りの三角形から順に出力する＝＝＝
+	std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+	std::vector<bool> isEmitted(triangleCount, false);
+	std::vector<uint32_t> deadEndStack;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	uint32_t timestamp = cacheSize + 1;
+	uint32_t cursor = 0;
+
+	//次に扇の中心にする頂点(キャッシュに残っていて、まだ使う三角形があるもの)
+	auto skipDeadEnd = [&]() -> int64_t {
+		while (!deadEndStack.empty())
+		{
+			uint32_t vertex = deadEndStack.back();
+			deadEndStack.pop_back();
+			if (liveTriangleCounts[vertex] > 0)
+			{
+				return vertex;
+			}
+		}
+		//キャッシュが途切れるのでクラスタを区切る
+		while (cursor < vertexCount)
+		{
+			if (liveTriangleCounts[cursor] > 0)
+			{
+				if (outClusterOffsets != nullptr)
+				{
+					outClusterOffsets->push_back(static_cast<uint32_t>(result.size() / 3));
+				}
+				return cursor;
+			}
+			++cursor;
+		}
+		return -1;
+	};
+
+	int64_t fanningVertex = skipDeadEnd();
+	while (fanningVertex >= 0)
+	{
+		candidates.clear();
+		const uint32_t vertex = static_cast<uint32_t>(fanningVertex);
+		for (uint32_t i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i)
+		{
+			uint32_t triangle = adjacency[i];
+			if (isEmitted[triangle])
+			{
+				continue;
+			}
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				uint32_t index = indices[triangle * 3 + corner];
+				result.push_back(index);
+				deadEndStack.push_back(index);
+				candidates.push_back(index);
+				--liveTriangleCounts[index];
+				if (timestamp - cacheTimestamps[index] > cacheSize)
+				{
+					cacheTimestamps[index] = timestamp++;
+				}
+			}
+			isEmitted[triangle] = true;
+		}
+
+		//出力した三角形の頂点のうち、扇を広げてもキャッシュから追い出されないもので一番古いものを選ぶ
+		int64_t nextVertex = -1;
+		int64_t bestPriority = -1;
+		for (uint32_t candidate : candidates)
+		{
+			if (liveTriangleCounts[candidate] == 0)
+			{
+				continue;
+			}
+			int64_t priority = 0;
+			if (timestamp - cacheTimestamps[candidate] + 2 * liveTriangleCounts[candidate] <= cacheSize)
+			{
+				priority = timestamp - cacheTimestamps[candidate];
+			}
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				nextVertex = candidate;
+			}
+		}
+		fanningVertex = nextVertex >= 0 ? nextVertex : skipDeadEnd();
+	}
+
+	indices.swap(result);
+}
+
+//外側を向いたクラスタから先に描くように並べ替える
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, std::span<const VertexData> vertices, std::span<const uint32_t> clusterOffsets)
+{
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (clusterOffsets.size() < 2 || triangleCount == 0)
+	{
+		return;
+	}
+
+	//メッシュ全体の中心
+	Vector3 meshCenter{ 0.0f, 0.0f, 0.0f };
+	for (uint32_t index : indices)
+	{
+		meshCenter.x += vertices[index].position.x;
+		meshCenter.y += vertices[index].position.y;
+		meshCenter.z += vertices[index].position.z;
+	}
+	const float recpCount = 1.0f / static_cast<float>(indices.size());
+	meshCenter = { meshCenter.x * recpCount, meshCenter.y * recpCount, meshCenter.z * recpCount };
+
+	//クラスタの中心から見た面積付き法線の向き(外を向いているほど大きい)
+	struct Cluster
+	{
+		uint32_t begin;
+		uint32_t end;
+		float sortKey;
+	};
+	std::vector<Cluster> clusters;
+	clusters.reserve(clusterOffsets.size());
+	for (size_t c = 0; c < clusterOffsets.size(); ++c)
+	{
+		Cluster cluster{ clusterOffsets[c], c + 1 < clusterOffsets.size() ? clusterOffsets[c + 1] : triangleCount, 0.0f };
+
+		Vector3 center{ 0.0f, 0.0f, 0.0f };
+		Vector3 normal{ 0.0f, 0.0f, 0.0f };
+		float area = 0.0f;
+		for (uint32_t triangle = cluster.begin; triangle < cluster.end; ++triangle)
+		{
+			const Vector4& p0 = vertices[indices[triangle * 3 + 0]].position;
+			const Vector4& p1 = vertices[indices[triangle * 3 + 1]].position;
+			const Vector4& p2 = vertices[indices[triangle * 3 + 2]].position;
+			//時計回りが表なので、(p1 - p0) x (p2 - p0)が表側を向く
+			Vector3 e1{ p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+			Vector3 e2{ p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+			Vector3 n{ e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+			float triangleArea = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+			center.x += (p0.x + p1.x + p2.x) * triangleArea;
+			center.y += (p0.y + p1.y + p2.y) * triangleArea;
+			center.z += (p0.z + p1.z + p2.z) * triangleArea;
+			normal = { normal.x + n.x, normal.y + n.y, normal.z + n.z };
+			area += triangleArea;
+		}
+		if (area > 0.0f)
+		{
+			const float recpArea = 1.0f / (area * 3.0f);
+			center = { center.x * recpArea, center.y * recpArea, center.z * recpArea };
+			float normalLength = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			if (normalLength > 0.0f)
+			{
+				cluster.sortKey = ((center.x - meshCenter.x) * normal.x + (center.y - meshCenter.y) * normal.y + (center.z - meshCenter.z) * normal.z) / normalLength;
+			}
+		}
+		clusters.push_back(cluster);
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (const Cluster& cluster : clusters)
+	{
+		result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+	}
+	indices.swap(result);
+}
+
+//頂点を最初に使われる順に並べ替えて、Indexを付け直す
+void MeshOptimizer::OptimizeVertexFetch(ModelData& modelData)
+{
+	const uint32_t vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+	constexpr uint32_t kUnassigned = UINT32_MAX;
+	std::vector<uint32_t> remap(vertexCount, kUnassigned);
+	std::vector<VertexData> vertices;
+	vertices.reserve(vertexCount);
+
+	for (uint32_t& index : modelData.indices)
+	{
+		if (remap[index] == kUnassigned)
+		{
+			remap[index] = static_cast<uint32_t>(vertices.size());
+			vertices.push_back(modelData.vertices[index]);
+		}
+		index = remap[index];
+	}
+	//使われていない頂点も残しておく
+	for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		if (remap[vertex] == kUnassigned)
+		{
+			vertices.push_back(modelData.vertices[vertex]);
+		}
+	}
+	modelData.vertices.swap(vertices);
+}
+
+namespace
+{
+	//元のメッシュ(lods[0])の範囲だけの効率(LODの範囲まで混ぜると、描画するときの効率と違ってしまう)
+	MeshOptimizer::VertexCacheStatistics AnalyzeBaseLod(const ModelData& modelData)
+	{
+		const uint32_t vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+		if (modelData.lods.empty() || modelData.submeshes.empty())
+		{
+			return MeshOptimizer::AnalyzeVertexCache(modelData.indices, vertexCount);
+		}
+		const LodData& baseLod = modelData.lods[0];
+		std::vector<uint32_t> indices;
+		for (uint32_t i = baseLod.submeshOffset; i < baseLod.submeshOffset + baseLod.submeshCount; ++i)
+		{
+			const SubmeshData& submesh = modelData.submeshes[i];
+			auto rangeBegin = modelData.indices.begin() + submesh.indexOffset;
+			indices.insert(indices.end(), rangeBegin, rangeBegin + submesh.indexCount);
+		}
+		return MeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+	}
+}
+
+//まとめて最適化する
+MeshOptimizer::Report MeshOptimizer::Optimize(ModelData& modelData)
+{
+	const uint32_t vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+
+	Report report{};
+	report.before = AnalyzeBaseLod(modelData);
+
+	//マテリアルごとの描画範囲は崩さずに、範囲の中で並べ替える
+	std::vector<SubmeshData> ranges = modelData.submeshes;
+	if (ranges.empty())
+	{
+		ranges.push_back({ 0, static_cast<uint32_t>(modelData.indices.size()), 0 });
+	}
+	std::vector<uint32_t> rangeIndices;
+	std::vector<uint32_t> clusterOffsets;
+	for (const SubmeshData& range : ranges)
+	{
+		auto rangeBegin = modelData.indices.begin() + range.indexOffset;
+		rangeIndices.assign(rangeBegin, rangeBegin + range.indexCount);
+		OptimizeVertexCache(rangeIndices, vertexCount, kCacheSize, &clusterOffsets);
+		OptimizeOverdraw(rangeIndices, modelData.vertices, clusterOffsets);
+		std::copy(rangeIndices.begin(), rangeIndices.end(), rangeBegin);
+	}
+	OptimizeVertexFetch(modelData);
+
+	report.after = AnalyzeBaseLod(modelData);
+	return report;
+}
+
+//ログ用の文字列
+std::string MeshOptimizer::FormatReport(const Report& report)
+{
+	char text[128];
+	std::snprintf(text, sizeof(text), "ACMR %.3f -> %.3f, ATVR %.3f -> %.3f", report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr);
+	return text;
+}
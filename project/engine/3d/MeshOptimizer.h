@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MyMath.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+//読み込んだメッシュの三角形と頂点の並びをGPU向けに並べ替える
+namespace MeshOptimizer
+{
+	//頂点キャッシュの大きさ(頂点数)の目安
+	constexpr uint32_t kCacheSize = 16;
+
+	//頂点キャッシュの効率
+	struct VertexCacheStatistics
+	{
+		//三角形あたりの頂点シェーダー実行数(0.5～3。小さいほどよい)
+		float acmr;
+		//頂点あたりの頂点シェーダー実行数(1以上。1に近いほどよい)
+		float atvr;
+	};
+
+	//最適化の前後の効率(LODがあれば元のメッシュ(lods[0])の範囲だけで測る)
+	struct Report
+	{
+		VertexCacheStatistics before;
+		VertexCacheStatistics after;
+	};
+
+	// FIFOの頂点キャッシュを再現してACMR/ATVRを求める
+	VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = kCacheSize);
+
+	/// <summary>
+	/// 頂点キャッシュに合わせて三角形を並べ替える(Tipsify)
+	/// </summary>
+	/// <param name="indices">三角形リスト。並べ替えた結果で上書きする</param>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="cacheSize">頂点キャッシュの大きさ</param>
+	/// <param name="outClusterOffsets">キャッシュが途切れる位置(三角形の番号)。OptimizeOverdrawに渡す。不要ならnullptr</param>
+	void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kCacheSize, std::vector<uint32_t>* outClusterOffsets = nullptr);
+
+	/// <summary>
+	/// 外側を向いたクラスタから先に描くように並べ替える(クラスタ内の並びはそのまま)
+	/// </summary>
+	/// <param name="indices">三角形リスト。並べ替えた結果で上書きする</param>
+	/// <param name="vertices">頂点</param>
+	/// <param name="clusterOffsets">OptimizeVertexCacheが返したクラスタの開始位置</param>
+	void OptimizeOverdraw(std::vector<uint32_t>& indices, std::span<const VertexData> vertices, std::span<const uint32_t> clusterOffsets);
+
+	// 頂点を最初に使われる順に並べ替えて、Indexを付け直す(使われない頂点は後ろに回す)
+	void OptimizeVertexFetch(ModelData& modelData);
+
+	// 上の3つを順に行い、前後の効率を返す(三角形の並べ替えはLODも含めてsubmeshesの範囲ごとに行う)
+	Report Optimize(ModelData& modelData);
+
+	// ログ用の文字列
+	std::string FormatReport(const Report& report);
+}
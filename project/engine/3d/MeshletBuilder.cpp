@@ -0,0 +1,252 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+	// 三角形の法線(cross(p1 - p0, p2 - p0)を正規化したもの。面積0なら0ベクトル)
+	Vector3 ComputeTriangleNormal(std::span<const VertexData> vertices, const uint32_t* triangle)
+	{
+		const Vector4& p0 = vertices[triangle[0]].position;
+		const Vector4& p1 = vertices[triangle[1]].position;
+		const Vector4& p2 = vertices[triangle[2]].position;
+		Vector3 e1{ p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+		Vector3 e2{ p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+		Vector3 normal{ e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+		float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if (length <= 0.0f)
+		{
+			return { 0.0f, 0.0f, 0.0f };
+		}
+		return { normal.x / length, normal.y / length, normal.z / length };
+	}
+
+	Vector3 Normalize(const Vector3& v)
+	{
+		float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+		if (length <= 0.0f)
+		{
+			return { 0.0f, 0.0f, 0.0f };
+		}
+		return { v.x / length, v.y / length, v.z / length };
+	}
+}
+
+//メッシュレットに分ける
+MeshletData MeshletBuilder::Build(const ModelData& modelData, std::span<const SubmeshData> submeshes, uint32_t maxVertexCount, uint32_t maxTriangleCount)
+{
+	assert(maxVertexCount >= 3 && maxTriangleCount >= 1);
+	const uint32_t vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+
+	MeshletData meshletData;
+	//頂点・三角形が今のメッシュレットに入っているか(メッシュレットの番号で記録するので、作るたびに消さなくてよい)
+	std::vector<uint32_t> vertexMeshlets(vertexCount, UINT32_MAX);
+	std::vector<uint32_t> candidateMeshlets;
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<Vector3> triangleNormals;
+	std::vector<bool> isEmitted;
+	std::vector<uint32_t> candidates;
+
+	for (uint32_t groupIndex = 0; groupIndex < submeshes.size(); ++groupIndex)
+	{
+		const SubmeshData& submesh = submeshes[groupIndex];
+		const std::span<const uint32_t> indices = std::span(modelData.indices).subspan(submesh.indexOffset, submesh.indexCount);
+		const uint32_t triangleCount = submesh.indexCount / 3;
+		const uint32_t meshletOffset = static_cast<uint32_t>(meshletData.meshlets.size());
+
+		//＝＝＝1.頂点ごとに、その頂点を使う三角形の一覧を作る＝＝＝
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (uint32_t index : indices)
+		{
+			++adjacencyOffsets[index + 1];
+		}
+		for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+		}
+		adjacency.resize(triangleCount * 3);
+		{
+			std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+			{
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					adjacency[cursors[indices[triangle * 3 + corner]]++] = triangle;
+				}
+			}
+		}
+		triangleNormals.resize(triangleCount);
+		for (uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			triangleNormals[triangle] = ComputeTriangleNormal(modelData.vertices, &indices[triangle * 3]);
+		}
+		isEmitted.assign(triangleCount, false);
+		candidateMeshlets.assign(triangleCount, UINT32_MAX);
+
+		uint32_t seedTriangle = 0;
+		for (;;)
+		{
+			//＝＝＝2.まだ使っていない最初の三角形から始める(最適化済みなら並びが近いものほど近くにある)＝＝＝
+			while (seedTriangle < triangleCount && isEmitted[seedTriangle])
+			{
+				++seedTriangle;
+			}
+			if (seedTriangle == triangleCount)
+			{
+				break;
+			}
+
+			const uint32_t meshletIndex = static_cast<uint32_t>(meshletData.meshlets.size());
+			Meshlet meshlet{ static_cast<uint32_t>(meshletData.indices.size()), 0, 0, groupIndex };
+			Vector3 normalSum{ 0.0f, 0.0f, 0.0f };
+			candidates.clear();
+			auto addTriangle = [&](uint32_t triangle) {
+				isEmitted[triangle] = true;
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					uint32_t vertex = indices[triangle * 3 + corner];
+					meshletData.indices.push_back(vertex);
+					if (vertexMeshlets[vertex] == meshletIndex)
+					{
+						continue;
+					}
+					vertexMeshlets[vertex] = meshletIndex;
+					++meshlet.vertexCount;
+					//新しく入った頂点の周りの三角形を候補にする
+					for (uint32_t k = adjacencyOffsets[vertex]; k < adjacencyOffsets[vertex + 1]; ++k)
+					{
+						uint32_t neighbor = adjacency[k];
+						if (!isEmitted[neighbor] && candidateMeshlets[neighbor] != meshletIndex)
+						{
+							candidateMeshlets[neighbor] = meshletIndex;
+							candidates.push_back(neighbor);
+						}
+					}
+				}
+				meshlet.indexCount += 3;
+				const Vector3& normal = triangleNormals[triangle];
+				normalSum = { normalSum.x + normal.x, normalSum.y + normal.y, normalSum.z + normal.z };
+			};
+			addTriangle(seedTriangle);
+
+			//＝＝＝3.候補の中から、新しく増える頂点が少なく、向きが揃っているものを選んで加える＝＝＝
+			while (meshlet.indexCount / 3 < maxTriangleCount)
+			{
+				const Vector3 axis = Normalize(normalSum);
+				uint32_t bestTriangle = UINT32_MAX;
+				float bestScore = FLT_MAX;
+				size_t writeIndex = 0;
+				for (uint32_t candidate : candidates)
+				{
+					if (isEmitted[candidate])
+					{
+						continue;
+					}
+					candidates[writeIndex++] = candidate;
+
+					uint32_t newVertexCount = 0;
+					for (uint32_t corner = 0; corner < 3; ++corner)
+					{
+						newVertexCount += vertexMeshlets[indices[candidate * 3 + corner]] != meshletIndex ? 1 : 0;
+					}
+					if (meshlet.vertexCount + newVertexCount > maxVertexCount)
+					{
+						continue;
+					}
+					//向きのずれは頂点1つ分より軽く見る(法線コーンを狭くしてカリングしやすくする)
+					const Vector3& normal = triangleNormals[candidate];
+					float score = static_cast<float>(newVertexCount) + (1.0f - (normal.x * axis.x + normal.y * axis.y + normal.z * axis.z)) * 0.5f;
+					if (score < bestScore)
+					{
+						bestScore = score;
+						bestTriangle = candidate;
+					}
+				}
+				candidates.resize(writeIndex);
+				if (bestTriangle == UINT32_MAX)
+				{
+					break;
+				}
+				addTriangle(bestTriangle);
+			}
+
+			//＝＝＝4.境界を求める＝＝＝
+			const std::span<const uint32_t> meshletIndices = std::span(meshletData.indices).subspan(meshlet.indexOffset, meshlet.indexCount);
+			meshletData.sphereBounds.Add(ComputeSphere(modelData.vertices, meshletIndices));
+			meshletData.coneBounds.Add(ComputeCone(modelData.vertices, meshletIndices));
+			meshletData.meshlets.push_back(meshlet);
+		}
+
+		meshletData.groups.push_back({ meshletOffset, static_cast<uint32_t>(meshletData.meshlets.size()) - meshletOffset, submesh.materialIndex });
+	}
+	return meshletData;
+}
+
+//三角形の集まりのバウンディングスフィア
+Sphere MeshletBuilder::ComputeSphere(std::span<const VertexData> vertices, std::span<const uint32_t> indices)
+{
+	if (indices.empty())
+	{
+		return { { 0.0f, 0.0f, 0.0f }, 0.0f };
+	}
+
+	AABB aabb = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+	for (uint32_t index : indices)
+	{
+		const Vector4& position = vertices[index].position;
+		aabb.min = { (std::min)(aabb.min.x, position.x), (std::min)(aabb.min.y, position.y), (std::min)(aabb.min.z, position.z) };
+		aabb.max = { (std::max)(aabb.max.x, position.x), (std::max)(aabb.max.y, position.y), (std::max)(aabb.max.z, position.z) };
+	}
+
+	Sphere sphere{};
+	sphere.center = { (aabb.min.x + aabb.max.x) * 0.5f, (aabb.min.y + aabb.max.y) * 0.5f, (aabb.min.z + aabb.max.z) * 0.5f };
+	float maxDistanceSq = 0.0f;
+	for (uint32_t index : indices)
+	{
+		const Vector4& position = vertices[index].position;
+		float dx = position.x - sphere.center.x;
+		float dy = position.y - sphere.center.y;
+		float dz = position.z - sphere.center.z;
+		maxDistanceSq = (std::max)(maxDistanceSq, dx * dx + dy * dy + dz * dz);
+	}
+	sphere.radius = std::sqrt(maxDistanceSq);
+	return sphere;
+}
+
+//三角形の集まりの法線コーン
+Cone MeshletBuilder::ComputeCone(std::span<const VertexData> vertices, std::span<const uint32_t> indices)
+{
+	Vector3 normalSum{ 0.0f, 0.0f, 0.0f };
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		Vector3 normal = ComputeTriangleNormal(vertices, &indices[i]);
+		normalSum = { normalSum.x + normal.x, normalSum.y + normal.y, normalSum.z + normal.z };
+	}
+	const Vector3 axis = Normalize(normalSum);
+	if (axis.x == 0.0f && axis.y == 0.0f && axis.z == 0.0f)
+	{
+		return { { 0.0f, 0.0f, 1.0f }, 1.0f };
+	}
+
+	//軸と法線のなす角の最大値(のcos)
+	float minDot = 1.0f;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		Vector3 normal = ComputeTriangleNormal(vertices, &indices[i]);
+		if (normal.x != 0.0f || normal.y != 0.0f || normal.z != 0.0f)
+		{
+			minDot = (std::min)(minDot, normal.x * axis.x + normal.y * axis.y + normal.z * axis.z);
+		}
+	}
+	//法線が半球より広がっていると、どこから見ても表向きの三角形があるので判定しない
+	if (minDot <= 0.0f)
+	{
+		return { axis, 1.0f };
+	}
+	//視線と軸のなす角のcosがsin(広がり)以上なら、すべての三角形が裏を向いている
+	return { axis, std::sqrt(1.0f - minDot * minDot) };
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "MyMath.h"
+#include "Culling.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//メッシュレット(頂点数と三角形数に上限のある、隣り合った三角形のまとまり)
+struct Meshlet
+{
+	//MeshletData::indicesの範囲
+	uint32_t indexOffset;
+	uint32_t indexCount;
+	//使っている頂点の数
+	uint32_t vertexCount;
+	//MeshletData::groupsの番号
+	uint32_t groupIndex;
+};
+
+//同じマテリアルのメッシュレットの範囲(元のメッシュのsubmeshごとに1つ)
+struct MeshletGroup
+{
+	uint32_t meshletOffset;
+	uint32_t meshletCount;
+	uint32_t materialIndex;
+};
+
+//メッシュレットに分けたメッシュ(頂点は元のModelDataのものをそのまま使う)
+struct MeshletData
+{
+	std::vector<Meshlet> meshlets;
+	std::vector<MeshletGroup> groups;
+	//メッシュレットの順に並べ替えたIndex(頂点番号は元のまま)
+	std::vector<uint32_t> indices;
+	//メッシュレットごとの境界(カリング用にSoAで持つ)
+	SphereBounds sphereBounds;
+	ConeBounds coneBounds;
+};
+
+//メッシュレットのカリング結果(毎フレーム使い回す)
+struct MeshletCullResult
+{
+	std::vector<uint32_t> visibleMeshlets;
+	//見えているメッシュレットのIndexを詰めたもの(このままIndexバッファに書き込む)
+	std::vector<uint32_t> indices;
+	//indicesの中のマテリアルごとの描画範囲
+	std::vector<SubmeshData> submeshes;
+};
+
+//メッシュをメッシュレットに分ける
+namespace MeshletBuilder
+{
+	//1つのメッシュレットの上限(メッシュシェーダーでもよく使われる大きさ)
+	constexpr uint32_t kDefaultMaxVertexCount = 64;
+	constexpr uint32_t kDefaultMaxTriangleCount = 124;
+
+	/// <summary>
+	/// 隣り合った三角形を、新しく増える頂点が少ないものから順に集めてメッシュレットを作る
+	/// </summary>
+	/// <param name="modelData">元のメッシュ</param>
+	/// <param name="submeshes">分ける範囲(MeshLod::GetSubmeshesでLODを選べる)。範囲をまたぐメッシュレットは作らない</param>
+	/// <param name="maxVertexCount">1つのメッシュレットの頂点数の上限(3以上)</param>
+	/// <param name="maxTriangleCount">1つのメッシュレットの三角形数の上限(1以上)</param>
+	MeshletData Build(const ModelData& modelData, std::span<const SubmeshData> submeshes, uint32_t maxVertexCount = kDefaultMaxVertexCount, uint32_t maxTriangleCount = kDefaultMaxTriangleCount);
+
+	// 三角形の集まりのバウンディングスフィア(AABBの中心を中心とする)
+	Sphere ComputeSphere(std::span<const VertexData> vertices, std::span<const uint32_t> indices);
+
+	// 三角形の集まりの法線コーン(法線はcross(p1 - p0, p2 - p0)の向き)
+	Cone ComputeCone(std::span<const VertexData> vertices, std::span<const uint32_t> indices);
+}
@@ -0,0 +1,792 @@
+#include "ModelLoader.h"
+#include "CookedMesh.h"
+#include "MappedFile.h"
+#include "MeshLod.h"
+#include "MeshOptimizer.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+	//並列に読むときの1スレッドあたりの最小の大きさ(バイト)
+	constexpr size_t kMinChunkSize = 256 * 1024;
+
+	// ファイルをまとめて読み込む(1行ずつのstreamを作らない)
+	std::string ReadFile(const std::string& filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+		assert(file.is_open());
+		std::string text;
+		text.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(text.data(), static_cast<std::streamsize>(text.size()));
+		return text;
+	}
+
+	// 空白(改行コードの\rを含む)か
+	inline bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+	}
+
+	// 1行を取り出して、カーソルを次の行の先頭へ進める
+	inline std::string_view NextLine(const char*& cursor, const char* end)
+	{
+		const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+		if (lineEnd == nullptr)
+		{
+			lineEnd = end;
+		}
+		std::string_view line(cursor, static_cast<size_t>(lineEnd - cursor));
+		cursor = lineEnd == end ? end : lineEnd + 1;
+		return line;
+	}
+
+	// 空白で区切られた次の要素を取り出す(無ければ空)
+	inline std::string_view NextToken(std::string_view& line)
+	{
+		size_t begin = 0;
+		while (begin < line.size() && IsSpace(line[begin]))
+		{
+			++begin;
+		}
+		size_t end = begin;
+		while (end < line.size() && !IsSpace(line[end]))
+		{
+			++end;
+		}
+		std::string_view token = line.substr(begin, end - begin);
+		line.remove_prefix(end);
+		return token;
+	}
+
+	// 次の要素をfloatとして読む
+	inline float NextFloat(std::string_view& line)
+	{
+		std::string_view token = NextToken(line);
+		float value = 0.0f;
+		std::from_chars(token.data(), token.data() + token.size(), value);
+		return value;
+	}
+
+	// 面の頂点定義(位置/テクスチャ座標/法線のIndexの組)
+	struct FaceVertexKey
+	{
+		uint32_t elementIndices[3];
+
+		bool operator==(const FaceVertexKey& other) const
+		{
+			return elementIndices[0] == other.elementIndices[0] && elementIndices[1] == other.elementIndices[1] && elementIndices[2] == other.elementIndices[2];
+		}
+	};
+
+	struct FaceVertexKeyHash
+	{
+		size_t operator()(const FaceVertexKey& key) const
+		{
+			//FNV-1a
+			uint64_t hash = 14695981039346656037ull;
+			for (uint32_t element : key.elementIndices)
+			{
+				hash = (hash ^ element) * 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	// ファイルに書かれたままの面の頂点定義(省略した要素は0、負の値はその行までの要素数からの相対)
+	struct FaceVertexDefinition
+	{
+		int32_t elementIndices[3];
+	};
+
+	// "1/2/3"・"1//3"・"1"・"-1/-1/-1"の形の頂点定義から各要素のIndexを読む。形が違えばfalse
+	inline bool ParseFaceVertex(std::string_view vertexDefinition, FaceVertexDefinition& outDefinition)
+	{
+		const char* cursor = vertexDefinition.data();
+		const char* end = cursor + vertexDefinition.size();
+		for (uint32_t element = 0; element < 3; ++element)
+		{
+			outDefinition.elementIndices[element] = 0;
+			if (cursor < end && *cursor != '/')
+			{
+				auto [next, errorCode] = std::from_chars(cursor, end, outDefinition.elementIndices[element]);
+				if (errorCode != std::errc{})
+				{
+					return false;
+				}
+				cursor = next;
+			}
+			//区切り文字を飛ばす
+			if (cursor < end)
+			{
+				if (*cursor != '/')
+				{
+					return false;
+				}
+				++cursor;
+			}
+		}
+		return cursor == end && !vertexDefinition.empty();
+	}
+
+	// 要素(位置/テクスチャ座標/法線)ごとの数
+	struct ElementCounts
+	{
+		size_t counts[3];
+	};
+
+	/// <summary>
+	/// 面の頂点定義のIndexを、1から始まる通し番号にする(テクスチャ座標と法線は省略なら0のまま)
+	/// </summary>
+	/// <param name="definition">ファイルに書かれたままの頂点定義</param>
+	/// <param name="definedCounts">その行までに定義された要素の数(負のIndexの基準)</param>
+	/// <param name="totalCounts">ファイル全体の要素の数</param>
+	/// <param name="outKey">書き込み先</param>
+	/// <returns>全ての要素が範囲内で、位置があるか</returns>
+	inline bool ResolveFaceVertex(const FaceVertexDefinition& definition, const ElementCounts& definedCounts, const ElementCounts& totalCounts, FaceVertexKey& outKey)
+	{
+		for (uint32_t element = 0; element < 3; ++element)
+		{
+			int64_t index = definition.elementIndices[element];
+			if (index == 0)
+			{
+				//位置は省略できない
+				if (element == 0)
+				{
+					return false;
+				}
+				outKey.elementIndices[element] = 0;
+				continue;
+			}
+			if (index < 0)
+			{
+				index += static_cast<int64_t>(definedCounts.counts[element]) + 1;
+			}
+			if (index < 1 || index > static_cast<int64_t>(totalCounts.counts[element]))
+			{
+				return false;
+			}
+			outKey.elementIndices[element] = static_cast<uint32_t>(index);
+		}
+		return true;
+	}
+}
+
+//MaterialData構造体と読み込み関数
+std::vector<MaterialData> ModelLoader::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename)
+{
+	//＝＝＝1.中で必要となる変数の宣言＝＝＝
+	std::vector<MaterialData> materials;//構築するMaterialData
+	//＝＝＝2.ファイルをまとめて読み込む＝＝＝
+	const std::string text = ReadFile(directoryPath + "/" + filename);
+	const char* cursor = text.data();
+	const char* end = cursor + text.size();
+	//＝＝＝3.実際にファイルを読み、MaterialDataを構築していく＝＝＝
+	while (cursor < end)
+	{
+		std::string_view line = NextLine(cursor, end);
+		std::string_view identifier = NextToken(line);//先頭の識別子を読む
+
+		//identifierに応じた処理
+		if (identifier == "newmtl")
+		{
+			materials.push_back({ std::string(NextToken(line)), std::string() });
+		}
+		else if (identifier == "map_Kd")
+		{
+			//newmtlより前に書かれていたら名前の無いマテリアルとして扱う
+			if (materials.empty())
+			{
+				materials.push_back({});
+			}
+			std::string_view textureFilename = NextToken(line);
+			materials.back().textureFilePath = directoryPath + "/" + std::string(textureFilename);
+		}
+	}
+	//＝＝＝4.materialsを返す＝＝＝
+	return materials;
+}
+
+namespace
+{
+	// 面の頂点を登録してその頂点Indexを返す(同じ組み合わせが既にあればそのIndex。keyはResolveFaceVertexで範囲を確かめたもの)
+	uint32_t AddFaceVertex(const FaceVertexKey& key, const std::vector<Vector4>& positions, const std::vector<Vector2>& texcoords, const std::vector<Vector3>& normals,
+		std::unordered_map<FaceVertexKey, uint32_t, FaceVertexKeyHash>& vertexIndices, ModelData& modelData)
+	{
+		auto [it, inserted] = vertexIndices.try_emplace(key, static_cast<uint32_t>(modelData.vertices.size()));
+		if (inserted)
+		{
+			//要素へのIndexから、実際の要素の値を取得して頂点を構築する(省略されたテクスチャ座標と法線は0)
+			Vector4 position = positions[key.elementIndices[0] - 1];
+			position.x *= -1.0f;
+			Vector2 texcoord{ 0.0f, 0.0f };
+			if (key.elementIndices[1] != 0)
+			{
+				texcoord = texcoords[key.elementIndices[1] - 1];
+				texcoord.y = 1.0f - texcoord.y;
+			}
+			//法線の違う頂点は分けて登録するので、法線も持たせる(位置と同じく右手系から左手系へ)
+			Vector3 normal{ 0.0f, 0.0f, 0.0f };
+			if (key.elementIndices[2] != 0)
+			{
+				normal = normals[key.elementIndices[2] - 1];
+				normal.x *= -1.0f;
+			}
+			modelData.vertices.push_back({ position,texcoord,normal });
+		}
+		return it->second;
+	}
+
+	// usemtlでマテリアルが切り替わった位置
+	struct MaterialChange
+	{
+		//この番号の三角形から
+		uint32_t faceIndex;
+		std::string_view name;
+	};
+
+	// 三角形をマテリアルごとにまとめて並べ替え、マテリアルごとの描画範囲を作る
+	//(o/gで分かれたオブジェクトでも同じマテリアルなら1つの範囲にまとめる)
+	void BuildSubmeshes(ModelData& modelData, std::span<const MaterialChange> materialChanges)
+	{
+		const uint32_t faceCount = static_cast<uint32_t>(modelData.indices.size() / 3);
+		if (faceCount == 0)
+		{
+			return;
+		}
+
+		//＝＝＝1.三角形ごとのマテリアル番号を決める＝＝＝
+		std::unordered_map<std::string, uint32_t> materialIndices;
+		for (uint32_t i = 0; i < modelData.materials.size(); ++i)
+		{
+			materialIndices.try_emplace(modelData.materials[i].name, i);
+		}
+		//mtlファイルに無い名前はテクスチャ無しのマテリアルとして追加する
+		auto resolveMaterial = [&](std::string_view name) -> uint32_t {
+			auto it = materialIndices.find(std::string(name));
+			if (it != materialIndices.end())
+			{
+				return it->second;
+			}
+			modelData.materials.push_back({ std::string(name), std::string() });
+			uint32_t index = static_cast<uint32_t>(modelData.materials.size() - 1);
+			materialIndices.emplace(modelData.materials.back().name, index);
+			return index;
+		};
+
+		std::vector<uint32_t> faceMaterials(faceCount);
+		uint32_t currentFace = 0;
+		//最初のusemtlより前の三角形は先頭のマテリアルを使う
+		uint32_t currentMaterial = 0;
+		if (modelData.materials.empty() && (materialChanges.empty() || materialChanges.front().faceIndex > 0))
+		{
+			modelData.materials.push_back({});
+		}
+		for (const MaterialChange& change : materialChanges)
+		{
+			for (; currentFace < change.faceIndex && currentFace < faceCount; ++currentFace)
+			{
+				faceMaterials[currentFace] = currentMaterial;
+			}
+			currentMaterial = resolveMaterial(change.name);
+		}
+		for (; currentFace < faceCount; ++currentFace)
+		{
+			faceMaterials[currentFace] = currentMaterial;
+		}
+
+		//＝＝＝2.マテリアル番号の順に三角形を並べ替える(同じマテリアルの中ではファイルの順)＝＝＝
+		const uint32_t materialCount = static_cast<uint32_t>(modelData.materials.size());
+		std::vector<uint32_t> faceOffsets(materialCount + 1, 0);
+		for (uint32_t material : faceMaterials)
+		{
+			++faceOffsets[material + 1];
+		}
+		for (uint32_t material = 0; material < materialCount; ++material)
+		{
+			if (faceOffsets[material + 1] != 0)
+			{
+				modelData.submeshes.push_back({ faceOffsets[material] * 3, faceOffsets[material + 1] * 3, material });
+			}
+			faceOffsets[material + 1] += faceOffsets[material];
+		}
+
+		std::vector<uint32_t> sortedIndices(modelData.indices.size());
+		for (uint32_t face = 0; face < faceCount; ++face)
+		{
+			uint32_t destination = faceOffsets[faceMaterials[face]]++;
+			std::copy_n(modelData.indices.begin() + face * 3, 3, sortedIndices.begin() + destination * 3);
+		}
+		modelData.indices.swap(sortedIndices);
+	}
+
+	// 1つのスレッドで先頭から順に読む(面の頂点定義が不正ならfalse)
+	bool ParseObjSerial(const std::string& directoryPath, const std::string& text, ModelData& outModelData)
+	{
+		//＝＝＝1.中で必要となる変数の宣言＝＝＝
+		ModelData modelData;//構築するModelData
+		std::vector<Vector4> positions;//位置
+		std::vector<Vector3> normals;//法線
+		std::vector<Vector2> texcoords;//テクスチャ座標
+		std::vector<MaterialChange> materialChanges;//マテリアルの切り替え
+		const char* begin = text.data();
+		const char* end = begin + text.size();
+
+		//＝＝＝2.要素の数を数えて、配列を先に確保しておく＝＝＝
+		size_t positionCount = 0;
+		size_t texcoordCount = 0;
+		size_t normalCount = 0;
+		size_t faceCount = 0;
+		for (const char* cursor = begin; cursor < end;)
+		{
+			std::string_view line = NextLine(cursor, end);
+			std::string_view identifier = NextToken(line);
+			if (identifier == "v") { ++positionCount; }
+			else if (identifier == "vt") { ++texcoordCount; }
+			else if (identifier == "vn") { ++normalCount; }
+			else if (identifier == "f") { ++faceCount; }
+		}
+		positions.reserve(positionCount);
+		texcoords.reserve(texcoordCount);
+		normals.reserve(normalCount);
+		modelData.indices.reserve(faceCount * 3);
+		//頂点数は共有のされ方で変わるので、多めに見積もって確保する
+		modelData.vertices.reserve(faceCount * 3);
+		//位置/テクスチャ座標/法線のIndexの組から頂点Indexを引く
+		std::unordered_map<FaceVertexKey, uint32_t, FaceVertexKeyHash> vertexIndices;
+		vertexIndices.reserve(faceCount * 3);
+		const ElementCounts totalCounts{ { positionCount, texcoordCount, normalCount } };
+
+		//＝＝＝3.実際にファイルを読み、ModelDataを構築していく＝＝＝
+		for (const char* cursor = begin; cursor < end;)
+		{
+			std::string_view line = NextLine(cursor, end);
+			std::string_view identifier = NextToken(line);//先頭の識別子を読む
+
+			//identifierに応じた処理
+			if (identifier == "v")
+			{
+				Vector4 position;
+				position.x = NextFloat(line);
+				position.y = NextFloat(line);
+				position.z = NextFloat(line);
+				position.w = 1.0f;
+				positions.push_back(position);
+			}
+			else if (identifier == "vt")
+			{
+				Vector2 texcoord;
+				texcoord.x = NextFloat(line);
+				texcoord.y = NextFloat(line);
+				texcoords.push_back(texcoord);
+			}
+			else if (identifier == "vn")
+			{
+				Vector3 normal;
+				normal.x = NextFloat(line);
+				normal.y = NextFloat(line);
+				normal.z = NextFloat(line);
+				normals.push_back(normal);
+			}
+			else if (identifier == "f")
+			{
+				uint32_t triangle[3];
+				const ElementCounts definedCounts{ { positions.size(), texcoords.size(), normals.size() } };
+				//面は三角形限定
+				for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex)
+				{
+					FaceVertexDefinition definition{};
+					FaceVertexKey key{};
+					if (!ParseFaceVertex(NextToken(line), definition) || !ResolveFaceVertex(definition, definedCounts, totalCounts, key))
+					{
+						return false;
+					}
+					triangle[faceVertex] = AddFaceVertex(key, positions, texcoords, normals, vertexIndices, modelData);
+				}
+
+				//頂点を逆順で登録することで、回り順を逆にする
+				modelData.indices.push_back(triangle[2]);
+				modelData.indices.push_back(triangle[1]);
+				modelData.indices.push_back(triangle[0]);
+			}
+			else if (identifier == "usemtl")
+			{
+				materialChanges.push_back({ static_cast<uint32_t>(modelData.indices.size() / 3), NextToken(line) });
+			}
+			else if (identifier == "mtllib")
+			{
+				std::string_view materialFilename = NextToken(line);
+				std::vector<MaterialData> materials = ModelLoader::LoadMaterialTemplateFile(directoryPath, std::string(materialFilename));
+				modelData.materials.insert(modelData.materials.end(), materials.begin(), materials.end());
+				modelData.materialLibraryPaths.push_back(directoryPath + "/" + std::string(materialFilename));
+			}
+		}
+		//多めに確保した分を返す
+		modelData.vertices.shrink_to_fit();
+		//マテリアルごとにまとめる
+		BuildSubmeshes(modelData, materialChanges);
+		//＝＝＝4.ModelDataを返す＝＝＝
+		outModelData = std::move(modelData);
+		return true;
+	}
+
+	// 並列に読むときの1区間分の結果
+	struct ObjChunk
+	{
+		std::vector<Vector4> positions;
+		std::vector<Vector2> texcoords;
+		std::vector<Vector3> normals;
+		//面の頂点定義(ファイルの順のまま3つずつ)
+		std::vector<FaceVertexDefinition> faceVertices;
+		//面ごとの、その行までに区間内で定義された要素の数(負のIndexを解決するのに使う)
+		std::vector<ElementCounts> faceDefinedCounts;
+		//形の違う頂点定義があったか
+		bool isInvalid = false;
+		//区間内で指定されたmtlファイル
+		std::vector<std::string_view> materialFilenames;
+		//マテリアルの切り替え(三角形の番号は区間内での番号)
+		std::vector<MaterialChange> materialChanges;
+	};
+
+	// 1区間を読む(objのIndexはファイル全体での通し番号なので、区間をまたいでもそのまま使える)
+	void ParseObjChunk(const char* begin, const char* end, ObjChunk* chunk)
+	{
+		//要素の数を数えて、配列を先に確保しておく
+		size_t positionCount = 0;
+		size_t texcoordCount = 0;
+		size_t normalCount = 0;
+		size_t faceCount = 0;
+		for (const char* cursor = begin; cursor < end;)
+		{
+			std::string_view line = NextLine(cursor, end);
+			std::string_view identifier = NextToken(line);
+			if (identifier == "v") { ++positionCount; }
+			else if (identifier == "vt") { ++texcoordCount; }
+			else if (identifier == "vn") { ++normalCount; }
+			else if (identifier == "f") { ++faceCount; }
+		}
+		chunk->positions.reserve(positionCount);
+		chunk->texcoords.reserve(texcoordCount);
+		chunk->normals.reserve(normalCount);
+		chunk->faceVertices.reserve(faceCount * 3);
+		chunk->faceDefinedCounts.reserve(faceCount);
+
+		for (const char* cursor = begin; cursor < end;)
+		{
+			std::string_view line = NextLine(cursor, end);
+			std::string_view identifier = NextToken(line);
+
+			if (identifier == "v")
+			{
+				Vector4 position;
+				position.x = NextFloat(line);
+				position.y = NextFloat(line);
+				position.z = NextFloat(line);
+				position.w = 1.0f;
+				chunk->positions.push_back(position);
+			}
+			else if (identifier == "vt")
+			{
+				Vector2 texcoord;
+				texcoord.x = NextFloat(line);
+				texcoord.y = NextFloat(line);
+				chunk->texcoords.push_back(texcoord);
+			}
+			else if (identifier == "vn")
+			{
+				Vector3 normal;
+				normal.x = NextFloat(line);
+				normal.y = NextFloat(line);
+				normal.z = NextFloat(line);
+				chunk->normals.push_back(normal);
+			}
+			else if (identifier == "f")
+			{
+				//面は三角形限定
+				chunk->faceDefinedCounts.push_back({ { chunk->positions.size(), chunk->texcoords.size(), chunk->normals.size() } });
+				for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex)
+				{
+					FaceVertexDefinition definition{};
+					if (!ParseFaceVertex(NextToken(line), definition))
+					{
+						chunk->isInvalid = true;
+					}
+					chunk->faceVertices.push_back(definition);
+				}
+			}
+			else if (identifier == "usemtl")
+			{
+				chunk->materialChanges.push_back({ static_cast<uint32_t>(chunk->faceVertices.size() / 3), NextToken(line) });
+			}
+			else if (identifier == "mtllib")
+			{
+				chunk->materialFilenames.push_back(NextToken(line));
+			}
+		}
+	}
+
+	// ファイルを改行位置で区切って複数のスレッドで読む(結果は1スレッドで読んだ時と同じになる。面の頂点定義が不正ならfalse)
+	bool ParseObjParallel(const std::string& directoryPath, const std::string& text, uint32_t threadCount, ModelData& outModelData)
+	{
+		//＝＝＝1.改行位置で区間に分ける＝＝＝
+		const char* begin = text.data();
+		const char* end = begin + text.size();
+		std::vector<const char*> boundaries(threadCount + 1);
+		boundaries[0] = begin;
+		boundaries[threadCount] = end;
+		for (uint32_t i = 1; i < threadCount; ++i)
+		{
+			const char* cursor = (std::max)(begin + text.size() * i / threadCount, boundaries[i - 1]);
+			const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+			boundaries[i] = lineEnd == nullptr ? end : lineEnd + 1;
+		}
+
+		//＝＝＝2.区間ごとに並列に読む＝＝＝
+		std::vector<ObjChunk> chunks(threadCount);
+		{
+			std::vector<std::thread> workers;
+			workers.reserve(threadCount);
+			for (uint32_t i = 0; i < threadCount; ++i)
+			{
+				workers.emplace_back(ParseObjChunk, boundaries[i], boundaries[i + 1], &chunks[i]);
+			}
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		//＝＝＝3.区間ごとの要素数の累積和から書き込み先を決めて、並列にまとめる(面の頂点定義のIndexもここで通し番号にする)＝＝＝
+		std::vector<size_t> positionOffsets(threadCount + 1, 0);
+		std::vector<size_t> texcoordOffsets(threadCount + 1, 0);
+		std::vector<size_t> normalOffsets(threadCount + 1, 0);
+		std::vector<size_t> faceVertexOffsets(threadCount + 1, 0);
+		for (uint32_t i = 0; i < threadCount; ++i)
+		{
+			positionOffsets[i + 1] = positionOffsets[i] + chunks[i].positions.size();
+			texcoordOffsets[i + 1] = texcoordOffsets[i] + chunks[i].texcoords.size();
+			normalOffsets[i + 1] = normalOffsets[i] + chunks[i].normals.size();
+			faceVertexOffsets[i + 1] = faceVertexOffsets[i] + chunks[i].faceVertices.size();
+		}
+		std::vector<Vector4> positions(positionOffsets[threadCount]);
+		std::vector<Vector2> texcoords(texcoordOffsets[threadCount]);
+		std::vector<Vector3> normals(normalOffsets[threadCount]);
+		std::vector<FaceVertexKey> faceVertices(faceVertexOffsets[threadCount]);
+		const ElementCounts totalCounts{ { positions.size(), texcoords.size(), normals.size() } };
+		std::vector<uint8_t> isChunkValid(threadCount, 0);
+		{
+			std::vector<std::thread> workers;
+			workers.reserve(threadCount);
+			for (uint32_t i = 0; i < threadCount; ++i)
+			{
+				workers.emplace_back([&, i]() {
+					std::copy(chunks[i].positions.begin(), chunks[i].positions.end(), positions.begin() + positionOffsets[i]);
+					std::copy(chunks[i].texcoords.begin(), chunks[i].texcoords.end(), texcoords.begin() + texcoordOffsets[i]);
+					std::copy(chunks[i].normals.begin(), chunks[i].normals.end(), normals.begin() + normalOffsets[i]);
+					bool isValid = !chunks[i].isInvalid;
+					for (size_t face = 0; isValid && face < chunks[i].faceDefinedCounts.size(); ++face)
+					{
+						//区間の前までの要素数を足して、ファイル全体でその行までに定義された数にする
+						const ElementCounts& localCounts = chunks[i].faceDefinedCounts[face];
+						const ElementCounts definedCounts{ { positionOffsets[i] + localCounts.counts[0], texcoordOffsets[i] + localCounts.counts[1], normalOffsets[i] + localCounts.counts[2] } };
+						for (size_t faceVertex = 0; isValid && faceVertex < 3; ++faceVertex)
+						{
+							isValid = ResolveFaceVertex(chunks[i].faceVertices[face * 3 + faceVertex], definedCounts, totalCounts, faceVertices[faceVertexOffsets[i] + face * 3 + faceVertex]);
+						}
+					}
+					isChunkValid[i] = isValid ? 1 : 0;
+					});
+			}
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		if (std::find(isChunkValid.begin(), isChunkValid.end(), 0) != isChunkValid.end())
+		{
+			return false;
+		}
+
+		//＝＝＝4.ファイル順に頂点をまとめてIndexを作る(登録順を1スレッドの時と揃えるため、ここは順番に行う)＝＝＝
+		ModelData modelData;
+		modelData.indices.reserve(faceVertices.size());
+		modelData.vertices.reserve(faceVertices.size());
+		std::unordered_map<FaceVertexKey, uint32_t, FaceVertexKeyHash> vertexIndices;
+		vertexIndices.reserve(faceVertices.size());
+		for (size_t face = 0; face + 3 <= faceVertices.size(); face += 3)
+		{
+			uint32_t triangle[3];
+			for (size_t faceVertex = 0; faceVertex < 3; ++faceVertex)
+			{
+				triangle[faceVertex] = AddFaceVertex(faceVertices[face + faceVertex], positions, texcoords, normals, vertexIndices, modelData);
+			}
+			//頂点を逆順で登録することで、回り順を逆にする
+			modelData.indices.push_back(triangle[2]);
+			modelData.indices.push_back(triangle[1]);
+			modelData.indices.push_back(triangle[0]);
+		}
+		modelData.vertices.shrink_to_fit();
+
+		//＝＝＝5.mtlファイルを読み、マテリアルごとにまとめる＝＝＝
+		std::vector<MaterialChange> materialChanges;
+		for (uint32_t i = 0; i < threadCount; ++i)
+		{
+			for (std::string_view materialFilename : chunks[i].materialFilenames)
+			{
+				std::vector<MaterialData> materials = ModelLoader::LoadMaterialTemplateFile(directoryPath, std::string(materialFilename));
+				modelData.materials.insert(modelData.materials.end(), materials.begin(), materials.end());
+				modelData.materialLibraryPaths.push_back(directoryPath + "/" + std::string(materialFilename));
+			}
+			const uint32_t faceOffset = static_cast<uint32_t>(faceVertexOffsets[i] / 3);
+			for (const MaterialChange& change : chunks[i].materialChanges)
+			{
+				materialChanges.push_back({ faceOffset + change.faceIndex, change.name });
+			}
+		}
+		BuildSubmeshes(modelData, materialChanges);
+		outModelData = std::move(modelData);
+		return true;
+	}
+
+	//objを読んでLODを作って最適化し、変換済みファイルを書き出す(書き出せなくても読み込んだものは返す)
+	ModelData CookModel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount, const std::string& cookedPath)
+	{
+		const std::string sourcePath = directoryPath + "/" + filename;
+		ModelData modelData = ModelLoader::LoadObjFile(directoryPath, filename, threadCount);
+		//読めなかったものは書き出さない(次回も読み直して、直っていれば使う)
+		if (modelData.indices.empty())
+		{
+			return modelData;
+		}
+		//詳細度(LOD)を作ってから、LODの範囲も含めて最適化する
+		uint32_t lodCount = MeshLod::GenerateLods(modelData);
+		Logger::Log("Generated " + std::to_string(lodCount) + " LODs for " + sourcePath + "\n");
+		//三角形と頂点の並びを最適化してから書き出す(変換済みファイルは最適化済みになる)
+		MeshOptimizer::Report report = MeshOptimizer::Optimize(modelData);
+		Logger::Log("Optimized " + sourcePath + ": " + MeshOptimizer::FormatReport(report) + "\n");
+		CookedMesh::Cook(modelData, sourcePath, cookedPath);
+		return modelData;
+	}
+}
+
+//ModelData構造体と読み込み関数
+ModelData ModelLoader::LoadObjFile(const std::string& directoryPath, const std::string& filename, uint32_t threadCount)
+{
+	//ファイルをまとめて読み込む
+	const std::string text = ReadFile(directoryPath + "/" + filename);
+
+	if (threadCount == 0)
+	{
+		threadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+	}
+	//区間が小さすぎるとスレッドを立てる方が遅いので、1スレッドあたり一定以上の大きさにする
+	threadCount = (std::min)(threadCount, static_cast<uint32_t>(text.size() / kMinChunkSize));
+	ModelData modelData;
+	const bool isValid = threadCount <= 1 ? ParseObjSerial(directoryPath, text, modelData) : ParseObjParallel(directoryPath, text, threadCount, modelData);
+	if (!isValid)
+	{
+		//範囲外のIndexを読まないように、途中まで読んだものは捨てて空のモデルにする
+		Logger::Log("Invalid face in " + directoryPath + "/" + filename + ": index out of range or malformed vertex definition\n");
+		return {};
+	}
+	return modelData;
+}
+
+//変換済みファイルを優先して読み込む
+ModelData ModelLoader::LoadModel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount)
+{
+	const std::string sourcePath = directoryPath + "/" + filename;
+	const std::string cookedPath = CookedMesh::GetCookedPath(sourcePath);
+
+	//変換済みファイルが使えれば、解析せずにそのままコピーする
+	MappedFile cookedFile;
+	CookedMesh::MeshView view{};
+	if (cookedFile.Open(cookedPath) && CookedMesh::Map(cookedFile, sourcePath, &view))
+	{
+		return CookedMesh::ToModelData(view);
+	}
+	cookedFile.Close();
+
+	//無いか古いのでテキストから読み込んで、次回のために書き出しておく
+	return CookModel(directoryPath, filename, threadCount, cookedPath);
+}
+
+//変換済みファイルをマップする
+bool ModelLoader::MapModel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount, MappedFile& outFile, CookedMesh::MeshView* outView, ModelData* outModelData)
+{
+	const std::string sourcePath = directoryPath + "/" + filename;
+	const std::string cookedPath = CookedMesh::GetCookedPath(sourcePath);
+	if (outFile.Open(cookedPath) && CookedMesh::Map(outFile, sourcePath, outView))
+	{
+		return true;
+	}
+	outFile.Close();
+
+	//無いか古いので作り直して、書き出したものをマップする
+	ModelData modelData = CookModel(directoryPath, filename, threadCount, cookedPath);
+	if (outFile.Open(cookedPath) && CookedMesh::Map(outFile, sourcePath, outView))
+	{
+		return true;
+	}
+	outFile.Close();
+
+	//書き出せなかった(読み取り専用など)ので、読み込んだものを渡す
+	*outModelData = std::move(modelData);
+	return false;
+}
+
+//頂点を圧縮した形式で読み込む
+CompactModelData ModelLoader::LoadCompactModel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount)
+{
+	ModelData modelData = LoadModel(directoryPath, filename, threadCount);
+	CompactModelData compactModelData = VertexCompression::Compress(modelData);
+	//圧縮による誤差を確認できるようにしておく
+	CompressionError error = VertexCompression::MeasureError(modelData, compactModelData);
+	char message[256];
+	std::snprintf(message, sizeof(message), "Compressed %s/%s: position %.6f, texcoord %.6f, normal %.6f rad\n",
+		directoryPath.c_str(), filename.c_str(), error.maxPositionError, error.maxTexcoordError, error.maxNormalAngleError);
+	Logger::Log(message);
+	return compactModelData;
+}
+
+//Indexバッファの1要素のサイズ
+uint32_t ModelLoader::GetIndexStride(const ModelData& modelData)
+{
+	return modelData.vertices.size() <= 0xFFFF ? static_cast<uint32_t>(sizeof(uint16_t)) : static_cast<uint32_t>(sizeof(uint32_t));
+}
+
+//Indexバッファの大きさ
+size_t ModelLoader::GetIndexBufferSize(const ModelData& modelData)
+{
+	return GetIndexStride(modelData) * modelData.indices.size();
+}
+
+//Indexを書き込む
+void ModelLoader::WriteIndices(const ModelData& modelData, void* destination)
+{
+	if (GetIndexStride(modelData) == sizeof(uint32_t))
+	{
+		std::memcpy(destination, modelData.indices.data(), modelData.indices.size() * sizeof(uint32_t));
+		return;
+	}
+
+	//16bitに詰める
+	uint16_t* indices16 = static_cast<uint16_t*>(destination);
+	for (size_t i = 0; i < modelData.indices.size(); ++i)
+	{
+		indices16[i] = static_cast<uint16_t>(modelData.indices[i]);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "MyMath.h"
+#include "CookedMesh.h"
+#include "MappedFile.h"
+#include "VertexCompression.h"
+
+#include <cstdint>
+#include <string>
+
+//モデル読み込み(DirectX12に依存しないので単体で計測・確認できる)
+namespace ModelLoader
+{
+	//mtlファイルを読み込む(newmtlごとに1つ)
+	std::vector<MaterialData> LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename);
+	/// <summary>
+	/// objファイルを読み込む(同じ頂点はまとめて、Index付きで返す。三角形はusemtlのマテリアルごとにまとめて並べる)
+	/// 面の頂点定義は"v/vt/vn"・"v//vn"・"v"と負の相対Indexを読む(省略したテクスチャ座標と法線は0)。範囲外のIndexがあればログを出して空のモデルを返す
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリ</param>
+	/// <param name="filename">ファイル名</param>
+	/// <param name="threadCount">読み込むスレッド数(0なら論理コア数。ファイルが小さければ減らす)。結果はスレッド数によらず同じ</param>
+	ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename, uint32_t threadCount = 1);
+
+	//変換済みファイル(*.obj.mesh)があればそれを読み込み、無いか古ければobjを読んでLODを作って最適化し、変換済みファイルを書き出す
+	ModelData LoadModel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount = 1);
+
+	/// <summary>
+	/// 変換済みファイル(*.obj.mesh)をマップする(無いか古ければLoadModelと同じように作ってから)。頂点とIndexをコピーせずにGPUへ転送するときに使う
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリ</param>
+	/// <param name="filename">objファイル名</param>
+	/// <param name="threadCount">objを読み込むスレッド数</param>
+	/// <param name="outFile">マップしたファイル(outViewを使い終わるまで閉じない)</param>
+	/// <param name="outView">ファイルの中身を指すもの</param>
+	/// <param name="outModelData">変換済みファイルを書き出せなかったときに、読み込んだものを入れる</param>
+	/// <returns>マップできたか(falseならoutModelDataを使う)</returns>
+	bool MapModel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount, MappedFile& outFile, CookedMesh::MeshView* outView, ModelData* outModelData);
+
+	//LoadModelで読み込んで、頂点を圧縮した形式(CompactVertexData)で返す
+	CompactModelData LoadCompactModel(const std::string& directoryPath, const std::string& filename, uint32_t threadCount = 1);
+
+	//Indexバッファの1要素のサイズ(頂点数が65536未満なら16bit、それ以上なら32bit)
+	uint32_t GetIndexStride(const ModelData& modelData);
+	//Indexバッファの大きさ(バイト)
+	size_t GetIndexBufferSize(const ModelData& modelData);
+	//GetIndexStrideで決めた形式でIndexを書き込む(書き込み先はGetIndexBufferSizeバイト必要)
+	void WriteIndices(const ModelData& modelData, void* destination);
+}
@@ -0,0 +1,227 @@
+#include "ModelManager.h"
+#include "DirectXBase.h"
+#include "TextureManager.h"
+#include "ModelLoader.h"
+#include "CookedMesh.h"
+#include "MappedFile.h"
+#include "MeshLod.h"
+#include "WindowsAPI.h"
+
+#include <cassert>
+#include <cstring>
+
+ModelManager* ModelManager::instance = nullptr;
+
+ModelManager* ModelManager::GetInstance()
+{
+	if (instance == nullptr)
+	{
+		instance = new ModelManager;
+	}
+	return instance;
+}
+
+void ModelManager::Initialize(DirectXBase* dxBase)
+{
+	this->dxBase = dxBase;
+}
+
+//モデルの読み込み
+ModelHandle ModelManager::LoadModel(const std::string& directoryPath, const std::string& filename)
+{
+	const std::string filePath = directoryPath + "/" + filename;
+
+	//読み込み済みなら参照数を増やして早期return
+	auto it = modelIndices.find(filePath);
+	if (it != modelIndices.end())
+	{
+		ModelResource& model = models[it->second];
+		++model.referenceCount;
+		return { it->second, model.generation };
+	}
+
+	//＝＝＝1.変換済みファイルをマップする(無ければ作る)＝＝＝
+	MappedFile cookedFile;
+	CookedMesh::MeshView view{};
+	ModelData modelData;
+	const bool isMapped = ModelLoader::MapModel(directoryPath, filename, 0, cookedFile, &view, &modelData);
+	assert(isMapped ? (!view.vertices.empty() && view.indexCount != 0) : (!modelData.vertices.empty() && !modelData.indices.empty()));
+
+	//解放した番号があれば使い回す
+	uint32_t modelIndex = 0;
+	if (!freeIndices.empty())
+	{
+		modelIndex = freeIndices.back();
+		freeIndices.pop_back();
+	}
+	else
+	{
+		modelIndex = static_cast<uint32_t>(models.size());
+		models.resize(models.size() + 1);
+	}
+	ModelResource& model = models[modelIndex];
+	model.filePath = filePath;
+	model.referenceCount = 1;
+
+	//＝＝＝2.VertexResourceとIndexResourceを作って書き込む＝＝＝
+	if (isMapped)
+	{
+		//マップしたファイルから、保存されている形式(16bit/32bitのIndex)のままコピーする
+		model.boundingSphere = Culling::ComputeBoundingSphere(view.vertices);
+		CreateMeshBuffers(model, view.vertices, view.indices, view.indexCount, view.indexStride);
+		//描画範囲とマテリアルだけ残す
+		modelData = CookedMesh::CopyDrawRanges(view);
+		cookedFile.Close();
+	}
+	else
+	{
+		//変換済みファイルを書き出せなかったので、読み込んだものを頂点数に合わせた形式にして転送する
+		model.boundingSphere = Culling::ComputeBoundingSphere(modelData.vertices);
+		std::vector<uint8_t> indices(ModelLoader::GetIndexBufferSize(modelData));
+		ModelLoader::WriteIndices(modelData, indices.data());
+		CreateMeshBuffers(model, modelData.vertices, indices.data(), static_cast<uint32_t>(modelData.indices.size()), ModelLoader::GetIndexStride(modelData));
+		//GPUに転送した頂点とIndexは捨てて、描画範囲とマテリアルだけ残す
+		modelData.vertices = {};
+		modelData.indices = {};
+	}
+
+	//＝＝＝3.マテリアルのテクスチャを読み込む(読み込み済みならTextureManagerがそのまま返す)＝＝＝
+	model.textureHandles.clear();
+	TextureManager::GetInstance()->BeginBatch();
+	for (const MaterialData& material : modelData.materials)
+	{
+		model.textureHandles.push_back(material.textureFilePath.empty() ? TextureHandle{} : TextureManager::GetInstance()->LoadTexture(material.textureFilePath));
+	}
+	TextureManager::GetInstance()->EndBatch();
+
+	model.modelData = std::move(modelData);
+
+	modelIndices.emplace(filePath, modelIndex);
+	return { modelIndex, model.generation };
+}
+
+//頂点とIndexのバッファを作って書き込む
+void ModelManager::CreateMeshBuffers(ModelResource& model, std::span<const VertexData> vertices, const void* indices, uint32_t indexCount, uint32_t indexStride)
+{
+	const size_t vertexBufferSize = vertices.size_bytes();
+	model.vertexBuffer = dxBase->CreateBufferResource(vertexBufferSize);
+	void* vertexData = nullptr;
+	model.vertexBuffer->Map(0, nullptr, &vertexData);
+	std::memcpy(vertexData, vertices.data(), vertexBufferSize);
+	model.vertexBuffer->Unmap(0, nullptr);
+
+	model.vertexBufferView.BufferLocation = model.vertexBuffer->GetGPUVirtualAddress();
+	model.vertexBufferView.SizeInBytes = static_cast<UINT>(vertexBufferSize);
+	model.vertexBufferView.StrideInBytes = sizeof(VertexData);
+
+	const size_t indexBufferSize = static_cast<size_t>(indexCount) * indexStride;
+	model.indexBuffer = dxBase->CreateBufferResource(indexBufferSize);
+	void* indexData = nullptr;
+	model.indexBuffer->Map(0, nullptr, &indexData);
+	std::memcpy(indexData, indices, indexBufferSize);
+	model.indexBuffer->Unmap(0, nullptr);
+
+	model.indexBufferView.BufferLocation = model.indexBuffer->GetGPUVirtualAddress();
+	model.indexBufferView.SizeInBytes = static_cast<UINT>(indexBufferSize);
+	model.indexBufferView.Format = indexStride == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+}
+
+//参照を増やす
+void ModelManager::AddReference(ModelHandle handle)
+{
+	++GetModel(handle).referenceCount;
+}
+
+//参照を返す
+void ModelManager::ReleaseModel(ModelHandle handle)
+{
+	ModelResource& model = GetModel(handle);
+	if (--model.referenceCount != 0)
+	{
+		return;
+	}
+
+	//誰も使っていないので解放して、番号を次の読み込みに回す
+	modelIndices.erase(model.filePath);
+	model.filePath.clear();
+	model.modelData = {};
+	model.textureHandles.clear();
+	model.vertexBuffer.Reset();
+	model.indexBuffer.Reset();
+	//古いハンドルで触れないように世代を進める
+	++model.generation;
+	freeIndices.push_back(handle.index);
+}
+
+//描画
+void ModelManager::DrawModel(ModelHandle handle, uint32_t lod, uint32_t instanceCount)
+{
+	ModelResource& model = GetModel(handle);
+	ID3D12GraphicsCommandList* commandList = dxBase->GetCommandList();
+
+	//VertexBufferViewとIndexBufferViewは全ての描画範囲で共通
+	commandList->IASetVertexBuffers(0, 1, &model.vertexBufferView);
+	commandList->IASetIndexBuffer(&model.indexBufferView);
+
+	//描画範囲はマテリアルごとに1つにまとめてあるので、テクスチャの設定も1回ずつで済む
+	TextureHandle boundTextureHandle{};
+	for (const SubmeshData& submesh : MeshLod::GetSubmeshes(model.modelData, lod))
+	{
+		TextureHandle textureHandle = submesh.materialIndex < model.textureHandles.size() ? model.textureHandles[submesh.materialIndex] : TextureHandle{};
+		//テクスチャの無いマテリアルは白いテクスチャで描く(前の描画範囲のテクスチャを引き継がない)
+		if (!textureHandle.IsValid())
+		{
+			textureHandle = TextureManager::GetInstance()->GetDefaultTextureHandle();
+		}
+		if (textureHandle != boundTextureHandle)
+		{
+			commandList->SetGraphicsRootDescriptorTable(kTextureRootParameterIndex, TextureManager::GetInstance()->GetSrvHandleGPU(textureHandle));
+			boundTextureHandle = textureHandle;
+		}
+		commandList->DrawIndexedInstanced(submesh.indexCount, instanceCount, submesh.indexOffset, 0, 0);
+	}
+}
+
+//画面上の大きさから詳細度を選んで描画
+uint32_t ModelManager::DrawModel(ModelHandle handle, const Matrix4x4& worldMatrix, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, uint32_t instanceCount)
+{
+	const ModelResource& model = GetModel(handle);
+	uint32_t lod = MeshLod::SelectObjectLod(model.modelData.lods, model.boundingSphere, worldMatrix, viewMatrix, projectionMatrix, float(WindowsAPI::kClientHeight));
+	DrawModel(handle, lod, instanceCount);
+	return lod;
+}
+
+//参照数
+uint32_t ModelManager::GetReferenceCount(ModelHandle handle)
+{
+	return GetModel(handle).referenceCount;
+}
+
+//バウンディングスフィア
+const Sphere& ModelManager::GetBoundingSphere(ModelHandle handle)
+{
+	return GetModel(handle).boundingSphere;
+}
+
+//詳細度ごとの描画範囲
+std::span<const LodData> ModelManager::GetLods(ModelHandle handle)
+{
+	return GetModel(handle).modelData.lods;
+}
+
+void ModelManager::Finalize()
+{
+	delete instance;
+	instance = nullptr;
+}
+
+//ハンドルが指すモデル
+ModelManager::ModelResource& ModelManager::GetModel(ModelHandle handle)
+{
+	//範囲外指定違反チェック
+	assert(handle.index < models.size());
+	ModelResource& model = models[handle.index];
+	//解放済みのモデルを指していないか
+	assert(model.generation == handle.generation && model.referenceCount != 0);
+	return model;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <wrl.h>
+#include <d3d12.h>
+#include "DirectXBase.h"
+#include "TextureManager.h"
+#include "MyMath.h"
+#include "Culling.h"
+
+class DirectXBase;
+
+//モデルの参照(LoadModelで受け取り、使い終わったらReleaseModelで返す)
+struct ModelHandle
+{
+	uint32_t index = UINT32_MAX;
+	//同じ番号が別のモデルに使い回されたときに、古いハンドルを見分けるための世代
+	uint32_t generation = 0;
+
+	bool IsValid() const { return index != UINT32_MAX; }
+};
+
+class ModelManager
+{
+public:
+	//シングルインスタンスの取得
+	static ModelManager* GetInstance();
+
+	//初期化
+	void Initialize(DirectXBase* dxBase);
+
+	/// <summary>
+	/// モデルの読み込み(読み込み済みなら参照数を増やしてすぐ返す)
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリ</param>
+	/// <param name="filename">objファイル名</param>
+	ModelHandle LoadModel(const std::string& directoryPath, const std::string& filename);
+
+	//参照を増やす(ハンドルをコピーして別々に持つとき)
+	void AddReference(ModelHandle handle);
+
+	//参照を返す。0になったらGPUのバッファを解放する(コマンドを積んでいる間(PreDraw～PostDraw)には呼ばない)
+	void ReleaseModel(ModelHandle handle);
+
+	/// <summary>
+	/// 描画(パイプラインとマテリアル・座標変換のCBVは呼び出し側で設定しておく)
+	/// </summary>
+	/// <param name="handle">モデル</param>
+	/// <param name="lod">詳細度(MeshLod::SelectLodで選ぶ)</param>
+	/// <param name="instanceCount">インスタンス数</param>
+	void DrawModel(ModelHandle handle, uint32_t lod = 0, uint32_t instanceCount = 1);
+
+	/// <summary>
+	/// 描画(詳細度は画面上の大きさからMeshLod::SelectObjectLodで選ぶ)
+	/// </summary>
+	/// <param name="handle">モデル</param>
+	/// <param name="worldMatrix">物体のワールド行列</param>
+	/// <param name="viewMatrix">ビュー行列</param>
+	/// <param name="projectionMatrix">射影行列</param>
+	/// <param name="instanceCount">インスタンス数(全てのインスタンスが同じ段で描かれる)</param>
+	/// <returns>選んだ詳細度</returns>
+	uint32_t DrawModel(ModelHandle handle, const Matrix4x4& worldMatrix, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, uint32_t instanceCount = 1);
+
+	//参照数(確認用)
+	uint32_t GetReferenceCount(ModelHandle handle);
+
+	//モデルのバウンディングスフィア(ローカル座標。カリングとLODの選択に使う)
+	const Sphere& GetBoundingSphere(ModelHandle handle);
+
+	//詳細度ごとの描画範囲
+	std::span<const LodData> GetLods(ModelHandle handle);
+
+	//終了
+	void Finalize();
+
+private:
+	//シングルトン
+	static ModelManager* instance;
+
+	//ルートパラメータのテクスチャの番号(SpriteBaseと同じ並び)
+	static const uint32_t kTextureRootParameterIndex = 2;
+
+	//モデル1つ分のデータ
+	struct ModelResource {
+		std::string filePath;
+		uint32_t referenceCount = 0;
+		uint32_t generation = 0;
+		//描画範囲とマテリアル(頂点とIndexはGPUに転送したら捨てる)
+		ModelData modelData;
+		//マテリアルごとのテクスチャ(テクスチャが無ければ無効なハンドル)
+		std::vector<TextureHandle> textureHandles;
+		Sphere boundingSphere{};
+		Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer = nullptr;
+		Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer = nullptr;
+		D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+		D3D12_INDEX_BUFFER_VIEW indexBufferView{};
+	};
+
+	ModelManager() = default;
+	~ModelManager() = default;
+	ModelManager(const ModelManager&) = delete;
+	ModelManager& operator=(const ModelManager&) = delete;
+
+	//頂点とIndexのバッファを作って書き込む(IndexはindexStrideバイトずつ並んだものをそのままコピーする)
+	void CreateMeshBuffers(ModelResource& model, std::span<const VertexData> vertices, const void* indices, uint32_t indexCount, uint32_t indexStride);
+
+	//ハンドルが指すモデル(解放済みならassert)
+	ModelResource& GetModel(ModelHandle handle);
+
+	//モデルデータ(解放した番号は次の読み込みで使い回す)
+	std::vector<ModelResource> models;
+	std::vector<uint32_t> freeIndices;
+	//ファイルパスからモデルの番号を引く
+	std::unordered_map<std::string, uint32_t> modelIndices;
+
+	DirectXBase* dxBase = nullptr;
+};
@@ -1,20 +1,163 @@
 #include "MyMath.h"
+#include "MathUtility.h"
+#include "SinCos.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+//SIMD命令セットはコンパイル時に選択する(AVX2 > SSE2 > スカラー。MYMATH_FORCE_SCALARを定義するとスカラー版になる。計測の比較用)
+#if defined(MYMATH_FORCE_SCALAR)
+#elif defined(__AVX2__)
+#define MYMATH_USE_AVX2
+#define MYMATH_USE_SSE2
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MYMATH_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef MYMATH_USE_SSE2
+namespace
+{
+	// 行列をストリーミングストアで書き込む
+	inline void StoreMatrix(Matrix4x4& dst, const Matrix4x4& src)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			_mm_stream_ps(dst.m[row], _mm_load_ps(src.m[row]));
+		}
+	}
+
+	// 1行分の掛け算 row * m2 (加算順はスカラー版と同じなので結果はビット単位で一致する。FMAにまとめられると一致しないので、GCC/Clangは-ffp-contract=offでビルドする)
+	inline __m128 MultiplyRowSSE(const float* row, __m128 b0, __m128 b1, __m128 b2, __m128 b3)
+	{
+		__m128 result = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+		return result;
+	}
+
+	// 2x2行列(行優先で1レジスタに格納)の掛け算 A*B
+	inline __m128 Mat2Mul(__m128 a, __m128 b)
+	{
+		return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	// 2x2行列の余因子行列との掛け算 adj(A)*B
+	inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+
+	// 2x2行列と余因子行列の掛け算 A*adj(B)
+	inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	// 逆行列(2x2ブロック分解による)
+	// スカラー版とは演算順が異なるため結果は許容誤差内で一致する
+	Matrix4x4 InverseSSE(const Matrix4x4& m)
+	{
+		const __m128 row0 = _mm_load_ps(m.m[0]);
+		const __m128 row1 = _mm_load_ps(m.m[1]);
+		const __m128 row2 = _mm_load_ps(m.m[2]);
+		const __m128 row3 = _mm_load_ps(m.m[3]);
+
+		//| A B |
+		//| C D |
+		const __m128 a = _mm_movelh_ps(row0, row1);
+		const __m128 b = _mm_movehl_ps(row1, row0);
+		const __m128 c = _mm_movelh_ps(row2, row3);
+		const __m128 d = _mm_movehl_ps(row3, row2);
+
+		// (|A| |B| |C| |D|)
+		const __m128 detSub = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1))),
+			_mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0))));
+		const __m128 detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+		const __m128 dc = Mat2AdjMul(d, c);
+		const __m128 ab = Mat2AdjMul(a, b);
+		__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+		// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+		__m128 tr = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)));
+		tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(2, 3, 0, 1)));
+		tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 0, 3, 2)));
+		__m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+		detM = _mm_sub_ps(detM, tr);
+
+		// (1/|M|, -1/|M|, -1/|M|, 1/|M|)
+		const __m128 recpDeterminant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+		x = _mm_mul_ps(x, recpDeterminant);
+		y = _mm_mul_ps(y, recpDeterminant);
+		z = _mm_mul_ps(z, recpDeterminant);
+		w = _mm_mul_ps(w, recpDeterminant);
+
+		Matrix4x4 result;
+		_mm_store_ps(result.m[0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_store_ps(result.m[1], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+		_mm_store_ps(result.m[2], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_store_ps(result.m[3], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+		return result;
+	}
+}
+#endif
 
 // 単位行列
 Matrix4x4 MyMath::MakeIdentity4x4()
 {
-	Matrix4x4 identity{};
-	identity.m[0][0] = 1.0f;	identity.m[0][1] = 0.0f;	identity.m[0][2] = 0.0f;	identity.m[0][3] = 0.0f;
-	identity.m[1][0] = 0.0f;	identity.m[1][1] = 1.0f;	identity.m[1][2] = 0.0f;	identity.m[1][3] = 0.0f;
-	identity.m[2][0] = 0.0f;	identity.m[2][1] = 0.0f;	identity.m[2][2] = 1.0f;	identity.m[2][3] = 0.0f;
-	identity.m[3][0] = 0.0f;	identity.m[3][1] = 0.0f;	identity.m[3][2] = 0.0f;	identity.m[3][3] = 1.0f;
-	
-	return identity;
+	return MathUtility::MakeIdentity4x4();
 }
 
 // 4x4の掛け算
 Matrix4x4 MyMath::Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
 {
+#if defined(MYMATH_USE_AVX2)
+	//m2の各行を上下のレーンに複製しておく
+	const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[0]));
+	const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[1]));
+	const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[2]));
+	const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[3]));
+
+	Matrix4x4 result;
+	//2行ずつ計算する(加算順はSSE2版・スカラー版と同じ)
+	for (int row = 0; row < 4; row += 2)
+	{
+		const __m256 a = _mm256_loadu_ps(m1.m[row]);
+		__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+		_mm256_storeu_ps(result.m[row], r);
+	}
+	return result;
+#elif defined(MYMATH_USE_SSE2)
+	const __m128 b0 = _mm_load_ps(m2.m[0]);
+	const __m128 b1 = _mm_load_ps(m2.m[1]);
+	const __m128 b2 = _mm_load_ps(m2.m[2]);
+	const __m128 b3 = _mm_load_ps(m2.m[3]);
+
+	Matrix4x4 result;
+	_mm_store_ps(result.m[0], MultiplyRowSSE(m1.m[0], b0, b1, b2, b3));
+	_mm_store_ps(result.m[1], MultiplyRowSSE(m1.m[1], b0, b1, b2, b3));
+	_mm_store_ps(result.m[2], MultiplyRowSSE(m1.m[2], b0, b1, b2, b3));
+	_mm_store_ps(result.m[3], MultiplyRowSSE(m1.m[3], b0, b1, b2, b3));
+	return result;
+#else
 	Matrix4x4 result{};
 	
 	result.m[0][0] = m1.m[0][0] * m2.m[0][0] + m1.m[0][1] * m2.m[1][0] + m1.m[0][2] * m2.m[2][0] + m1.m[0][3] * m2.m[3][0];
@@ -38,13 +181,14 @@ Matrix4x4 MyMath::Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
 	result.m[3][3] = m1.m[3][0] * m2.m[0][3] + m1.m[3][1] * m2.m[1][3] + m1.m[3][2] * m2.m[2][3] + m1.m[3][3] * m2.m[3][3];
 
 	return result;
+#endif
 }
 
 // X軸で回転
 Matrix4x4 MyMath::MakeRotateXMatrix(float radian)
 {
-	float cosTheta = std::cos(radian);
-	float sinTheta = std::sin(radian);
+	float sinTheta, cosTheta;
+	MathUtility::SinCos(radian, &sinTheta, &cosTheta);
 	return { 1.0f, 0.0f, 0.0f, 0.0f,
 			0.0f, cosTheta, sinTheta, 0.0f,
 			0.0f, -sinTheta, cosTheta, 0.0f,
@@ -54,8 +198,8 @@ Matrix4x4 MyMath::MakeRotateXMatrix(float radian)
 // Y軸で回転
 Matrix4x4 MyMath::MakeRotateYMatrix(float radian)
 {
-	float cosTheta = std::cos(radian);
-	float sinTheta = std::sin(radian);
+	float sinTheta, cosTheta;
+	MathUtility::SinCos(radian, &sinTheta, &cosTheta);
 	return { cosTheta, 0.0f, -sinTheta, 0.0f,
 			0.0f, 1.0f, 0.0f, 0.0f,
 			sinTheta, 0.0f, cosTheta, 0.0f,
@@ -65,8 +209,8 @@ Matrix4x4 MyMath::MakeRotateYMatrix(float radian)
 // Z軸で回転
 Matrix4x4 MyMath::MakeRotateZMatrix(float radian)
 {
-	float cosTheta = std::cos(radian);
-	float sinTheta = std::sin(radian);
+	float sinTheta, cosTheta;
+	MathUtility::SinCos(radian, &sinTheta, &cosTheta);
 	return { cosTheta, sinTheta, 0.0f, 0.0f,
 			-sinTheta, cosTheta, 0.0f , 0.0f,
 			0.0f, 0.0f, 1.0f, 0.0f,
@@ -76,38 +220,69 @@ Matrix4x4 MyMath::MakeRotateZMatrix(float radian)
 // Affine変換
 Matrix4x4 MyMath::MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate)
 {
-	Matrix4x4 result = Multiply(Multiply(MakeRotateXMatrix(rotate.x), MakeRotateYMatrix(rotate.y)), MakeRotateZMatrix(rotate.z));
-	result.m[0][0] *= scale.x;
-	result.m[0][1] *= scale.x;
-	result.m[0][2] *= scale.x;
+	Vector3 sinRotate, cosRotate;
+	MathUtility::SinCos(&rotate.x, &sinRotate.x, &cosRotate.x, 3);
+	return MathUtility::MakeAffineMatrix(scale, sinRotate, cosRotate, translate);
+}
 
-	result.m[1][0] *= scale.y;
-	result.m[1][1] *= scale.y;
-	result.m[1][2] *= scale.y;
+// World/WVP行列の一括生成
+void MyMath::MakeTransformationMatrices(std::span<const Transform> transforms, const Matrix4x4& viewProjection, std::span<TransformationMatrix> outMatrices)
+{
+	assert(outMatrices.size() >= transforms.size());
 
-	result.m[2][0] *= scale.z;
-	result.m[2][1] *= scale.z;
-	result.m[2][2] *= scale.z;
+	//三角関数はブロック単位でまとめてSIMDで計算する
+	constexpr size_t kBlockSize = 64;
+	float rotateX[kBlockSize], rotateY[kBlockSize], rotateZ[kBlockSize];
+	float sinX[kBlockSize], sinY[kBlockSize], sinZ[kBlockSize];
+	float cosX[kBlockSize], cosY[kBlockSize], cosZ[kBlockSize];
 
-	result.m[3][0] = translate.x;
-	result.m[3][1] = translate.y;
-	result.m[3][2] = translate.z;
-	return result;
+	for (size_t blockStart = 0; blockStart < transforms.size(); blockStart += kBlockSize)
+	{
+		const size_t blockCount = (std::min)(kBlockSize, transforms.size() - blockStart);
+		const Transform* block = transforms.data() + blockStart;
+
+		for (size_t i = 0; i < blockCount; ++i)
+		{
+			rotateX[i] = block[i].rotate.x;
+			rotateY[i] = block[i].rotate.y;
+			rotateZ[i] = block[i].rotate.z;
+		}
+		MathUtility::SinCos(rotateX, sinX, cosX, blockCount);
+		MathUtility::SinCos(rotateY, sinY, cosY, blockCount);
+		MathUtility::SinCos(rotateZ, sinZ, cosZ, blockCount);
+
+		for (size_t i = 0; i < blockCount; ++i)
+		{
+			const Matrix4x4 world = MathUtility::MakeAffineMatrix(block[i].scale, { sinX[i], sinY[i], sinZ[i] }, { cosX[i], cosY[i], cosZ[i] }, block[i].translate);
+			TransformationMatrix& out = outMatrices[blockStart + i];
+#ifdef MYMATH_USE_SSE2
+			//書き込み先はGPUのアップロードヒープ(ライトコンバイン)を想定しているので、キャッシュを汚さないストリーミングストアで書く
+			//(Matrix4x4は16バイト境界に揃っているのでそのまま書き込める)
+			StoreMatrix(out.World, world);
+			StoreMatrix(out.WVP, Multiply(world, viewProjection));
+#else
+			out.World = world;
+			out.WVP = Multiply(world, viewProjection);
+#endif
+		}
+	}
+
+#ifdef MYMATH_USE_SSE2
+	_mm_sfence();
+#endif
 }
 
 Matrix4x4 MyMath::MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip)
 {
 	float cotHalfFovV = 1.0f / std::tan(fovY / 2.0f);
-	return {
-		(cotHalfFovV / aspectRatio), 0.0f, 0.0f, 0.0f,
-		0.0f, cotHalfFovV, 0.0f, 0.0f,
-		0.0f, 0.0f, farClip / (farClip - nearClip), 1.0f,
-		0.0f, 0.0f, -(nearClip * farClip) / (farClip - nearClip), 0.0f
-	};
+	return MathUtility::MakePerspectiveMatrix(cotHalfFovV, aspectRatio, nearClip, farClip);
 }
 
 Matrix4x4 MyMath::Inverse(const Matrix4x4& m)
 {
+#ifdef MYMATH_USE_SSE2
+	return InverseSSE(m);
+#else
 	float determinant = +m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3]
 		+ m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1]
 		+ m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2]
@@ -195,16 +370,219 @@ Matrix4x4 MyMath::Inverse(const Matrix4x4& m)
 		m.m[0][1] * m.m[1][0] * m.m[2][2] - m.m[0][0] * m.m[1][2] * m.m[2][1]) * recpDeterminant;
 
 	return result;
+#endif
 }
 
 //平行投影
 Matrix4x4 MyMath::MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip)
 {
-	return
+	return MathUtility::MakeOrthographicMatrix(left, top, right, bottom, nearClip, farClip);
+}
+
+// 2次元Affine変換(Z軸回転のみ)
+Matrix3x2 MyMath::MakeAffineMatrix2D(const Vector2& scale, float rotate, const Vector2& translate)
+{
+	return MathUtility::MakeAffineMatrix2D(scale, rotate, translate);
+}
+
+// 3x2の掛け算
+Matrix3x2 MyMath::Multiply(const Matrix3x2& m1, const Matrix3x2& m2)
+{
+	return MathUtility::Multiply(m1, m2);
+}
+
+// 2次元の平行投影
+Matrix3x2 MyMath::MakeOrthographicMatrix2D(float left, float top, float right, float bottom)
+{
+	return MathUtility::MakeOrthographicMatrix2D(left, top, right, bottom);
+}
+
+// 3x2を4x4に展開する
+Matrix4x4 MyMath::MakeMatrix4x4(const Matrix3x2& m)
+{
+	return MathUtility::MakeMatrix4x4(m);
+}
+
+// 単位クォータニオン
+Quaternion MyMath::IdentityQuaternion()
+{
+	return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+// クォータニオンの積
+Quaternion MyMath::Multiply(const Quaternion& lhs, const Quaternion& rhs)
+{
+	return MathUtility::Multiply(lhs, rhs);
+}
+
+// 正規化
+Quaternion MyMath::Normalize(const Quaternion& quaternion)
+{
+	float norm = std::sqrt(quaternion.x * quaternion.x + quaternion.y * quaternion.y + quaternion.z * quaternion.z + quaternion.w * quaternion.w);
+	if (norm == 0.0f)
+	{
+		return IdentityQuaternion();
+	}
+	float recpNorm = 1.0f / norm;
+	return { quaternion.x * recpNorm, quaternion.y * recpNorm, quaternion.z * recpNorm, quaternion.w * recpNorm };
+}
+
+// 共役
+Quaternion MyMath::Conjugate(const Quaternion& quaternion)
+{
+	return { -quaternion.x, -quaternion.y, -quaternion.z, quaternion.w };
+}
+
+// 任意軸回転を表すクォータニオン
+Quaternion MyMath::MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle)
+{
+	float sinHalf, cosHalf;
+	MathUtility::SinCos(angle / 2.0f, &sinHalf, &cosHalf);
+	return { axis.x * sinHalf, axis.y * sinHalf, axis.z * sinHalf, cosHalf };
+}
+
+// 球面線形補間
+Quaternion MyMath::Slerp(const Quaternion& q0, const Quaternion& q1, float t)
+{
+	float dot = q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+	//遠回りしないように向きを揃える
+	Quaternion end = q1;
+	if (dot < 0.0f)
+	{
+		end = { -q1.x, -q1.y, -q1.z, -q1.w };
+		dot = -dot;
+	}
+
+	//ほぼ同じ向きなら線形補間で十分(sinθが0に近く割り算が不安定になるため)
+	float scale0 = 1.0f - t;
+	float scale1 = t;
+	if (dot < 0.9995f)
+	{
+		float theta = std::acos(dot);
+		float recpSinTheta = 1.0f / std::sin(theta);
+		scale0 = std::sin((1.0f - t) * theta) * recpSinTheta;
+		scale1 = std::sin(t * theta) * recpSinTheta;
+	}
+
+	return Normalize({
+		scale0 * q0.x + scale1 * end.x,
+		scale0 * q0.y + scale1 * end.y,
+		scale0 * q0.z + scale1 * end.z,
+		scale0 * q0.w + scale1 * end.w });
+}
+
+// クォータニオンでベクトルを回転する
+Vector3 MyMath::RotateVector(const Vector3& vector, const Quaternion& quaternion)
+{
+	//v' = v + 2w(q×v) + 2q×(q×v)
+	Vector3 t = {
+		2.0f * (quaternion.y * vector.z - quaternion.z * vector.y),
+		2.0f * (quaternion.z * vector.x - quaternion.x * vector.z),
+		2.0f * (quaternion.x * vector.y - quaternion.y * vector.x) };
+	return {
+		vector.x + quaternion.w * t.x + (quaternion.y * t.z - quaternion.z * t.y),
+		vector.y + quaternion.w * t.y + (quaternion.z * t.x - quaternion.x * t.z),
+		vector.z + quaternion.w * t.z + (quaternion.x * t.y - quaternion.y * t.x) };
+}
+
+// クォータニオンから回転行列
+Matrix4x4 MyMath::MakeRotateMatrix(const Quaternion& quaternion)
+{
+	return MathUtility::MakeRotateMatrix(quaternion);
+}
+
+// 回転行列からクォータニオン
+Quaternion MyMath::MakeQuaternion(const Matrix4x4& matrix)
+{
+	//各行の長さで割って拡大縮小成分を取り除く
+	float r[3][3];
+	for (int row = 0; row < 3; ++row)
 	{
-		2.0f / (right - left),0.0f,0.0f,0.0f,
-		0.0f,2.0f / (top - bottom),0.0f,0.0f,
-		0.0f,0.0f,1.0f / (farClip - nearClip),0.0f,
-		(left + right) / (left - right),(top + bottom) / (bottom - top),nearClip / (nearClip - farClip),1.0f,
-	};
-}
\ No newline at end of file
+		float length = std::sqrt(matrix.m[row][0] * matrix.m[row][0] + matrix.m[row][1] * matrix.m[row][1] + matrix.m[row][2] * matrix.m[row][2]);
+		float recpLength = length != 0.0f ? 1.0f / length : 0.0f;
+		for (int column = 0; column < 3; ++column)
+		{
+			r[row][column] = matrix.m[row][column] * recpLength;
+		}
+	}
+
+	//対角成分のうち最も大きいものを基準にして精度を保つ
+	Quaternion result{};
+	float trace = r[0][0] + r[1][1] + r[2][2];
+	if (trace > 0.0f)
+	{
+		float s = std::sqrt(trace + 1.0f) * 2.0f;
+		result.w = 0.25f * s;
+		result.x = (r[1][2] - r[2][1]) / s;
+		result.y = (r[2][0] - r[0][2]) / s;
+		result.z = (r[0][1] - r[1][0]) / s;
+	}
+	else if (r[0][0] > r[1][1] && r[0][0] > r[2][2])
+	{
+		float s = std::sqrt(1.0f + r[0][0] - r[1][1] - r[2][2]) * 2.0f;
+		result.w = (r[1][2] - r[2][1]) / s;
+		result.x = 0.25f * s;
+		result.y = (r[1][0] + r[0][1]) / s;
+		result.z = (r[2][0] + r[0][2]) / s;
+	}
+	else if (r[1][1] > r[2][2])
+	{
+		float s = std::sqrt(1.0f + r[1][1] - r[0][0] - r[2][2]) * 2.0f;
+		result.w = (r[2][0] - r[0][2]) / s;
+		result.x = (r[1][0] + r[0][1]) / s;
+		result.y = 0.25f * s;
+		result.z = (r[2][1] + r[1][2]) / s;
+	}
+	else
+	{
+		float s = std::sqrt(1.0f + r[2][2] - r[0][0] - r[1][1]) * 2.0f;
+		result.w = (r[0][1] - r[1][0]) / s;
+		result.x = (r[2][0] + r[0][2]) / s;
+		result.y = (r[2][1] + r[1][2]) / s;
+		result.z = 0.25f * s;
+	}
+	return Normalize(result);
+}
+
+// オイラー角からクォータニオン
+Quaternion MyMath::MakeQuaternion(const Vector3& rotate)
+{
+	float sx, sy, sz, cx, cy, cz;
+	MathUtility::SinCos(rotate.x / 2.0f, &sx, &cx);
+	MathUtility::SinCos(rotate.y / 2.0f, &sy, &cy);
+	MathUtility::SinCos(rotate.z / 2.0f, &sz, &cz);
+	//X→Y→Zの順に回転するので qz * qy * qx を展開したもの
+	return {
+		sx * cy * cz - cx * sy * sz,
+		cx * sy * cz + sx * cy * sz,
+		cx * cy * sz - sx * sy * cz,
+		cx * cy * cz + sx * sy * sz };
+}
+
+// クォータニオンからオイラー角
+Vector3 MyMath::MakeEulerAngles(const Quaternion& quaternion)
+{
+	Matrix4x4 rotateMatrix = MakeRotateMatrix(quaternion);
+	//m[0][2] = -sin(y)
+	float sinY = (std::clamp)(-rotateMatrix.m[0][2], -1.0f, 1.0f);
+	Vector3 result{};
+	result.y = std::asin(sinY);
+	if (std::abs(sinY) < 0.9999f)
+	{
+		result.x = std::atan2(rotateMatrix.m[1][2], rotateMatrix.m[2][2]);
+		result.z = std::atan2(rotateMatrix.m[0][1], rotateMatrix.m[0][0]);
+	}
+	else
+	{
+		//ジンバルロック時はZ回転を0としてX回転にまとめる
+		result.x = std::atan2(-rotateMatrix.m[2][1], rotateMatrix.m[1][1]);
+		result.z = 0.0f;
+	}
+	return result;
+}
+
+// Affine変換(回転をクォータニオンで指定)
+Matrix4x4 MyMath::MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate)
+{
+	return MathUtility::MakeAffineMatrix(scale, rotate, translate);
+}
@@ -4,11 +4,22 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <span>
+#include <cstddef>
+#include <cstdint>
 
-struct Matrix4x4 {
+#include "Quaternion.h"
+
+//SIMDで行単位に整列ロードできるよう16バイト境界に揃える
+struct alignas(16) Matrix4x4 {
 	float m[4][4];
 };
 
+//2次元アフィン変換行列(行ベクトル[x y 1]に右から掛ける。m[2]は平行移動)
+struct Matrix3x2 {
+	float m[3][2];
+};
+
 struct Vector2 {
 	float x;
 	float y;
@@ -26,6 +37,7 @@ struct Vector3 {
 	float z;
 };
 
+//頂点データにも使うので整列はしない(16バイト境界に置くのは定数バッファの側でoffsetofを確かめる)
 struct Vector4 {
 	float x;
 	float y;
@@ -45,6 +57,13 @@ struct TransformationMatrix
 	Matrix4x4 WVP;
 };
 
+//定数バッファに書き込む型はHLSLのパッキング規則(16バイト境界をまたがない、行列は16バイト境界から)と一致させる
+static_assert(sizeof(Vector4) == 16);
+static_assert(sizeof(Matrix4x4) == 64 && alignof(Matrix4x4) == 16);
+static_assert(offsetof(TransformationMatrix, World) == 0);
+static_assert(offsetof(TransformationMatrix, WVP) == 64);
+static_assert(sizeof(TransformationMatrix) == 128);
+
 //頂点データ
 struct VertexData
 {
@@ -52,16 +71,48 @@ struct VertexData
 	Vector2 texcoord;
 	Vector3 normal;
 };
+//頂点バッファと変換済みファイルにそのまま書き込むので、詰め物を入れない(入力レイアウトのオフセットと一致させる)
+static_assert(offsetof(VertexData, texcoord) == 16);
+static_assert(offsetof(VertexData, normal) == 24);
+static_assert(sizeof(VertexData) == 36);
 
 struct MaterialData
 {
+	//mtlファイルのnewmtlの名前
+	std::string name;
 	std::string textureFilePath;
 };
 
+//同じマテリアルで描画するIndexの範囲
+struct SubmeshData
+{
+	uint32_t indexOffset;
+	uint32_t indexCount;
+	uint32_t materialIndex;
+};
+
+//詳細度(LOD)1段分の描画範囲
+struct LodData
+{
+	//ModelData::submeshesのうち、この段で使う範囲
+	uint32_t submeshOffset;
+	uint32_t submeshCount;
+	//元のメッシュからのずれ(バウンディングスフィアの半径に対する割合)
+	float error;
+};
+
 struct ModelData
 {
 	std::vector<VertexData> vertices;
-	MaterialData material;
+	//頂点Index(三角形リスト。マテリアルごとにまとめて並んでいる)
+	std::vector<uint32_t> indices;
+	//詳細度ごとの描画範囲をつなげたもの(lods[i]が自分の範囲を指す。1つの詳細度の中では同じマテリアルの範囲は1つにまとめてある)
+	std::vector<SubmeshData> submeshes;
+	std::vector<MaterialData> materials;
+	//詳細度ごとの描画範囲(lods[0]が元のメッシュ。空ならsubmeshesをすべて使う)
+	std::vector<LodData> lods;
+	//objが読み込んだmtlファイルのパス(変換済みファイルが古くなっていないかの確認に使う。変換済みファイルから読んだときは空)
+	std::vector<std::string> materialLibraryPaths;
 };
 
 class MyMath
@@ -85,11 +136,67 @@ public:
 	// Affine変換
 	Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
 
+	/// <summary>
+	/// Transform配列からWorld/WVP行列をまとめて生成する
+	/// </summary>
+	/// <param name="transforms">変換元のTransform配列</param>
+	/// <param name="viewProjection">View * Projection行列</param>
+	/// <param name="outMatrices">書き込み先(transformsと同数以上)。定数バッファへ直接書き込める</param>
+	void MakeTransformationMatrices(std::span<const Transform> transforms, const Matrix4x4& viewProjection, std::span<TransformationMatrix> outMatrices);
+
 	Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
 
 	Matrix4x4 Inverse(const Matrix4x4& m);
 
 	//平行投影
 	Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip);
+
+	// 2次元Affine変換(Z軸回転のみ)
+	Matrix3x2 MakeAffineMatrix2D(const Vector2& scale, float rotate, const Vector2& translate);
+
+	// 3x2の掛け算
+	Matrix3x2 Multiply(const Matrix3x2& m1, const Matrix3x2& m2);
+
+	// 2次元の平行投影(MakeOrthographicMatrixのXY成分)
+	Matrix3x2 MakeOrthographicMatrix2D(float left, float top, float right, float bottom);
+
+	// 3x2を4x4に展開する(Zはそのまま通す)
+	Matrix4x4 MakeMatrix4x4(const Matrix3x2& m);
+
+	// 単位クォータニオン
+	Quaternion IdentityQuaternion();
+
+	// クォータニオンの積(rhsの回転の後にlhsの回転)
+	Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs);
+
+	// 正規化
+	Quaternion Normalize(const Quaternion& quaternion);
+
+	// 共役
+	Quaternion Conjugate(const Quaternion& quaternion);
+
+	// 任意軸回転を表すクォータニオン(axisは正規化済み)
+	Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle);
+
+	// 球面線形補間
+	Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+	// クォータニオンでベクトルを回転する
+	Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion);
+
+	// クォータニオンから回転行列
+	Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion);
+
+	// 回転行列からクォータニオン(拡大縮小成分は取り除く)
+	Quaternion MakeQuaternion(const Matrix4x4& matrix);
+
+	// オイラー角からクォータニオン(MakeAffineMatrixと同じくX→Y→Zの順に回転)
+	Quaternion MakeQuaternion(const Vector3& rotate);
+
+	// クォータニオンからオイラー角
+	Vector3 MakeEulerAngles(const Quaternion& quaternion);
+
+	// Affine変換(回転をクォータニオンで指定)
+	Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
 };
 
@@ -0,0 +1,9 @@
+#pragma once
+
+//クォータニオン(回転の表現。w + xi + yj + zk)
+struct Quaternion {
+	float x;
+	float y;
+	float z;
+	float w;
+};
@@ -0,0 +1,200 @@
+#include "SinCos.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+//SIMD命令セットはコンパイル時に選択する(AVX2 > SSE2 > スカラー)
+#if defined(__AVX2__)
+#define SINCOS_USE_AVX2
+#define SINCOS_USE_SSE2
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SINCOS_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	//多項式近似の精度が保てる角度の上限
+	constexpr float kMaxRadian = 8192.0f;
+
+	//4/π
+	constexpr float kFourOverPi = 1.27323954473516f;
+	//π/4を3つに分けたもの(範囲縮小の桁落ちを防ぐ)
+	constexpr float kDP1 = 0.78515625f;
+	constexpr float kDP2 = 2.4187564849853515625e-4f;
+	constexpr float kDP3 = 3.77489497744594108e-8f;
+
+	//[-π/4, π/4]でのsin/cosの多項式の係数
+	constexpr float kSin0 = -1.9515295891e-4f;
+	constexpr float kSin1 = 8.3321608736e-3f;
+	constexpr float kSin2 = -1.6666654611e-1f;
+	constexpr float kCos0 = 2.443315711809948e-5f;
+	constexpr float kCos1 = -1.388731625493765e-3f;
+	constexpr float kCos2 = 4.166664568298827e-2f;
+
+	// 1要素分の計算(範囲外は標準ライブラリ)
+	void SinCosScalar(float radian, float* outSin, float* outCos)
+	{
+		float x = std::abs(radian);
+		if (!(x <= kMaxRadian))
+		{
+			*outSin = std::sin(radian);
+			*outCos = std::cos(radian);
+			return;
+		}
+
+		//π/4単位の象限を求める(偶数に丸める)
+		int32_t quadrant = static_cast<int32_t>(x * kFourOverPi);
+		quadrant = (quadrant + 1) & ~1;
+		float y = static_cast<float>(quadrant);
+
+		//[-π/4, π/4]に縮小する
+		x = ((x - y * kDP1) - y * kDP2) - y * kDP3;
+		float z = x * x;
+
+		float polySin = ((kSin0 * z + kSin1) * z + kSin2) * z * x + x;
+		float polyCos = ((kCos0 * z + kCos1) * z + kCos2) * z * z - 0.5f * z + 1.0f;
+
+		//象限に応じてsin/cosを入れ替え、符号を決める
+		bool swap = (quadrant & 2) != 0;
+		float sinValue = swap ? polyCos : polySin;
+		float cosValue = swap ? polySin : polyCos;
+		bool negativeSin = ((quadrant & 4) != 0) != (radian < 0.0f);
+		bool negativeCos = ((quadrant + 2) & 4) != 0;
+
+		*outSin = negativeSin ? -sinValue : sinValue;
+		*outCos = negativeCos ? -cosValue : cosValue;
+	}
+
+#ifdef SINCOS_USE_SSE2
+	// 4要素分の計算(範囲外の要素はfalseを返すので呼び出し側でスカラー版に回す)
+	bool SinCos4(__m128 radian, __m128* outSin, __m128* outCos)
+	{
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(0x80000000u)));
+		const __m128 signBit = _mm_and_ps(radian, signMask);
+		__m128 x = _mm_andnot_ps(signMask, radian);
+		const bool inRange = _mm_movemask_ps(_mm_cmple_ps(x, _mm_set1_ps(kMaxRadian))) == 0xF;
+
+		__m128i quadrant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(kFourOverPi)));
+		quadrant = _mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		const __m128 y = _mm_cvtepi32_ps(quadrant);
+
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(kDP1)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(kDP2)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(kDP3)));
+		const __m128 z = _mm_mul_ps(x, x);
+
+		__m128 polySin = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kSin0), z), _mm_set1_ps(kSin1));
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(kSin2));
+		polySin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polySin, z), x), x);
+
+		__m128 polyCos = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kCos0), z), _mm_set1_ps(kCos1));
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(kCos2));
+		polyCos = _mm_mul_ps(_mm_mul_ps(polyCos, z), z);
+		polyCos = _mm_add_ps(_mm_sub_ps(polyCos, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+		const __m128 swapMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+		const __m128 sinValue = _mm_or_ps(_mm_and_ps(swapMask, polyCos), _mm_andnot_ps(swapMask, polySin));
+		const __m128 cosValue = _mm_or_ps(_mm_and_ps(swapMask, polySin), _mm_andnot_ps(swapMask, polyCos));
+
+		const __m128 sinSign = _mm_xor_ps(signBit, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(4)), 29)));
+		const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+
+		*outSin = _mm_xor_ps(sinValue, sinSign);
+		*outCos = _mm_xor_ps(cosValue, cosSign);
+		return inRange;
+	}
+#endif
+
+#ifdef SINCOS_USE_AVX2
+	// 8要素分の計算(範囲外の要素はfalseを返すので呼び出し側でスカラー版に回す)
+	bool SinCos8(__m256 radian, __m256* outSin, __m256* outCos)
+	{
+		const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int32_t>(0x80000000u)));
+		const __m256 signBit = _mm256_and_ps(radian, signMask);
+		__m256 x = _mm256_andnot_ps(signMask, radian);
+		const bool inRange = _mm256_movemask_ps(_mm256_cmp_ps(x, _mm256_set1_ps(kMaxRadian), _CMP_LE_OQ)) == 0xFF;
+
+		__m256i quadrant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(kFourOverPi)));
+		quadrant = _mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+		const __m256 y = _mm256_cvtepi32_ps(quadrant);
+
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kDP1)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kDP2)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kDP3)));
+		const __m256 z = _mm256_mul_ps(x, x);
+
+		__m256 polySin = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kSin0), z), _mm256_set1_ps(kSin1));
+		polySin = _mm256_add_ps(_mm256_mul_ps(polySin, z), _mm256_set1_ps(kSin2));
+		polySin = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(polySin, z), x), x);
+
+		__m256 polyCos = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kCos0), z), _mm256_set1_ps(kCos1));
+		polyCos = _mm256_add_ps(_mm256_mul_ps(polyCos, z), _mm256_set1_ps(kCos2));
+		polyCos = _mm256_mul_ps(_mm256_mul_ps(polyCos, z), z);
+		polyCos = _mm256_add_ps(_mm256_sub_ps(polyCos, _mm256_mul_ps(_mm256_set1_ps(0.5f), z)), _mm256_set1_ps(1.0f));
+
+		const __m256 swapMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), _mm256_set1_epi32(2)));
+		const __m256 sinValue = _mm256_blendv_ps(polySin, polyCos, swapMask);
+		const __m256 cosValue = _mm256_blendv_ps(polyCos, polySin, swapMask);
+
+		const __m256 sinSign = _mm256_xor_ps(signBit, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(4)), 29)));
+		const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+
+		*outSin = _mm256_xor_ps(sinValue, sinSign);
+		*outCos = _mm256_xor_ps(cosValue, cosSign);
+		return inRange;
+	}
+#endif
+}
+
+// sinとcosをまとめて計算する
+void MathUtility::SinCos(float radian, float* outSin, float* outCos)
+{
+	SinCosScalar(radian, outSin, outCos);
+}
+
+// 配列の角度のsinとcosをまとめて計算する
+void MathUtility::SinCos(const float* radians, float* outSins, float* outCoss, size_t count)
+{
+	size_t i = 0;
+#ifdef SINCOS_USE_AVX2
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 sinValue, cosValue;
+		if (!SinCos8(_mm256_loadu_ps(radians + i), &sinValue, &cosValue))
+		{
+			//範囲外の角度を含むブロックはスカラー版で計算し直す
+			for (size_t j = i; j < i + 8; ++j)
+			{
+				SinCosScalar(radians[j], &outSins[j], &outCoss[j]);
+			}
+			continue;
+		}
+		_mm256_storeu_ps(outSins + i, sinValue);
+		_mm256_storeu_ps(outCoss + i, cosValue);
+	}
+#endif
+#ifdef SINCOS_USE_SSE2
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 sinValue, cosValue;
+		if (!SinCos4(_mm_loadu_ps(radians + i), &sinValue, &cosValue))
+		{
+			//範囲外の角度を含むブロックはスカラー版で計算し直す
+			for (size_t j = i; j < i + 4; ++j)
+			{
+				SinCosScalar(radians[j], &outSins[j], &outCoss[j]);
+			}
+			continue;
+		}
+		_mm_storeu_ps(outSins + i, sinValue);
+		_mm_storeu_ps(outCoss + i, cosValue);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		SinCosScalar(radians[i], &outSins[i], &outCoss[i]);
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+//sin/cosの同時計算
+//範囲縮小を1回だけ行い、sinとcosの多項式近似を両方求める(Cephesのsinf/cosfと同じ係数)
+//精度(倍精度で求めた真値との差)
+//  |radian| <= π    : 最大2ulp
+//  |radian| <= 8192 : 絶対誤差は最大8e-8。|値| >= 1/8 なら最大2ulp(0付近は範囲縮小の誤差で相対誤差が大きくなる)
+//それより大きい角度は精度が落ちるので標準ライブラリで計算する
+namespace MathUtility
+{
+	// sinとcosをまとめて計算する
+	void SinCos(float radian, float* outSin, float* outCos);
+
+	/// <summary>
+	/// 配列の角度のsinとcosをまとめて計算する(AVX2なら8個、SSE2なら4個ずつ処理する)
+	/// </summary>
+	/// <param name="radians">角度の配列</param>
+	/// <param name="outSins">sinの書き込み先(count個)</param>
+	/// <param name="outCoss">cosの書き込み先(count個)</param>
+	/// <param name="count">要素数</param>
+	void SinCos(const float* radians, float* outSins, float* outCoss, size_t count);
+}
@@ -0,0 +1,122 @@
+#include "TransformGraph.h"
+#include "MathUtility.h"
+
+#include <cassert>
+
+namespace
+{
+	bool Equal(const Vector3& v1, const Vector3& v2)
+	{
+		return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z;
+	}
+}
+
+//ノードの追加
+uint32_t TransformGraph::CreateNode(uint32_t parent)
+{
+	//親は子より前に並んでいる必要がある
+	assert(parent == kNoParent || parent < parents.size());
+
+	parents.push_back(parent);
+	localTransforms.push_back({ { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } });
+	worldMatrices.push_back(MathUtility::MakeIdentity4x4());
+	dirtyFlags.push_back(1);
+	worldVersions.push_back(0);
+	parentVersions.push_back(0);
+
+	return static_cast<uint32_t>(parents.size() - 1);
+}
+
+//親の付け替え
+void TransformGraph::SetParent(uint32_t node, uint32_t parent)
+{
+	//親は子より前に並んでいる必要がある(並びを変えずに済むように、後ろのノードには付け替えない)
+	assert(node < parents.size());
+	assert(parent == kNoParent || parent < node);
+
+	if (parents[node] == parent)
+	{
+		return;
+	}
+	parents[node] = parent;
+	//親の行列が変わるので計算し直す(子孫は自分の更新回数が変わることで計算し直される)
+	dirtyFlags[node] = 1;
+}
+
+//ローカル変換の設定
+void TransformGraph::SetLocalTransform(uint32_t node, const Transform& transform)
+{
+	assert(node < parents.size());
+
+	Transform& local = localTransforms[node];
+	if (Equal(local.scale, transform.scale) && Equal(local.rotate, transform.rotate) && Equal(local.translate, transform.translate))
+	{
+		//変わっていなければ何もしない
+		return;
+	}
+	local = transform;
+	dirtyFlags[node] = 1;
+}
+
+//ダーティなノードとその子孫のワールド行列をまとめて計算し直す
+void TransformGraph::Update()
+{
+	//親が必ず子より前にあるので、先頭から順に見るだけで親の更新が子に伝わる
+	for (uint32_t node = 0; node < parents.size(); ++node)
+	{
+		UpdateNode(node);
+	}
+}
+
+//ワールド行列の取得
+const Matrix4x4& TransformGraph::GetWorldMatrix(uint32_t node)
+{
+	Resolve(node);
+	return worldMatrices[node];
+}
+
+//ワールド行列の更新回数
+uint32_t TransformGraph::GetWorldVersion(uint32_t node)
+{
+	Resolve(node);
+	return worldVersions[node];
+}
+
+//1ノード分の更新
+void TransformGraph::UpdateNode(uint32_t node)
+{
+	uint32_t parent = parents[node];
+	//自分のローカル変換も親のワールド行列も変わっていなければ計算しない
+	bool parentChanged = parent != kNoParent && worldVersions[parent] != parentVersions[node];
+	if (!dirtyFlags[node] && !parentChanged)
+	{
+		return;
+	}
+
+	const Transform& local = localTransforms[node];
+	Matrix4x4 localMatrix = myMath.MakeAffineMatrix(local.scale, local.rotate, local.translate);
+	if (parent == kNoParent)
+	{
+		worldMatrices[node] = localMatrix;
+	}
+	else
+	{
+		worldMatrices[node] = myMath.Multiply(localMatrix, worldMatrices[parent]);
+		parentVersions[node] = worldVersions[parent];
+	}
+
+	dirtyFlags[node] = 0;
+	++worldVersions[node];
+}
+
+//親から順に辿って更新する
+void TransformGraph::Resolve(uint32_t node)
+{
+	assert(node < parents.size());
+
+	if (parents[node] != kNoParent)
+	{
+		Resolve(parents[node]);
+	}
+	UpdateNode(node);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "MyMath.h"
+
+#include <cstdint>
+#include <vector>
+
+//親子関係を持つTransformの管理
+//ノードは親が必ず子より前に並ぶフラットな配列で持ち、変更のあったノードとその子孫だけワールド行列を計算し直す
+class TransformGraph
+{
+public:
+	//親がいないことを表すノード番号
+	static const uint32_t kNoParent = UINT32_MAX;
+
+	/// <summary>
+	/// ノードの追加
+	/// </summary>
+	/// <param name="parent">親のノード番号(先に追加されている必要がある)</param>
+	/// <returns>追加したノード番号</returns>
+	uint32_t CreateNode(uint32_t parent = kNoParent);
+
+	/// <summary>
+	/// 親の付け替え(子より前に並んでいるノードにしか付け替えられない)
+	/// </summary>
+	/// <param name="node">ノード番号</param>
+	/// <param name="parent">新しい親のノード番号(kNoParentなら親を外す)</param>
+	void SetParent(uint32_t node, uint32_t parent);
+
+	//ローカル変換の設定(値が変わった時だけダーティにする)
+	void SetLocalTransform(uint32_t node, const Transform& transform);
+
+	//ダーティなノードとその子孫のワールド行列をまとめて計算し直す
+	void Update();
+
+	//ワールド行列の取得(親を辿って必要な分だけ計算し直す)
+	const Matrix4x4& GetWorldMatrix(uint32_t node);
+
+	//ワールド行列の更新回数(値が変わっていなければ前回書き込んだ行列をそのまま使える)
+	uint32_t GetWorldVersion(uint32_t node);
+
+	//getter
+	const Transform& GetLocalTransform(uint32_t node) const { return localTransforms[node]; }
+	uint32_t GetParent(uint32_t node) const { return parents[node]; }
+	uint32_t GetNodeCount() const { return static_cast<uint32_t>(parents.size()); }
+
+private:
+	//1ノード分の更新(親は更新済みであること)
+	void UpdateNode(uint32_t node);
+
+	//親から順に辿って更新する
+	void Resolve(uint32_t node);
+
+	//ノードごとのデータ(添字がノード番号)
+	std::vector<uint32_t> parents;
+	std::vector<Transform> localTransforms;
+	std::vector<Matrix4x4> worldMatrices;
+	//ローカル変換が変わったか
+	std::vector<uint8_t> dirtyFlags;
+	//ワールド行列の更新回数と、計算に使った親の更新回数
+	std::vector<uint32_t> worldVersions;
+	std::vector<uint32_t> parentVersions;
+
+	//行列計算(ノードごとに作らないように持っておく)
+	MyMath myMath;
+};
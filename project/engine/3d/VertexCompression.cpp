@@ -0,0 +1,214 @@
+#include "VertexCompression.h"
+
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+
+//半精度浮動小数点に変換する
+uint16_t VertexCompression::FloatToHalf(float value)
+{
+	const uint32_t bits = std::bit_cast<uint32_t>(value);
+	const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+	const uint32_t absolute = bits & 0x7FFFFFFF;
+
+	//無限大とNaN
+	if (absolute >= 0x7F800000)
+	{
+		return static_cast<uint16_t>(sign | (absolute > 0x7F800000 ? 0x7E00 : 0x7C00));
+	}
+	//丸めると65520以上になるものは無限大
+	if (absolute >= 0x477FF000)
+	{
+		return static_cast<uint16_t>(sign | 0x7C00);
+	}
+	//半精度の非正規化数(2^-14未満)は2^-24単位で丸める
+	if (absolute < 0x38800000)
+	{
+		float magnitude = std::bit_cast<float>(absolute);
+		return static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(magnitude * 16777216.0f)));
+	}
+	//指数の偏りを付け替えて、仮数の下位13bitを最近接偶数に丸める
+	uint32_t half = absolute - 0x38000000;
+	half = (half + 0x0FFF + ((half >> 13) & 1)) >> 13;
+	return static_cast<uint16_t>(sign | half);
+}
+
+//半精度浮動小数点から戻す
+float VertexCompression::HalfToFloat(uint16_t value)
+{
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1F;
+	const uint32_t mantissa = value & 0x3FF;
+
+	if (exponent == 0)
+	{
+		float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+		return sign != 0 ? -magnitude : magnitude;
+	}
+	if (exponent == 31)
+	{
+		return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+	}
+	return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+//法線を八面体エンコードする
+void VertexCompression::EncodeOctahedral(const Vector3& normal, int16_t outEncoded[2])
+{
+	const float l1Norm = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+	float x = 0.0f;
+	float y = 0.0f;
+	if (l1Norm > 0.0f)
+	{
+		x = normal.x / l1Norm;
+		y = normal.y / l1Norm;
+		//下半球は外側に折り返す
+		if (normal.z < 0.0f)
+		{
+			float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+			y = foldedY;
+		}
+	}
+	outEncoded[0] = static_cast<int16_t>(std::lround(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+	outEncoded[1] = static_cast<int16_t>(std::lround(std::clamp(y, -1.0f, 1.0f) * 32767.0f));
+}
+
+//八面体エンコードした法線を戻す(VertexDecode.hlsliのDecodeOctahedralと同じ計算)
+Vector3 VertexCompression::DecodeOctahedral(const int16_t encoded[2])
+{
+	float x = (std::max)(static_cast<float>(encoded[0]) / 32767.0f, -1.0f);
+	float y = (std::max)(static_cast<float>(encoded[1]) / 32767.0f, -1.0f);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+	float t = (std::max)(-z, 0.0f);
+	x += x >= 0.0f ? -t : t;
+	y += y >= 0.0f ? -t : t;
+	float recpLength = 1.0f / std::sqrt(x * x + y * y + z * z);
+	return { x * recpLength, y * recpLength, z * recpLength };
+}
+
+//位置を0～65535に量子化する
+uint16_t VertexCompression::QuantizeUnorm16(float value, float offset, float scale)
+{
+	if (scale <= 0.0f)
+	{
+		return 0;
+	}
+	float normalized = std::clamp((value - offset) / scale, 0.0f, 1.0f);
+	return static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+}
+
+//量子化した位置を戻す(UNORMの読み込みと同じく /65535 してから拡大する)
+float VertexCompression::DequantizeUnorm16(uint16_t value, float offset, float scale)
+{
+	return offset + static_cast<float>(value) / 65535.0f * scale;
+}
+
+//モデルを圧縮する
+CompactModelData VertexCompression::Compress(const ModelData& modelData)
+{
+	CompactModelData compactModelData{};
+	compactModelData.indices = modelData.indices;
+	compactModelData.submeshes = modelData.submeshes;
+	compactModelData.materials = modelData.materials;
+	compactModelData.lods = modelData.lods;
+
+	//AABBを量子化の範囲にする
+	Vector3 minPosition{ FLT_MAX, FLT_MAX, FLT_MAX };
+	Vector3 maxPosition{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (const VertexData& vertex : modelData.vertices)
+	{
+		minPosition = { (std::min)(minPosition.x, vertex.position.x), (std::min)(minPosition.y, vertex.position.y), (std::min)(minPosition.z, vertex.position.z) };
+		maxPosition = { (std::max)(maxPosition.x, vertex.position.x), (std::max)(maxPosition.y, vertex.position.y), (std::max)(maxPosition.z, vertex.position.z) };
+	}
+	if (modelData.vertices.empty())
+	{
+		minPosition = { 0.0f, 0.0f, 0.0f };
+		maxPosition = { 0.0f, 0.0f, 0.0f };
+	}
+	compactModelData.positionOffset = minPosition;
+	compactModelData.positionScale = { maxPosition.x - minPosition.x, maxPosition.y - minPosition.y, maxPosition.z - minPosition.z };
+
+	const Vector3& offset = compactModelData.positionOffset;
+	const Vector3& scale = compactModelData.positionScale;
+	compactModelData.vertices.resize(modelData.vertices.size());
+	for (size_t i = 0; i < modelData.vertices.size(); ++i)
+	{
+		const VertexData& vertex = modelData.vertices[i];
+		CompactVertexData& compactVertex = compactModelData.vertices[i];
+		compactVertex.position[0] = QuantizeUnorm16(vertex.position.x, offset.x, scale.x);
+		compactVertex.position[1] = QuantizeUnorm16(vertex.position.y, offset.y, scale.y);
+		compactVertex.position[2] = QuantizeUnorm16(vertex.position.z, offset.z, scale.z);
+		compactVertex.position[3] = 0;
+		compactVertex.texcoord[0] = FloatToHalf(vertex.texcoord.x);
+		compactVertex.texcoord[1] = FloatToHalf(vertex.texcoord.y);
+		EncodeOctahedral(vertex.normal, compactVertex.normal);
+	}
+	return compactModelData;
+}
+
+//圧縮したモデルを戻す
+ModelData VertexCompression::Decompress(const CompactModelData& compactModelData)
+{
+	ModelData modelData;
+	modelData.indices = compactModelData.indices;
+	modelData.submeshes = compactModelData.submeshes;
+	modelData.materials = compactModelData.materials;
+	modelData.lods = compactModelData.lods;
+
+	const Vector3& offset = compactModelData.positionOffset;
+	const Vector3& scale = compactModelData.positionScale;
+	modelData.vertices.resize(compactModelData.vertices.size());
+	for (size_t i = 0; i < compactModelData.vertices.size(); ++i)
+	{
+		const CompactVertexData& compactVertex = compactModelData.vertices[i];
+		VertexData& vertex = modelData.vertices[i];
+		vertex.position = {
+			DequantizeUnorm16(compactVertex.position[0], offset.x, scale.x),
+			DequantizeUnorm16(compactVertex.position[1], offset.y, scale.y),
+			DequantizeUnorm16(compactVertex.position[2], offset.z, scale.z),
+			1.0f
+		};
+		vertex.texcoord = { HalfToFloat(compactVertex.texcoord[0]), HalfToFloat(compactVertex.texcoord[1]) };
+		vertex.normal = DecodeOctahedral(compactVertex.normal);
+	}
+	return modelData;
+}
+
+//圧縮による誤差を測る
+CompressionError VertexCompression::MeasureError(const ModelData& modelData, const CompactModelData& compactModelData)
+{
+	CompressionError error{ 0.0f, 0.0f, 0.0f };
+	const ModelData decompressed = Decompress(compactModelData);
+
+	for (size_t i = 0; i < modelData.vertices.size() && i < decompressed.vertices.size(); ++i)
+	{
+		const VertexData& original = modelData.vertices[i];
+		const VertexData& restored = decompressed.vertices[i];
+
+		float dx = original.position.x - restored.position.x;
+		float dy = original.position.y - restored.position.y;
+		float dz = original.position.z - restored.position.z;
+		error.maxPositionError = (std::max)(error.maxPositionError, std::sqrt(dx * dx + dy * dy + dz * dz));
+
+		error.maxTexcoordError = (std::max)(error.maxTexcoordError, std::fabs(original.texcoord.x - restored.texcoord.x));
+		error.maxTexcoordError = (std::max)(error.maxTexcoordError, std::fabs(original.texcoord.y - restored.texcoord.y));
+
+		const Vector3& n = original.normal;
+		float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+		if (length > 0.0f)
+		{
+			//角度が小さいとacosでは精度が出ないので、外積の長さと内積から求める
+			const Vector3& r = restored.normal;
+			float crossX = n.y * r.z - n.z * r.y;
+			float crossY = n.z * r.x - n.x * r.z;
+			float crossZ = n.x * r.y - n.y * r.x;
+			float sinAngle = std::sqrt(crossX * crossX + crossY * crossY + crossZ * crossZ);
+			float cosAngle = n.x * r.x + n.y * r.y + n.z * r.z;
+			error.maxNormalAngleError = (std::max)(error.maxNormalAngleError, std::atan2(sinAngle, cosAngle));
+		}
+	}
+	return error;
+}
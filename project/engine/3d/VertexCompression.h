@@ -0,0 +1,76 @@
+#pragma once
+
+#include "MyMath.h"
+
+#include <cstdint>
+#include <vector>
+
+//圧縮した頂点(16バイト。VertexDataの1/3)
+//position: AABBに対する16bit正規化整数(DXGI_FORMAT_R16G16B16A16_UNORM。wは未使用)
+//texcoord: 半精度浮動小数点(DXGI_FORMAT_R16G16_FLOAT)
+//normal  : 八面体エンコードした16bit符号付き正規化整数(DXGI_FORMAT_R16G16_SNORM)
+struct CompactVertexData
+{
+	uint16_t position[4];
+	uint16_t texcoord[2];
+	int16_t normal[2];
+};
+static_assert(sizeof(CompactVertexData) == 16);
+
+//圧縮したモデル
+struct CompactModelData
+{
+	std::vector<CompactVertexData> vertices;
+	std::vector<uint32_t> indices;
+	//位置の復元用(position = positionOffset + quantized * positionScale。quantizedは0～1)
+	Vector3 positionOffset;
+	Vector3 positionScale;
+	std::vector<SubmeshData> submeshes;
+	std::vector<MaterialData> materials;
+	std::vector<LodData> lods;
+};
+
+//圧縮による誤差
+struct CompressionError
+{
+	//位置の最大誤差(モデル座標)
+	float maxPositionError;
+	//テクスチャ座標の最大誤差
+	float maxTexcoordError;
+	//法線の最大の角度の誤差(ラジアン。長さ0の法線は除く)
+	float maxNormalAngleError;
+};
+
+//頂点の圧縮と復元
+namespace VertexCompression
+{
+	// 半精度浮動小数点に変換する(最近接偶数への丸め。範囲外は無限大)
+	uint16_t FloatToHalf(float value);
+	// 半精度浮動小数点から戻す
+	float HalfToFloat(uint16_t value);
+
+	// 法線を八面体エンコードする(長さ0なら(0,0,1)扱い)
+	void EncodeOctahedral(const Vector3& normal, int16_t outEncoded[2]);
+	// 八面体エンコードした法線を戻す(正規化済み)
+	Vector3 DecodeOctahedral(const int16_t encoded[2]);
+
+	// 位置を0～65535に量子化する
+	uint16_t QuantizeUnorm16(float value, float offset, float scale);
+	// 量子化した位置を戻す
+	float DequantizeUnorm16(uint16_t value, float offset, float scale);
+
+	//圧縮による誤差の上限(MeasureErrorの結果はこれに収まる)
+	//位置: 各軸で量子化の幅(scale/65535)の半分と計算の丸め。positionScaleの長さに掛ける
+	constexpr float kPositionErrorPerScale = 0.51f / 65535.0f;
+	//テクスチャ座標: 0～1の範囲なら半精度の間隔(0.5～1で2^-11)の半分
+	constexpr float kTexcoordError = 1.0f / 4096.0f;
+	//法線: 16bitの八面体エンコードの角度の誤差(ラジアン。約0.006度。実測の最大は6.5e-5程度)
+	constexpr float kNormalAngleError = 1.0e-4f;
+
+	// モデルを圧縮する
+	CompactModelData Compress(const ModelData& modelData);
+	// 圧縮したモデルを戻す
+	ModelData Decompress(const CompactModelData& compactModelData);
+	// 圧縮による誤差を測る
+	CompressionError MeasureError(const ModelData& modelData, const CompactModelData& compactModelData);
+}
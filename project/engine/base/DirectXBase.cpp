@@ -18,6 +18,8 @@
 using namespace Microsoft::WRL;
 
 const uint32_t DirectXBase::kMaxSRVCount = 512;
+//2048x2048のRGBAテクスチャ(ミップ付きで約22MB)が2枚入る大きさ
+const uint64_t DirectXBase::kUploadRingSize = 64ull * 1024 * 1024;
 
 ////DescriptorHandleのポインタ*****
 //typedef struct D3D12_CPU_DESCRIPTOR_HANDLE
@@ -177,8 +179,8 @@ void DirectXBase::UploadTextureData(const Microsoft::WRL::ComPtr<ID3D12Resource>
 	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
 	DirectX::PrepareUpload(device.Get(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
 	uint64_t intermediateSize = GetRequiredIntermediateSize(texture.Get(), 0, UINT(subresources.size()));
-	Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResource = CreateBufferResource(intermediateSize);
-	UpdateSubresources(commandList.Get(), texture.Get(), intermediateResource.Get(), 0, 0, UINT(subresources.size()), subresources.data());
+	StagingAllocation staging = AllocateStaging(intermediateSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	UpdateSubresources(commandList.Get(), texture.Get(), staging.resource, staging.offset, 0, UINT(subresources.size()), subresources.data());
 	//Texture転送後は利用できるよう、D3D12_RESOURCE_STATE_COPY_DESTからD3D12_RESOURCE_STATE_GENERIC_READへResourceStateを変更する
 	D3D12_RESOURCE_BARRIER barrier{};
 	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -521,6 +523,8 @@ void DirectXBase::Initialize(WindowsAPI * windowsAPI)
 	DepthStencilViewInitialize();
 	//フェンスの生成
 	FenceGenerate();
+	//転送の中間リソースの生成
+	uploadRing.Initialize(this, kUploadRingSize);
 	//ビューポート矩形の初期化
 	ViewportInitialize();
 	//シザリング矩形の初期化
@@ -640,18 +644,34 @@ void DirectXBase::WaitForSignal()
 	//===コマンドキューにシグナルを送る===
 	//GPUがここまでたどり着いたときに、Fenceの値を指定した値に代入するようにSignalを送る
 	commandQueue->Signal(fence.Get(), fenceVal);
+	//ここまでに切り出した中間リソースは、このフェンス値まで使われる
+	uploadRing.Submit(fenceVal);
 
 	//実行を待つ
+	WaitForFenceValue(fenceVal);
+	//GPUが使い終わった中間リソースを使い回せるようにする
+	uploadRing.Retire(fence->GetCompletedValue());
+}
+
+//フェンスが指定した値に進むまで待つ
+void DirectXBase::WaitForFenceValue(uint64_t fenceValue)
+{
 	//Fenceの値が指定したSignal値にたどり着いているか確認する
-	if (fence->GetCompletedValue() < fenceVal)
+	if (fence->GetCompletedValue() < fenceValue)
 	{
 		//指定したSignalにたどり着いていないので、たどり着くまで待つようにイベントを設定する
-		fence->SetEventOnCompletion(fenceVal, fenceEvent);
+		fence->SetEventOnCompletion(fenceValue, fenceEvent);
 		//イベントを待つ
 		WaitForSingleObject(fenceEvent, INFINITE);
 	}
 }
 
+//転送の中間リソースの切り出し
+StagingAllocation DirectXBase::AllocateStaging(uint64_t sizeInBytes, uint64_t alignment)
+{
+	return uploadRing.Allocate(sizeInBytes, alignment);
+}
+
 void DirectXBase::CommandReset()
 {
 	//===コマンドアロケーターのリセット===
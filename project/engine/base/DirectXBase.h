@@ -3,6 +3,7 @@
 #include "WindowsAPI.h"
 #include "Logger.h"
 #include "StringUtility.h"
+#include "UploadRing.h"
 
 #include <d3d12.h>//
 #include <dxgi1_6.h>//
@@ -38,6 +39,9 @@ public://メンバ変数
 
 	void CommandReset();
 
+	//フェンスが指定した値に進むまで待つ
+	void WaitForFenceValue(uint64_t fenceValue);
+
 public://外部公開
 	/// <summary>
 	/// SRVの指定番号のCPUデスクリプタハンドルを取得する
@@ -53,6 +57,9 @@ public://外部公開
 	ID3D12Device* GetDevice()const { return device.Get(); }
 	ID3D12GraphicsCommandList* GetCommandList() const { return commandList.Get(); }
 	ID3D12DescriptorHeap* GetSrvDescriptorHeap() const { return srvDescriptorHeap.Get(); }
+	//GPUが完了したフェンス値と、最後にシグナルしたフェンス値
+	uint64_t GetCompletedFenceValue() const { return fence->GetCompletedValue(); }
+	uint64_t GetLastSignaledFenceValue() const { return fenceVal; }
 
 	//シェーダーのコンパイル
 	Microsoft::WRL::ComPtr<IDxcBlob> CompileShader(const std::wstring& filePath, const wchar_t* profile);
@@ -62,6 +69,13 @@ public://外部公開
 	/// </summary>
 	Microsoft::WRL::ComPtr<ID3D12Resource>CreateBufferResource(size_t sizeInBytes);
 
+	/// <summary>
+	/// 転送の中間リソースの切り出し(次のWaitForSignalでGPUが使い終わるまで有効。解放はいらない)
+	/// </summary>
+	/// <param name="sizeInBytes">大きさ(バイト)</param>
+	/// <param name="alignment">オフセットの揃え</param>
+	StagingAllocation AllocateStaging(uint64_t sizeInBytes, uint64_t alignment);
+
 	/// <summary>
 	/// テクスチャリソースの生成
 	/// </summary>
@@ -81,6 +95,8 @@ public://外部公開
 
 	//最大SRV数(最大テクスチャ枚数)
 	static const uint32_t kMaxSRVCount;
+	//転送の中間リソースに使い回すバッファの大きさ
+	static const uint64_t kUploadRingSize;
 
 private://プライベート関数
 	//デバイスの初期化
@@ -195,6 +211,9 @@ private://メンバ変数
 	//フェンス値
 	UINT64 fenceVal = 0;
 
+	//転送の中間リソース
+	UploadRing uploadRing;
+
 	//DirectX12デバイス
 	Microsoft::WRL::ComPtr<ID3D12Device> device{};
 
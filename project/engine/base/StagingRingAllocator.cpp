@@ -0,0 +1,84 @@
+#include "StagingRingAllocator.h"
+
+#include <cassert>
+
+//初期化
+void StagingRingAllocator::Initialize(uint64_t capacity)
+{
+	this->capacity = capacity;
+	head = 0;
+	tail = 0;
+	usedSize = 0;
+	unsubmittedSize = 0;
+	pendingRegions.clear();
+}
+
+//領域を切り出す
+uint64_t StagingRingAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	if (size == 0 || size > capacity)
+	{
+		return kInvalidOffset;
+	}
+
+	//空いている区間は、tailがheadより後ろなら[head, tail)、そうでなければ[head, capacity)と[0, tail)
+	const uint64_t alignedHead = (head + alignment - 1) & ~(alignment - 1);
+	const bool isWrapped = head < tail || (head == tail && usedSize != 0);
+	const uint64_t end = isWrapped ? tail : capacity;
+	if (alignedHead + size <= end)
+	{
+		const uint64_t allocatedSize = alignedHead + size - head;
+		head = alignedHead + size;
+		usedSize += allocatedSize;
+		unsubmittedSize += allocatedSize;
+		return alignedHead;
+	}
+
+	//末尾に収まらなければ、残りを埋め草にして先頭から切り出す(先頭はどの揃えでも揃っている)
+	if (!isWrapped && size <= tail)
+	{
+		const uint64_t allocatedSize = capacity - head + size;
+		head = size;
+		usedSize += allocatedSize;
+		unsubmittedSize += allocatedSize;
+		return 0;
+	}
+	return kInvalidOffset;
+}
+
+//前回から切り出した領域を記録する
+void StagingRingAllocator::Submit(uint64_t fenceValue)
+{
+	if (unsubmittedSize == 0)
+	{
+		return;
+	}
+	assert(pendingRegions.empty() || pendingRegions.back().fenceValue <= fenceValue);
+	pendingRegions.push_back({ fenceValue, head, unsubmittedSize });
+	unsubmittedSize = 0;
+}
+
+//フェンスが進んだ分の領域を空ける
+void StagingRingAllocator::Retire(uint64_t completedFenceValue)
+{
+	while (!pendingRegions.empty() && pendingRegions.front().fenceValue <= completedFenceValue)
+	{
+		tail = pendingRegions.front().endOffset;
+		usedSize -= pendingRegions.front().size;
+		pendingRegions.pop_front();
+	}
+
+	//全て空いたら先頭に戻して、大きな領域を切り出しやすくする
+	if (usedSize == 0)
+	{
+		head = 0;
+		tail = 0;
+	}
+}
+
+//一番古いフェンス値
+uint64_t StagingRingAllocator::GetOldestPendingFenceValue() const
+{
+	return pendingRegions.empty() ? 0 : pendingRegions.front().fenceValue;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+//転送用バッファの中を輪のように切り出して、GPUが使い終わった(フェンスが進んだ)ところから使い回す
+//(バッファそのものは持たず、オフセットだけを扱うのでGPUが無くても動かせる)
+class StagingRingAllocator
+{
+public:
+	//切り出せなかったときのオフセット
+	static constexpr uint64_t kInvalidOffset = UINT64_MAX;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="capacity">バッファの大きさ(バイト)</param>
+	void Initialize(uint64_t capacity);
+
+	/// <summary>
+	/// 領域を切り出す(空いていなければkInvalidOffset。フェンスを待ってRetireすれば空くかはGetOldestPendingFenceValueで分かる)
+	/// </summary>
+	/// <param name="size">大きさ(バイト)</param>
+	/// <param name="alignment">オフセットの揃え(2のべき乗)</param>
+	uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+	//前回から切り出した領域を、このフェンス値をシグナルしたコマンドが使うものとして記録する
+	void Submit(uint64_t fenceValue);
+
+	//フェンスが完了値まで進んだ分の領域を空ける
+	void Retire(uint64_t completedFenceValue);
+
+	//GPUの完了待ちの中で一番古いフェンス値(無ければ0)
+	uint64_t GetOldestPendingFenceValue() const;
+
+	//getter
+	uint64_t GetCapacity() const { return capacity; }
+	uint64_t GetUsedSize() const { return usedSize; }
+
+private:
+	//Submit1回分の領域
+	struct PendingRegion {
+		uint64_t fenceValue;
+		//領域の終わり(空けたらここがtailになる)
+		uint64_t endOffset;
+		//埋め草を含めた大きさ
+		uint64_t size;
+	};
+
+	uint64_t capacity = 0;
+	//次に切り出す位置と、使用中の先頭
+	uint64_t head = 0;
+	uint64_t tail = 0;
+	//使用中の大きさ(末尾の埋め草を含む。headとtailが同じとき、空か満杯かをこれで見分ける)
+	uint64_t usedSize = 0;
+	//まだSubmitしていない分の大きさ
+	uint64_t unsubmittedSize = 0;
+	std::deque<PendingRegion> pendingRegions;
+};
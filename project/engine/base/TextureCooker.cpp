@@ -0,0 +1,219 @@
+#include "TextureCooker.h"
+#include "TextureDecoder.h"
+#include "ThreadPool.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	//圧縮の種類と元のフォーマットから、圧縮後のフォーマットを決める(sRGBかどうかは元に合わせる)
+	DXGI_FORMAT GetCompressedFormat(TextureCompression compression, DXGI_FORMAT sourceFormat)
+	{
+		const bool isSRGB = DirectX::IsSRGB(sourceFormat);
+		switch (compression)
+		{
+		case TextureCompression::BC1:
+			return isSRGB ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+		case TextureCompression::BC3:
+			return isSRGB ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+		case TextureCompression::BC7:
+			return isSRGB ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+		default:
+			return DXGI_FORMAT_UNKNOWN;
+		}
+	}
+
+	//小文字にする
+	std::string ToLower(std::string_view text)
+	{
+		std::string result(text);
+		for (char& c : result)
+		{
+			if (c >= 'A' && c <= 'Z')
+			{
+				c = static_cast<char>(c - 'A' + 'a');
+			}
+		}
+		return result;
+	}
+
+	//変換の対象にする画像の拡張子か
+	bool IsCookableExtension(const std::string& extension)
+	{
+		const std::string lowerExtension = ToLower(extension);
+		return lowerExtension == ".png" || lowerExtension == ".jpg" || lowerExtension == ".jpeg" || lowerExtension == ".bmp" ||
+			lowerExtension == ".tga" || lowerExtension == ".hdr" || lowerExtension == ".tif" || lowerExtension == ".tiff";
+	}
+}
+
+//圧縮の種類を名前から決める
+bool TextureCooker::ParseCompression(std::string_view name, TextureCompression& outCompression)
+{
+	const std::string lowerName = ToLower(name);
+	if (lowerName == "none")
+	{
+		outCompression = TextureCompression::None;
+	}
+	else if (lowerName == "bc1")
+	{
+		outCompression = TextureCompression::BC1;
+	}
+	else if (lowerName == "bc3")
+	{
+		outCompression = TextureCompression::BC3;
+	}
+	else if (lowerName == "bc7")
+	{
+		outCompression = TextureCompression::BC7;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+//変換済みファイルを引くキー
+uint64_t TextureCooker::ComputeKey(const uint8_t* data, size_t size, const CookSettings& settings)
+{
+	//FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	auto addBytes = [&hash](const uint8_t* bytes, size_t count) {
+		for (size_t i = 0; i < count; ++i)
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	};
+	//版と設定も混ぜて、作り方が変わったら別のファイルになるようにする
+	const uint32_t parameters[] = { kVersion, static_cast<uint32_t>(settings.compression) };
+	addBytes(reinterpret_cast<const uint8_t*>(parameters), sizeof(parameters));
+	addBytes(data, size);
+	return hash;
+}
+
+//変換済みファイルのパス
+std::string TextureCooker::GetCookedPath(uint64_t key)
+{
+	char fileName[32];
+	std::snprintf(fileName, sizeof(fileName), "/%016" PRIx64 ".dds", key);
+	return kCacheDirectory + std::string(fileName);
+}
+
+//ミップマップの作成とブロック圧縮
+HRESULT TextureCooker::Cook(DirectX::ScratchImage&& image, const CookSettings& settings, DirectX::ScratchImage& outImage)
+{
+	//＝＝＝1.ミップマップの作成(入っていればそのまま使う)＝＝＝
+	DirectX::ScratchImage mipImages{};
+	const DirectX::TexMetadata& metadata = image.GetMetadata();
+	if (metadata.mipLevels == 1 && !DirectX::IsCompressed(metadata.format))
+	{
+		HRESULT hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), metadata, DirectX::TEX_FILTER_SRGB, 0, mipImages);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+	}
+	else
+	{
+		mipImages = std::move(image);
+	}
+
+	//＝＝＝2.ブロック圧縮＝＝＝
+	//BCフォーマットのテクスチャは縦横が4の倍数でないと作れない。HDRなど8bitより細かい色は潰れるので圧縮しない
+	const DirectX::TexMetadata& mipMetadata = mipImages.GetMetadata();
+	const DXGI_FORMAT compressedFormat = GetCompressedFormat(settings.compression, mipMetadata.format);
+	if (compressedFormat == DXGI_FORMAT_UNKNOWN || DirectX::IsCompressed(mipMetadata.format) || DirectX::BitsPerColor(mipMetadata.format) > 8 ||
+		mipMetadata.width % 4 != 0 || mipMetadata.height % 4 != 0)
+	{
+		outImage = std::move(mipImages);
+		return S_OK;
+	}
+	return DirectX::Compress(mipImages.GetImages(), mipImages.GetImageCount(), mipMetadata, compressedFormat, DirectX::TEX_COMPRESS_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, outImage);
+}
+
+//DDSに書き出す
+bool TextureCooker::Save(const DirectX::ScratchImage& image, const std::string& cookedPath)
+{
+	DirectX::Blob blob{};
+	if (FAILED(DirectX::SaveToDDSMemory(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::DDS_FLAGS_NONE, blob)))
+	{
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(kCacheDirectory, error);
+
+	//同じ画像を別のスレッドが書き出していても混ざらないように、スレッドごとの一時ファイルに書いてから置き換える
+	char suffix[32];
+	std::snprintf(suffix, sizeof(suffix), ".%zx.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+	const std::string temporaryPath = cookedPath + suffix;
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return false;
+		}
+		file.write(static_cast<const char*>(blob.GetBufferPointer()), static_cast<std::streamsize>(blob.GetBufferSize()));
+		if (!file.good())
+		{
+			file.close();
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+	}
+	std::filesystem::rename(temporaryPath, cookedPath, error);
+	if (error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+//ディレクトリの中の画像を全て変換しておく
+uint32_t TextureCooker::CookDirectory(const std::string& directoryPath, const CookSettings& settings)
+{
+	const std::filesystem::path cacheDirectory = std::filesystem::path(kCacheDirectory).lexically_normal();
+	std::vector<std::string> filePaths;
+	std::error_code error;
+	for (auto it = std::filesystem::recursive_directory_iterator(directoryPath, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+	{
+		//変換済みファイルのディレクトリには入らない
+		if (it->is_directory() && it->path().lexically_normal() == cacheDirectory)
+		{
+			it.disable_recursion_pending();
+			continue;
+		}
+		if (it->is_regular_file() && IsCookableExtension(it->path().extension().string()))
+		{
+			filePaths.push_back(it->path().generic_string());
+		}
+	}
+
+	//変換済みなら読むだけで終わるので、全ての画像をそのまま積む
+	CookSettings cookSettings = settings;
+	cookSettings.isEnabled = true;
+	ThreadPool threadPool;
+	std::vector<std::future<bool>> results;
+	results.reserve(filePaths.size());
+	for (const std::string& filePath : filePaths)
+	{
+		results.push_back(threadPool.Submit([filePath, cookSettings]() {
+			return SUCCEEDED(TextureDecoder::Decode(UINT32_MAX, filePath, cookSettings)->result);
+		}));
+	}
+
+	uint32_t cookedCount = 0;
+	for (std::future<bool>& result : results)
+	{
+		cookedCount += result.get() ? 1 : 0;
+	}
+	return cookedCount;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "externals/DirectXTex/DirectXTex.h"
+
+//変換済みテクスチャのブロック圧縮の種類
+enum class TextureCompression : uint32_t
+{
+	//圧縮しない(ミップマップだけ作る)
+	None,
+	//RGB+1bitのα(4bit/画素)
+	BC1,
+	//RGBA(8bit/画素)
+	BC3,
+	//高画質なRGBA(8bit/画素。圧縮に時間がかかる)
+	BC7,
+};
+
+//テクスチャをミップマップ付き(と、指定があればブロック圧縮)のDDSに変換して、次回からそのまま転送する
+//変換済みファイルは元ファイルの中身と設定のハッシュで名前を付けるので、中身が変われば作り直され、同じ画像は共有される
+namespace TextureCooker
+{
+	//変換の版(中身の作り方を変えたら上げて、古い変換済みファイルを使わないようにする)
+	constexpr uint32_t kVersion = 1;
+	//変換済みファイルを置くディレクトリ
+	constexpr const char* kCacheDirectory = "resources/cooked";
+
+	struct CookSettings
+	{
+		//変換済みファイルを使う・書き出すか
+		bool isEnabled = true;
+		TextureCompression compression = TextureCompression::None;
+	};
+
+	/// <summary>
+	/// 圧縮の種類を名前から決める(コマンドラインの指定用。大文字小文字は区別しない)
+	/// </summary>
+	/// <param name="name">none / bc1 / bc3 / bc7</param>
+	/// <param name="outCompression">書き込み先(名前が分からなければ書き換えない)</param>
+	/// <returns>分かる名前だったか</returns>
+	bool ParseCompression(std::string_view name, TextureCompression& outCompression);
+
+	//元ファイルの中身と設定から、変換済みファイルを引くキーを作る(FNV-1a)
+	uint64_t ComputeKey(const uint8_t* data, size_t size, const CookSettings& settings);
+
+	//キーに対応する変換済みファイルのパス
+	std::string GetCookedPath(uint64_t key);
+
+	/// <summary>
+	/// デコードした画像からミップマップを作り、指定があればブロック圧縮する
+	/// </summary>
+	/// <param name="image">デコードした画像</param>
+	/// <param name="settings">圧縮の種類(縦横が4の倍数でない、8bitより細かい色の画像は圧縮しない)</param>
+	/// <param name="outImage">書き込み先</param>
+	HRESULT Cook(DirectX::ScratchImage&& image, const CookSettings& settings, DirectX::ScratchImage& outImage);
+
+	/// <summary>
+	/// DDSに書き出す(一時ファイルに書いてから置き換えるので、同時に書き出しても読みかけのファイルは見えない)
+	/// </summary>
+	/// <param name="image">書き出す画像</param>
+	/// <param name="cookedPath">書き出し先</param>
+	/// <returns>書き出せたか</returns>
+	bool Save(const DirectX::ScratchImage& image, const std::string& cookedPath);
+
+	/// <summary>
+	/// ディレクトリの中の画像を全て変換しておく(起動時に変換しないように、配布前などに呼ぶ)
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリ(サブディレクトリも含む)</param>
+	/// <param name="settings">圧縮の種類</param>
+	/// <returns>変換できた枚数</returns>
+	uint32_t CookDirectory(const std::string& directoryPath, const CookSettings& settings);
+}
@@ -0,0 +1,191 @@
+#include "TextureDecoder.h"
+#include "MappedFile.h"
+#include "TextureCooker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+namespace
+{
+	//拡張子を小文字で取り出す(無ければ空)
+	std::string GetExtension(const std::string& filePath)
+	{
+		size_t dot = filePath.find_last_of('.');
+		size_t separator = filePath.find_last_of("/\\");
+		if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+		{
+			return {};
+		}
+		std::string extension = filePath.substr(dot);
+		for (char& c : extension)
+		{
+			if (c >= 'A' && c <= 'Z')
+			{
+				c = static_cast<char>(c - 'A' + 'a');
+			}
+		}
+		return extension;
+	}
+
+	//メモリ上のファイルを拡張子に合わせてデコードする
+	HRESULT DecodeImage(const std::string& extension, const uint8_t* data, size_t size, DirectX::ScratchImage& image)
+	{
+		if (extension == ".dds")
+		{
+			return DirectX::LoadFromDDSMemory(data, size, DirectX::DDS_FLAGS_NONE, nullptr, image);
+		}
+		if (extension == ".tga")
+		{
+			return DirectX::LoadFromTGAMemory(data, size, DirectX::TGA_FLAGS_DEFAULT_SRGB, nullptr, image);
+		}
+		if (extension == ".hdr")
+		{
+			return DirectX::LoadFromHDRMemory(data, size, nullptr, image);
+		}
+#ifdef _WIN32
+		//COMはmainでマルチスレッドで初期化しているので、ワーカースレッドからもWICを使える
+		return DirectX::LoadFromWICMemory(data, size, DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
+#else
+		//WICはWindowsにしか無い
+		return E_FAIL;
+#endif
+	}
+}
+
+TextureDecoder::TextureDecoder(uint32_t threadCount)
+	: threadPool(threadCount)
+{
+}
+
+//デコードを積む
+void TextureDecoder::Submit(uint32_t textureIndex, const std::string& filePath)
+{
+	//設定は積んだ時点のものを使う
+	pendingDecodes.push_back({ textureIndex, threadPool.Submit([textureIndex, filePath, cookSettings = cookSettings]() { return Decode(textureIndex, filePath, cookSettings); }) });
+}
+
+//終わっているものを積んだ順に渡す
+uint32_t TextureDecoder::Drain(TextureUploadSink& sink)
+{
+	uint32_t uploadCount = 0;
+	while (!pendingDecodes.empty() && pendingDecodes.front().future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		UploadFront(sink);
+		++uploadCount;
+	}
+	return uploadCount;
+}
+
+//全て終わるまで待って渡す
+uint32_t TextureDecoder::DrainAll(TextureUploadSink& sink)
+{
+	uint32_t uploadCount = 0;
+	while (!pendingDecodes.empty())
+	{
+		UploadFront(sink);
+		++uploadCount;
+	}
+	return uploadCount;
+}
+
+//textureIndexを渡し終えるまで待つ
+bool TextureDecoder::DrainUntil(TextureUploadSink& sink, uint32_t textureIndex)
+{
+	auto it = std::find_if(pendingDecodes.begin(), pendingDecodes.end(), [textureIndex](const PendingDecode& pendingDecode) { return pendingDecode.textureIndex == textureIndex; });
+	if (it == pendingDecodes.end())
+	{
+		return false;
+	}
+	size_t uploadCount = static_cast<size_t>(it - pendingDecodes.begin()) + 1;
+	for (size_t i = 0; i < uploadCount; ++i)
+	{
+		UploadFront(sink);
+	}
+	return true;
+}
+
+//先頭を待ってから受け取り側に渡す
+void TextureDecoder::UploadFront(TextureUploadSink& sink)
+{
+	//受け取り側で例外が出ても積んだ順が崩れないよう、先に取り出す
+	PendingDecode pendingDecode = std::move(pendingDecodes.front());
+	pendingDecodes.pop_front();
+	std::unique_ptr<DecodedTexture> decodedTexture = pendingDecode.future.get();
+	assert(decodedTexture != nullptr);
+	sink.Upload(*decodedTexture);
+}
+
+//1枚分のデコードとミップマップの作成
+std::unique_ptr<DecodedTexture> TextureDecoder::Decode(uint32_t textureIndex, const std::string& filePath, const TextureCooker::CookSettings& cookSettings)
+{
+	std::unique_ptr<DecodedTexture> decodedTexture = std::make_unique<DecodedTexture>();
+	decodedTexture->textureIndex = textureIndex;
+	decodedTexture->filePath = filePath;
+
+	//＝＝＝1.ファイルを読む＝＝＝
+	MappedFile file;
+	if (!file.Open(filePath))
+	{
+		decodedTexture->result = E_FAIL;
+		return decodedTexture;
+	}
+
+	const std::string extension = GetExtension(filePath);
+	if (extension == ".dds")
+	{
+		//DDSはミップマップも圧縮も済んでいるものとしてそのまま使う
+		decodedTexture->result = DecodeImage(extension, file.GetData(), file.GetSize(), decodedTexture->mipImages);
+		file.Close();
+	}
+	else
+	{
+		//＝＝＝2.変換済みファイルがあれば、デコードもミップマップの作成もせずにそのまま使う＝＝＝
+		std::string cookedPath;
+		bool isCooked = false;
+		if (cookSettings.isEnabled)
+		{
+			cookedPath = TextureCooker::GetCookedPath(TextureCooker::ComputeKey(file.GetData(), file.GetSize(), cookSettings));
+			MappedFile cookedFile;
+			isCooked = cookedFile.Open(cookedPath) && SUCCEEDED(DirectX::LoadFromDDSMemory(cookedFile.GetData(), cookedFile.GetSize(), DirectX::DDS_FLAGS_NONE, nullptr, decodedTexture->mipImages));
+		}
+
+		if (!isCooked)
+		{
+			//＝＝＝3.デコードする＝＝＝
+			DirectX::ScratchImage image{};
+			decodedTexture->result = DecodeImage(extension, file.GetData(), file.GetSize(), image);
+			file.Close();
+			if (FAILED(decodedTexture->result))
+			{
+				return decodedTexture;
+			}
+
+			//＝＝＝4.ミップマップの作成と圧縮をして、次回のために書き出しておく＝＝＝
+			decodedTexture->result = TextureCooker::Cook(std::move(image), cookSettings, decodedTexture->mipImages);
+			if (SUCCEEDED(decodedTexture->result) && cookSettings.isEnabled)
+			{
+				//書き出せなくても(読み取り専用など)今回の読み込みには関係ない
+				TextureCooker::Save(decodedTexture->mipImages, cookedPath);
+			}
+		}
+	}
+	if (FAILED(decodedTexture->result))
+	{
+		return decodedTexture;
+	}
+
+	//＝＝＝5.転送元の並び(PrepareUploadと同じ順。3Dテクスチャはミップごとに先頭のスライスから奥行き分続く)＝＝＝
+	const DirectX::TexMetadata& mipMetadata = decodedTexture->mipImages.GetMetadata();
+	decodedTexture->subresources.reserve(mipMetadata.arraySize * mipMetadata.mipLevels);
+	for (size_t item = 0; item < mipMetadata.arraySize; ++item)
+	{
+		for (size_t mip = 0; mip < mipMetadata.mipLevels; ++mip)
+		{
+			const DirectX::Image* mipImage = decodedTexture->mipImages.GetImage(mip, item, 0);
+			assert(mipImage != nullptr);
+			decodedTexture->subresources.push_back({ mipImage->pixels, mipImage->rowPitch, mipImage->slicePitch });
+		}
+	}
+	return decodedTexture;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ThreadPool.h"
+#include "TextureCooker.h"
+
+#include "externals/DirectXTex/DirectXTex.h"
+
+//サブリソース1つ分の転送元(D3D12_SUBRESOURCE_DATAと同じ並び。デバイスが無くても作れるように自前で持つ)
+struct TextureSubresource
+{
+	const void* pixels;
+	size_t rowPitch;
+	size_t slicePitch;
+};
+
+//デコードとミップマップの作成が終わったテクスチャ
+struct DecodedTexture
+{
+	//TextureManagerが先に割り当てた番号
+	uint32_t textureIndex = UINT32_MAX;
+	std::string filePath;
+	//失敗したら読み込み・デコード・ミップマップ作成のどこかのHRESULT
+	HRESULT result = S_OK;
+	//ミップマップ付きの画像(subresourcesはここを指す)
+	DirectX::ScratchImage mipImages;
+	//PrepareUploadと同じ順(配列の要素ごとにミップの順)に並べた転送元
+	std::vector<TextureSubresource> subresources;
+};
+
+//デコードが終わったテクスチャを受け取ってGPUに転送する側(TextureManager。確認用に差し替えられる)
+class TextureUploadSink
+{
+public:
+	virtual ~TextureUploadSink() = default;
+
+	//Drainを呼んだスレッドで、積んだ順に1枚ずつ呼ばれる
+	virtual void Upload(DecodedTexture& decodedTexture) = 0;
+};
+
+//テクスチャのファイル読み込み・デコード・ミップマップ作成をスレッドプールで行う(GPUには触らない。変換済みファイルがあればそれを読む)
+class TextureDecoder
+{
+public:
+	/// <summary>
+	/// スレッドを立ち上げる
+	/// </summary>
+	/// <param name="threadCount">スレッド数(0なら論理コア数)</param>
+	explicit TextureDecoder(uint32_t threadCount = 0);
+
+	/// <summary>
+	/// デコードを積む(すぐ戻る)
+	/// </summary>
+	/// <param name="textureIndex">受け取り側で使う番号</param>
+	/// <param name="filePath">テクスチャファイルのパス</param>
+	void Submit(uint32_t textureIndex, const std::string& filePath);
+
+	//終わっているものを積んだ順に渡す(先頭が終わっていなければそこで止める)。渡した枚数を返す
+	uint32_t Drain(TextureUploadSink& sink);
+
+	//積んだものが全て終わるまで待って渡す。渡した枚数を返す
+	uint32_t DrainAll(TextureUploadSink& sink);
+
+	//textureIndexのテクスチャを渡し終えるまで待つ(その前に積んだものも渡す)。積まれていなければ何もせずfalse
+	bool DrainUntil(TextureUploadSink& sink, uint32_t textureIndex);
+
+	//まだ渡していない数
+	size_t GetPendingCount() const { return pendingDecodes.size(); }
+
+	//変換済みファイルの設定(この後に積んだものから使う)
+	void SetCookSettings(const TextureCooker::CookSettings& cookSettings) { this->cookSettings = cookSettings; }
+
+	/// <summary>
+	/// 1枚分のデコードとミップマップの作成(ワーカースレッドで呼ばれる。呼び出したスレッドでそのまま使ってもよい)
+	/// </summary>
+	/// <param name="textureIndex">受け取り側で使う番号</param>
+	/// <param name="filePath">テクスチャファイルのパス(.dds/.tga/.hdr以外はWICで読む)</param>
+	/// <param name="cookSettings">変換済みファイルの設定(有効なら変換済みファイルを優先し、無ければ書き出す)</param>
+	static std::unique_ptr<DecodedTexture> Decode(uint32_t textureIndex, const std::string& filePath, const TextureCooker::CookSettings& cookSettings);
+
+private:
+	//積んだデコード1つ分
+	struct PendingDecode {
+		uint32_t textureIndex;
+		std::future<std::unique_ptr<DecodedTexture>> future;
+	};
+
+	//先頭を待ってから受け取り側に渡す
+	void UploadFront(TextureUploadSink& sink);
+
+	//積んだ順(受け取り側に渡す順)
+	std::deque<PendingDecode> pendingDecodes;
+	TextureCooker::CookSettings cookSettings{};
+	//pendingDecodesより後に宣言して、先にスレッドを止める
+	ThreadPool threadPool;
+};
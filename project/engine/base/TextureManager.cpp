@@ -2,6 +2,9 @@
 #include "DirectXBase.h"
 
 #include <d3d12.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
 
 #include "externals/DirectXTex/d3dx12.h"
 
@@ -10,49 +13,178 @@ TextureManager* TextureManager::instance = nullptr;
 //ImGuiで0番を使用するため、1番から利用
 uint32_t TextureManager::kSRVIndexTop = 1;
 
+namespace
+{
+	//白いテクスチャを登録するパス(ファイルのパスとは重ならない)
+	const char* const kDefaultTexturePath = "<default white>";
+}
+
 //テクスチャファイル読み込み関数
-void TextureManager::LoadTexture(const std::string& filePath)
+TextureHandle TextureManager::LoadTexture(const std::string& filePath)
 {
-	//読み込み枚数上限チェック
-	assert(textureDatas.size() + kSRVIndexTop < DirectXBase::kMaxSRVCount);
-	//読み込み済みテクスチャを検索
-	auto it = std::find_if(textureDatas.begin(), textureDatas.end(), [&](TextureData& textureData) {return textureData.filePath == filePath; });
-	if (it != textureDatas.end())
+	//読み込み済みテクスチャを検索(正規化したパスで引くので、書き方が違っても同じテクスチャになる)
+	std::string normalizedPath = NormalizePath(filePath);
+	auto it = filePaths.find(normalizedPath);
+	if (it != filePaths.end())
+	{
+		//読み込み済みなら早期return(読み込み中ならGPUに転送し終えるまで待つ)
+		if (batchDepth == 0)
+		{
+			WaitForTexture({ it->second });
+		}
+		return { it->second };
+	}
+
+	//①Textureデータを読む(ファイル読み込み・デコード・ミップマップの作成はワーカースレッドで行う)
+	const uint32_t textureIndex = ReserveTexture(std::move(normalizedPath));
+	decoder->Submit(textureIndex, filePath);
+
+	if (batchDepth == 0)
+	{
+		//1枚だけならその場で転送を終わらせる
+		WaitForTexture({ textureIndex });
+	}
+	//まとめて読み込み中なら、EndBatchでデコードを待って転送する
+	return { textureIndex };
+}
+
+//テクスチャファイルの読み込みを始める
+TextureHandle TextureManager::LoadTextureAsync(const std::string& filePath)
+{
+	std::string normalizedPath = NormalizePath(filePath);
+	auto it = filePaths.find(normalizedPath);
+	if (it != filePaths.end())
+	{
+		return { it->second };
+	}
+
+	const uint32_t textureIndex = ReserveTexture(std::move(normalizedPath));
+	decoder->Submit(textureIndex, filePath);
+	return { textureIndex };
+}
+
+//デコードが終わったテクスチャをGPUに転送する
+void TextureManager::Update()
+{
+	//まとめて読み込み中はEndBatchに任せる
+	if (batchDepth != 0)
+	{
+		return;
+	}
+	if (decoder->Drain(*this) != 0)
+	{
+		FlushUploads();
+	}
+}
+
+//GPUに転送し終えて使えるか
+bool TextureManager::IsTextureResident(TextureHandle textureHandle)
+{
+	//範囲外指定違反チェック
+	assert(textureHandle.index < textureDatas.size());
+	return textureDatas[textureHandle.index].isResident;
+}
+
+//GPUに転送し終えるまで待つ
+void TextureManager::WaitForTexture(TextureHandle textureHandle)
+{
+	//範囲外指定違反チェック
+	assert(textureHandle.index < textureDatas.size());
+	if (textureDatas[textureHandle.index].isResident)
+	{
+		return;
+	}
+
+	//積んだ順に転送するので、それより前に積んだものも一緒に転送する
+	decoder->DrainUntil(*this, textureHandle.index);
+	FlushUploads();
+	assert(textureDatas[textureHandle.index].isResident);
+}
+
+//変換済みファイルの設定
+void TextureManager::SetCookSettings(const TextureCooker::CookSettings& cookSettings)
+{
+	decoder->SetCookSettings(cookSettings);
+}
+
+//まとめて読み込みを始める
+void TextureManager::BeginBatch()
+{
+	++batchDepth;
+}
+
+//まとめて読み込みを終える
+void TextureManager::EndBatch()
+{
+	assert(batchDepth != 0);
+	if (--batchDepth != 0)
 	{
-		//読み込み済みなら早期return
+		//外側のEndBatchでまとめて転送する
 		return;
 	}
+	//積んだデコードが全て終わるのを待って、転送を1回で実行する
+	decoder->DrainAll(*this);
+	if (!pendingTextureIndices.empty())
+	{
+		FlushUploads();
+	}
+}
+
+//番号とパスを割り当てる
+uint32_t TextureManager::ReserveTexture(std::string normalizedPath)
+{
+	//読み込み枚数上限チェック
+	assert(textureDatas.size() + kSRVIndexTop < DirectXBase::kMaxSRVCount);
 
-	//①Textureデータを読む
-	//テクスチャファイルを読んでプログラムで扱えるようにする
-	DirectX::ScratchImage image{};
-	std::wstring filePathW = StringUtility::ConvertString(filePath);
-	HRESULT hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
-	assert(SUCCEEDED(hr));
-	//ミップマップの作成
-	DirectX::ScratchImage mipImages{};
-	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImages);
-	assert(SUCCEEDED(hr));
-	//ミップマップ付きのデータを返す
-	//return mipImages;
 	//テクスチャデータを追加
 	textureDatas.resize(textureDatas.size() + 1);
 	//追加したテクスチャデータの参照を取得する
 	TextureData& textureData = textureDatas.back();
 
-	textureData.filePath = filePath;
-	textureData.metadata = mipImages.GetMetadata();
+	//パスを登録して、テクスチャデータからはその文字列を指す
+	const uint32_t textureIndex = static_cast<uint32_t>(textureDatas.size() - 1);
+	textureData.filePath = filePaths.emplace(std::move(normalizedPath), textureIndex).first->first;
+
+	//テクスチャデータの要素数番号をSRVのインデックスとする
+	uint32_t srvIndex = textureIndex + kSRVIndexTop;
+	textureData.srvHandleCPU = dxBase->GetSRVCPUDescriptorHandle/*CPUハンドルを取得*/(srvIndex);
+	textureData.srvHandleGPU = dxBase->GetSRVGPUDescriptorHandle/*GPUハンドルを取得*/(srvIndex);
+
+	//転送し終えるまでに描画されても読めるように、何も指さないSRVを置いておく
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = 1;
+	dxBase->GetDevice()->CreateShaderResourceView(nullptr, &srvDesc, textureData.srvHandleCPU);
+
+	return textureIndex;
+}
+
+//デコードが終わったテクスチャを転送する
+void TextureManager::Upload(DecodedTexture& decodedTexture)
+{
+	//読み込み・デコード・ミップマップの作成のどこかで失敗していないか
+	assert(SUCCEEDED(decodedTexture.result));
+	assert(decodedTexture.textureIndex < textureDatas.size());
+	TextureData& textureData = textureDatas[decodedTexture.textureIndex];
+
+	//②DirectX12のTextureResourceを作る
+	textureData.metadata = decodedTexture.mipImages.GetMetadata();
 	textureData.resource = dxBase->CreateTextureResource(textureData.metadata);
 
-	
 	//テクスチャデータ転送
-	//③TextureResourceにデータを転送する
-	//[[nodiscard]]
+	//③TextureResourceにデータを転送する(並びはワーカースレッドで作ってあるので、ここではコマンドを積むだけ)
 	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
-	DirectX::PrepareUpload(dxBase->GetDevice(), mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), subresources);
+	subresources.reserve(decodedTexture.subresources.size());
+	for (const TextureSubresource& subresource : decodedTexture.subresources)
+	{
+		subresources.push_back({ subresource.pixels, static_cast<LONG_PTR>(subresource.rowPitch), static_cast<LONG_PTR>(subresource.slicePitch) });
+	}
 	uint64_t intermediateSize = GetRequiredIntermediateSize(textureData.resource.Get(), 0, UINT(subresources.size()));
-	Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResource = dxBase->CreateBufferResource(intermediateSize);
-	UpdateSubresources(dxBase->GetCommandList(), textureData.resource.Get(), intermediateResource.Get(), 0, 0, UINT(subresources.size()), subresources.data());
+	//中間リソースは使い回しのバッファから切り出す(GPUが使い終わったらDirectXBaseが回収する)
+	StagingAllocation staging = dxBase->AllocateStaging(intermediateSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	UpdateSubresources(dxBase->GetCommandList(), textureData.resource.Get(), staging.resource, staging.offset, 0, UINT(subresources.size()), subresources.data());
 	//Texture転送後は利用できるよう、D3D12_RESOURCE_STATE_COPY_DESTからD3D12_RESOURCE_STATE_GENERIC_READへResourceStateを変更する
 	D3D12_RESOURCE_BARRIER barrier{};
 	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -63,59 +195,77 @@ void TextureManager::LoadTexture(const std::string& filePath)
 	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
 	dxBase->GetCommandList()->ResourceBarrier(1, &barrier);
 
-	// ExcueCommand
-	dxBase->ExcuteCommand();
-	// WaitForSignal
-	dxBase->WaitForSignal();
-	// CommansReset
-	dxBase->CommandReset();
-
-	
+	//FlushUploadsでGPUの転送が終わったら使えるようにする
+	pendingTextureIndices.push_back(decodedTexture.textureIndex);
 
-	//SRVの生成
+	//SRVの生成(何も指さないSRVを置き換える)
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
 	//SRVの設定を行う
 	srvDesc.Format = textureData.metadata.format;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Texture2D.MipLevels = UINT(textureData.metadata.mipLevels);
-	////先頭はImGuiが使っているのでその次を使う
-	//D3D12_CPU_DESCRIPTOR_HANDLE textureSrvHandleCPU = dxBase->GetSRVCPUDescriptorHandle(1);
-	//D3D12_GPU_DESCRIPTOR_HANDLE textureSrvHandleGPU = dxBase->GetSRVGPUDescriptorHandle(1);
-	//テクスチャデータの要素数番号をSRVのインデックスとする
-	uint32_t srvIndex = static_cast<uint32_t>(textureDatas.size() - 1) + kSRVIndexTop;
-	textureData.srvHandleCPU = dxBase->GetSRVCPUDescriptorHandle/*CPUハンドルを取得*/(srvIndex);
-	textureData.srvHandleGPU = dxBase->GetSRVGPUDescriptorHandle/*GPUハンドルを取得*/(srvIndex);
-
 	dxBase->GetDevice()->CreateShaderResourceView(textureData.resource.Get(), &srvDesc, textureData.srvHandleCPU);
+}
 
-	// テクスチャを追加
-	textureDatas.push_back(textureData);
+//積んだ転送を実行して、終わるまで待つ
+void TextureManager::FlushUploads()
+{
+	// ExcueCommand
+	dxBase->ExcuteCommand();
+	// WaitForSignal
+	dxBase->WaitForSignal();
+	// CommansReset
+	dxBase->CommandReset();
+
+	//GPUの転送が終わったので、テクスチャを使えるようにする
+	for (uint32_t textureIndex : pendingTextureIndices)
+	{
+		textureDatas[textureIndex].isResident = true;
+	}
+	pendingTextureIndices.clear();
 }
 
-uint32_t TextureManager::GetTextureIndexByFilePath(const std::string& filePath)
+TextureHandle TextureManager::GetTextureHandle(const std::string& filePath)
 {
-	auto it = std::find_if(textureDatas.begin(), textureDatas.end(), [&](TextureData& textureData) {return textureData.filePath == filePath; }/*テクスチャデータ検索*/);
-	if (it != textureDatas.end())
+	auto it = filePaths.find(NormalizePath(filePath)/*テクスチャデータ検索*/);
+	if (it != filePaths.end())
 	{
 		//読み込み済みなら要素番号を返す
-		uint32_t textureIndex = static_cast<uint32_t>(std::distance(textureDatas.begin(), it));
-		return textureIndex;
+		return { it->second };
 	}
 
 	assert(0);
-	return 0;
+	return {};
 }
 
-D3D12_GPU_DESCRIPTOR_HANDLE TextureManager::GetSrvHandleGPU(uint32_t textureIndex)
+D3D12_GPU_DESCRIPTOR_HANDLE TextureManager::GetSrvHandleGPU(TextureHandle textureHandle)
 {
 	//範囲外指定違反チェック
-	assert(textureIndex < textureDatas.size());
+	assert(textureHandle.index < textureDatas.size());
 
-	TextureData& textureData = textureDatas[textureIndex];/*テクスチャデータの参照*/
+	TextureData& textureData = textureDatas[textureHandle.index];/*テクスチャデータの参照*/
 	return textureData.srvHandleGPU;
 }
 
+//白い1x1のテクスチャを作って転送する
+void TextureManager::CreateDefaultTexture()
+{
+	DecodedTexture decodedTexture{};
+	decodedTexture.textureIndex = ReserveTexture(kDefaultTexturePath);
+	decodedTexture.filePath = kDefaultTexturePath;
+	decodedTexture.result = decodedTexture.mipImages.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, 1, 1, 1, 1);
+	assert(SUCCEEDED(decodedTexture.result));
+	const DirectX::Image* image = decodedTexture.mipImages.GetImage(0, 0, 0);
+	std::memset(image->pixels, 0xFF, image->slicePitch);
+	decodedTexture.subresources.push_back({ image->pixels, image->rowPitch, image->slicePitch });
+
+	//デコードしたテクスチャと同じように転送する
+	Upload(decodedTexture);
+	FlushUploads();
+	defaultTextureHandle = { decodedTexture.textureIndex };
+}
+
 TextureManager* TextureManager::GetInstance()
 {
 	if (instance == nullptr)
@@ -130,6 +280,11 @@ void TextureManager::Initialize(DirectXBase* dxBase)
 	this->dxBase = dxBase;
 	//SRVの数と同数
 	textureDatas.reserve(DirectXBase::kMaxSRVCount);
+	filePaths.reserve(DirectXBase::kMaxSRVCount);
+	//メインスレッドの分は残しておく
+	decoder = std::make_unique<TextureDecoder>((std::max)(std::thread::hardware_concurrency(), 2u) - 1);
+	//テクスチャの無いマテリアルを描くときに前のテクスチャが残らないように、白いテクスチャを用意しておく
+	CreateDefaultTexture();
 }
 
 void TextureManager::Finalize()
@@ -139,11 +294,57 @@ void TextureManager::Finalize()
 }
 
 //メタデータ取得
-const DirectX::TexMetadata& TextureManager::GetMetaData(uint32_t textureIndex)
+const DirectX::TexMetadata& TextureManager::GetMetaData(TextureHandle textureHandle)
 {
 	// 範囲外指定違反チェック
-	assert(textureIndex < textureDatas.size());
+	assert(textureHandle.index < textureDatas.size());
 
-	TextureData& textureData = textureDatas[textureIndex];
+	//大きさなどはデコードするまでわからない
+	WaitForTexture(textureHandle);
+	TextureData& textureData = textureDatas[textureHandle.index];
 	return textureData.metadata;
+}
+
+//パスの正規化
+std::string TextureManager::NormalizePath(const std::string& filePath)
+{
+	//区切りごとに分けて、"."は飛ばし、".."は1つ前を取り消す
+	std::vector<std::string_view> parts;
+	std::string_view rest = filePath;
+	while (!rest.empty())
+	{
+		size_t separator = rest.find_first_of("/\\");
+		std::string_view part = rest.substr(0, separator);
+		rest = separator == std::string_view::npos ? std::string_view() : rest.substr(separator + 1);
+		if (part.empty() || part == ".")
+		{
+			continue;
+		}
+		if (part == ".." && !parts.empty() && parts.back() != "..")
+		{
+			parts.pop_back();
+			continue;
+		}
+		parts.push_back(part);
+	}
+
+	//'/'でつないで、Windowsのファイル名は大文字と小文字を区別しないので小文字に揃える
+	std::string normalizedPath;
+	normalizedPath.reserve(filePath.size());
+	for (std::string_view part : parts)
+	{
+		if (!normalizedPath.empty())
+		{
+			normalizedPath += '/';
+		}
+		normalizedPath += part;
+	}
+	for (char& c : normalizedPath)
+	{
+		if (c >= 'A' && c <= 'Z')
+		{
+			c = static_cast<char>(c - 'A' + 'a');
+		}
+	}
+	return normalizedPath;
 }
\ No newline at end of file
@@ -1,16 +1,30 @@
 #pragma once
 
 #include <string>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
 #include <wrl.h>
 #include <d3d12.h>
 #include <vector>
 #include "DirectXBase.h"
+#include "TextureDecoder.h"
 
 #include "externals/DirectXTex/DirectXTex.h"
 
 class DirectXBase;
 
-class TextureManager
+//テクスチャの番号(SRVの並びと同じ。読み込んだテクスチャは終了まで残るので番号は変わらない。
+//LoadTextureAsyncで受け取った直後はまだGPUに無いので、IsTextureResidentで確かめる)
+struct TextureHandle
+{
+	uint32_t index = UINT32_MAX;
+
+	bool IsValid() const { return index != UINT32_MAX; }
+	bool operator==(const TextureHandle&) const = default;
+};
+
+class TextureManager : private TextureUploadSink
 {
 public:
 	//シングルインインスタンスの取得
@@ -20,22 +34,52 @@ public:
 	void Initialize(DirectXBase* dxBase);
 
 	/// <summary>
-	/// テクスチャファイルの読み込み
+	/// テクスチャファイルの読み込み(読み込み済みならハンドルをすぐ返す。GPUに転送し終えるまで待つ)
 	/// </summary>
 	/// <param name="filePath">テクスチャファイルのパス</param>
-	void LoadTexture(const std::string& filePath);
+	TextureHandle LoadTexture(const std::string& filePath);
+
+	/// <summary>
+	/// テクスチャファイルの読み込みを始める(デコードとミップマップの作成はワーカースレッドで行い、ハンドルはすぐ返す)
+	/// </summary>
+	/// <param name="filePath">テクスチャファイルのパス</param>
+	TextureHandle LoadTextureAsync(const std::string& filePath);
+
+	//デコードが終わったテクスチャをGPUに転送する(毎フレーム、PreDrawの前に呼ぶ)
+	void Update();
+
+	//GPUに転送し終えて使えるか(転送前のSRVは何も指していないので黒く描かれる)
+	bool IsTextureResident(TextureHandle textureHandle);
+
+	//GPUに転送し終えるまで待つ
+	void WaitForTexture(TextureHandle textureHandle);
+
+	//変換済みファイル(ミップマップ付きDDS)の設定(この後に読み込むものから使う。既定では圧縮せずに変換する)
+	void SetCookSettings(const TextureCooker::CookSettings& cookSettings);
 
-	//SRVインデックスの開始番号
-	uint32_t GetTextureIndexByFilePath(const std::string& filePath);
+	//まとめて読み込みを始める(EndBatchまでのLoadTextureはデコードを積むだけで、待たない)
+	void BeginBatch();
 
-	//テクスチャ番号からGPUハンドルを取得
-	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(uint32_t textureIndex);
+	//まとめて読み込みを終える(積んだデコードを待って、転送を1回で実行して待つ。入れ子にした場合は一番外側で実行する)
+	void EndBatch();
+
+	//ファイルパスからハンドルを取得(読み込み済みであること)
+	TextureHandle GetTextureHandle(const std::string& filePath);
+
+	//ハンドルからGPUハンドルを取得
+	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(TextureHandle textureHandle);
+
+	//テクスチャの無いマテリアルに使う白い1x1のテクスチャ(Initializeで作る)
+	TextureHandle GetDefaultTextureHandle() const { return defaultTextureHandle; }
 
 	//終了
 	void Finalize();
 
-	//メタデータを取得
-	const DirectX::TexMetadata& GetMetaData(uint32_t textureIndex);
+	//メタデータを取得(デコードが終わっていなければ転送し終えるまで待つ)
+	const DirectX::TexMetadata& GetMetaData(TextureHandle textureHandle);
+
+	//同じファイルが同じ文字列になるようにパスを揃える(区切りを'/'に、"."と".."を畳み、英字を小文字に)
+	static std::string NormalizePath(const std::string& filePath);
 
 private:
 	//シングルトン
@@ -44,13 +88,28 @@ private:
 
 	//テクスチャデータ1枚分のデータ
 	struct TextureData {
-		std::string filePath;
+		//filePathsのキー(正規化したパス)を指す
+		std::string_view filePath;
 		DirectX::TexMetadata metadata{};
 		Microsoft::WRL::ComPtr<ID3D12Resource> resource = nullptr;
 		D3D12_CPU_DESCRIPTOR_HANDLE srvHandleCPU{};
 		D3D12_GPU_DESCRIPTOR_HANDLE srvHandleGPU{};
+		//GPUに転送し終えたか
+		bool isResident = false;
 	}textureData;
 
+	//番号とパスを割り当てて、転送するまでの間は何も指さないSRVを作っておく
+	uint32_t ReserveTexture(std::string normalizedPath);
+
+	//デコードが終わったテクスチャのリソースを作って転送を積み、SRVを作る(TextureDecoderから呼ばれる)
+	void Upload(DecodedTexture& decodedTexture) override;
+
+	//積んだ転送を実行して、終わるまで待つ
+	void FlushUploads();
+
+	//白い1x1のテクスチャを作って転送する
+	void CreateDefaultTexture();
+
 	TextureManager() = default;
 	~TextureManager() = default;
 	TextureManager(TextureManager*) = delete;
@@ -58,6 +117,19 @@ private:
 
 	//テクスチャデータ
 	std::vector<TextureData> textureDatas;
+	//正規化したパスからテクスチャ番号を引く(パスの文字列はここに1つだけ持つ)
+	std::unordered_map<std::string, uint32_t> filePaths;
+
+	//BeginBatchの入れ子の深さ
+	uint32_t batchDepth = 0;
+	//転送し終えたら使えるようになるテクスチャ
+	std::vector<uint32_t> pendingTextureIndices;
+
+	//ファイル読み込み・デコード・ミップマップ作成を行うワーカースレッド
+	std::unique_ptr<TextureDecoder> decoder;
+
+	//テクスチャの無いマテリアルに使う白いテクスチャ
+	TextureHandle defaultTextureHandle{};
 
 	DirectXBase* dxBase;
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+	}
+	workers.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i)
+	{
+		workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	condition.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+//スレッドごとの処理
+void ThreadPool::WorkerLoop()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]() { return isStopping || !tasks.empty(); });
+			//止めるときも、積まれている処理は最後まで実行する
+			if (tasks.empty())
+			{
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//決まった数のスレッドで、積まれた処理を順に実行する
+class ThreadPool
+{
+public:
+	/// <summary>
+	/// スレッドを立ち上げる
+	/// </summary>
+	/// <param name="threadCount">スレッド数(0なら論理コア数)</param>
+	explicit ThreadPool(uint32_t threadCount = 0);
+	//残っている処理を全て終えてからスレッドを止める
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//処理を積む(戻り値はfutureで受け取る)
+	template <typename Function>
+	std::future<std::invoke_result_t<std::decay_t<Function>>> Submit(Function&& function);
+
+	//getter
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+private:
+	//スレッドごとの処理(処理が積まれるのを待って実行する)
+	void WorkerLoop();
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool isStopping = false;
+};
+
+template <typename Function>
+std::future<std::invoke_result_t<std::decay_t<Function>>> ThreadPool::Submit(Function&& function)
+{
+	using Result = std::invoke_result_t<std::decay_t<Function>>;
+	//std::functionはコピーできるものしか持てないので、packaged_taskはshared_ptrで包む
+	auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+	std::future<Result> future = task->get_future();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.emplace_back([task]() { (*task)(); });
+	}
+	condition.notify_one();
+	return future;
+}
@@ -0,0 +1,67 @@
+#include "UploadRing.h"
+#include "DirectXBase.h"
+
+#include <algorithm>
+#include <cassert>
+
+//初期化
+void UploadRing::Initialize(DirectXBase* dxBase, uint64_t capacity)
+{
+	this->dxBase = dxBase;
+	buffer = dxBase->CreateBufferResource(static_cast<size_t>(capacity));
+	//アップロードヒープは書き込めるままにしておける
+	void* data = nullptr;
+	HRESULT hr = buffer->Map(0, nullptr, &data);
+	assert(SUCCEEDED(hr));
+	mappedData = static_cast<uint8_t*>(data);
+	allocator.Initialize(capacity);
+}
+
+//転送元の領域を切り出す
+StagingAllocation UploadRing::Allocate(uint64_t size, uint64_t alignment)
+{
+	uint64_t offset = allocator.Allocate(size, alignment);
+	//GPUが使っている分が空けば入るなら、古いものから待つ
+	while (offset == StagingRingAllocator::kInvalidOffset && allocator.GetOldestPendingFenceValue() != 0)
+	{
+		const uint64_t fenceValue = allocator.GetOldestPendingFenceValue();
+		dxBase->WaitForFenceValue(fenceValue);
+		Retire(dxBase->GetCompletedFenceValue());
+		offset = allocator.Allocate(size, alignment);
+	}
+	if (offset != StagingRingAllocator::kInvalidOffset)
+	{
+		return { buffer.Get(), offset, mappedData + offset };
+	}
+
+	//輪より大きいか、積んでいる途中のコマンドだけで埋まっているので、この転送のためだけに作る
+	DedicatedBuffer dedicatedBuffer{ dxBase->CreateBufferResource(static_cast<size_t>(size)), 0 };
+	void* data = nullptr;
+	HRESULT hr = dedicatedBuffer.resource->Map(0, nullptr, &data);
+	assert(SUCCEEDED(hr));
+	dedicatedBuffers.push_back(dedicatedBuffer);
+	return { dedicatedBuffer.resource.Get(), 0, static_cast<uint8_t*>(data) };
+}
+
+//前回から切り出した領域を記録する
+void UploadRing::Submit(uint64_t fenceValue)
+{
+	allocator.Submit(fenceValue);
+	for (DedicatedBuffer& dedicatedBuffer : dedicatedBuffers)
+	{
+		if (dedicatedBuffer.fenceValue == 0)
+		{
+			dedicatedBuffer.fenceValue = fenceValue;
+		}
+	}
+}
+
+//フェンスが進んだ分を使い回せるようにする
+void UploadRing::Retire(uint64_t completedFenceValue)
+{
+	allocator.Retire(completedFenceValue);
+	//専用に作ったバッファは使い終わったら解放する
+	std::erase_if(dedicatedBuffers, [completedFenceValue](const DedicatedBuffer& dedicatedBuffer) {
+		return dedicatedBuffer.fenceValue != 0 && dedicatedBuffer.fenceValue <= completedFenceValue;
+	});
+}
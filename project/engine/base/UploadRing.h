@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <wrl.h>
+#include <d3d12.h>
+#include "StagingRingAllocator.h"
+
+class DirectXBase;
+
+//転送元として使う領域(転送のコマンドを積んだフェンスが完了するまで有効)
+struct StagingAllocation
+{
+	ID3D12Resource* resource = nullptr;
+	//resourceの中の先頭
+	uint64_t offset = 0;
+	//CPUから書き込む先(resourceの先頭ではなくoffsetの位置)
+	uint8_t* mappedData = nullptr;
+};
+
+//アップロードヒープに1つだけ作ったバッファを切り出して、転送の中間リソースに使い回す
+class UploadRing
+{
+public:
+	/// <summary>
+	/// 初期化(バッファを作って、終了まで書き込めるようにしておく)
+	/// </summary>
+	/// <param name="dxBase">バッファの生成とフェンスの待機に使う</param>
+	/// <param name="capacity">バッファの大きさ(バイト)</param>
+	void Initialize(DirectXBase* dxBase, uint64_t capacity);
+
+	/// <summary>
+	/// 転送元の領域を切り出す(入りきらない大きさなら、その1回のためだけにバッファを作る)
+	/// </summary>
+	/// <param name="size">大きさ(バイト)</param>
+	/// <param name="alignment">オフセットの揃え(テクスチャならD3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT)</param>
+	StagingAllocation Allocate(uint64_t size, uint64_t alignment);
+
+	//前回から切り出した領域を、このフェンス値をシグナルしたコマンドが使うものとして記録する
+	void Submit(uint64_t fenceValue);
+
+	//フェンスが完了値まで進んだ分を使い回せるようにする
+	void Retire(uint64_t completedFenceValue);
+
+private:
+	//輪に入りきらなかった転送のために作ったバッファ
+	struct DedicatedBuffer {
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		//0ならまだSubmitしていない
+		uint64_t fenceValue;
+	};
+
+	DirectXBase* dxBase = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12Resource> buffer = nullptr;
+	uint8_t* mappedData = nullptr;
+	StagingRingAllocator allocator;
+	std::vector<DedicatedBuffer> dedicatedBuffers;
+};
@@ -8,6 +8,10 @@
 #include "Sprite.h"
 #include "SpriteBase.h"
 #include "TextureManager.h"
+#include "TransformGraph.h"
+#include "Culling.h"
+#include "ModelManager.h"
+#include "TextureCooker.h"
 
 #include <format>
 #include <d3d12.h>
@@ -16,125 +20,14 @@
 #include <dxgidebug.h>
 #include <dxcapi.h>
 #include <iostream>
+#include <string_view>
 
 using namespace Microsoft::WRL;
 
-//MaterialData構造体と読み込み関数
-MaterialData LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename)
-{
-	//＝＝＝1.中で必要となる変数の宣言＝＝＝
-	MaterialData materialData;//構築するMaterialData
-	std::string line;
-	//＝＝＝2.ファイルを開く＝＝＝
-	std::ifstream file(directoryPath + "/" + filename);
-	assert(file.is_open());
-	//＝＝＝3.実際にファイルを読み、ModelDataを構築していく＝＝＝
-	while (std::getline(file, line))
-	{
-		std::string identifier;
-		std::istringstream s(line);
-		s >> identifier;//先頭の識別子を読む
-
-		//identifierに応じた処理
-		if (identifier == "map_Kd")
-		{
-			std::string textureFilename;
-			s >> textureFilename;
-			materialData.textureFilePath = directoryPath + "/" + textureFilename;
-		}
-	}
-	//＝＝＝4.materialDataを返す＝＝＝
-	return materialData;
-}
-
-//ModelData構造体と読み込み関数
-ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename)
-{
-	//＝＝＝1.中で必要となる変数の宣言＝＝＝
-	ModelData modelData;//構築するModelData
-	std::vector<Vector4> positions;//位置
-	std::vector<Vector3> normals;//法線
-	std::vector<Vector2> texcoords;//テクスチャ座標
-	std::string line;//ファイルから読んだ1行を格納するもの
-	//＝＝＝2.ファイルを開く＝＝＝
-	std::ifstream file(directoryPath + "/" + filename);
-	assert(file.is_open());
-	//＝＝＝3.実際にファイルを読み、ModelDataを構築していく＝＝＝
-	while (std::getline(file, line))
-	{
-		std::string identifier;
-		std::istringstream s(line);
-		s >> identifier;//先頭の識別子を読む
-
-		//identifierに応じた処理
-		if (identifier == "v")
-		{
-			Vector4 position;
-			s >> position.x >> position.y >> position.z;
-			position.w = 1.0f;
-			positions.push_back(position);
-		}
-		else if (identifier == "vt")
-		{
-			Vector2 texcoord;
-			s >> texcoord.x >> texcoord.y;
-			texcoords.push_back(texcoord);
-		}
-		else if (identifier == "vn")
-		{
-			Vector3 normal;
-			s >> normal.x >> normal.y >> normal.z;
-			normals.push_back(normal);	 
-		}
-		else if (identifier == "f")
-		{
-			VertexData triangle[3];
-			//面は三角形限定
-			for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex)
-			{
-				std::string vertexDefinition;
-				s >> vertexDefinition;
-				//
-				std::istringstream v(vertexDefinition);
-				uint32_t elementIndices[3];
-				for (uint32_t element = 0; element < 3; ++element)
-				{
-					std::string index;
-					std::getline(v, index, '/');//
-					elementIndices[element] = std::stoi(index);
-				}
-				//要素へのIndexから、実際の要素の値を取得して頂点を構築する
-				Vector4 position = positions[elementIndices[0] - 1];
-				position.x *= -1.0f;
-				Vector2 texcoord = texcoords[elementIndices[1] - 1];
-				texcoord.y = 1.0f - texcoord.y;
-				Vector3 normal = normals[elementIndices[2] - 1];
-				//normal.x *= -1.0f;
-				VertexData vertex = { position,texcoord };
-				//modelData.vertices.push_back(vertex);
-				triangle[faceVertex] = { position,texcoord/*, normal*/ };
-			}
-
-			//頂点を逆順で登録することで、回り順を逆にする
-			modelData.vertices.push_back(triangle[2]);
-			modelData.vertices.push_back(triangle[1]);
-			modelData.vertices.push_back(triangle[0]);
-		}
-		else if (identifier == "mtllib")
-		{
-			std::string materialFilename;
-			s >> materialFilename;
-			modelData.material = LoadMaterialTemplateFile(directoryPath, materialFilename);
-		}
-	}
-	//＝＝＝4.ModelDataを返す＝＝＝
-	return modelData;
-}
-
 ///＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝＝///
 
 //Windowsアプリでのエントリーポイント(main関数)
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR lpCmdLine, int)
 {
 #ifdef _DEBUG
 	Microsoft::WRL::ComPtr<ID3D12Debug1> debugController;
@@ -147,6 +40,32 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 	//COMの初期化
 	HRESULT hr = CoInitializeEx(0, COINIT_MULTITHREADED);
 
+	//--texture-compression=none|bc1|bc3|bc7 でテクスチャのブロック圧縮を指定する(変換と実行時の読み込みで同じ指定にすること)
+	TextureCooker::CookSettings cookSettings{};
+	const std::string_view commandLine(lpCmdLine);
+	constexpr std::string_view kCompressionOption = "--texture-compression=";
+	if (size_t optionPosition = commandLine.find(kCompressionOption); optionPosition != std::string_view::npos)
+	{
+		std::string_view compressionName = commandLine.substr(optionPosition + kCompressionOption.size());
+		compressionName = compressionName.substr(0, compressionName.find(' '));
+		if (!TextureCooker::ParseCompression(compressionName, cookSettings.compression))
+		{
+			Logger::Log(std::format("unknown texture compression: {} (none, bc1, bc3, bc7)\n", compressionName));
+			CoUninitialize();
+			return 1;
+		}
+	}
+
+	//--cook-texturesならresourcesの画像を全て変換済みファイルにして終わる(配布前に一度実行しておく)
+	if (commandLine.find("--cook-textures") != std::string_view::npos)
+	{
+		//実行時も同じ圧縮の指定で読み込めば、変換済みファイルがそのまま使われる
+		uint32_t cookedCount = TextureCooker::CookDirectory("resources", cookSettings);
+		Logger::Log(std::format("cooked {} textures\n", cookedCount));
+		CoUninitialize();
+		return 0;
+	}
+
 	//ポインタ
 	Input* input = nullptr;
 	WindowsAPI* windowsAPI = nullptr;
@@ -182,10 +101,16 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 
 	//テクスチャマネージャーの初期化
 	TextureManager::GetInstance()->Initialize(dxBase);
+	TextureManager::GetInstance()->SetCookSettings(cookSettings);
+
+	//モデルマネージャーの初期化
+	ModelManager::GetInstance()->Initialize(dxBase);
 
-	//Textureを読んで転送する
+	//Textureを読んで転送する(転送はまとめて1回で待つ)
+	TextureManager::GetInstance()->BeginBatch();
 	TextureManager::GetInstance()->LoadTexture("resources/uvChecker.png");
 	TextureManager::GetInstance()->LoadTexture("resources/monsterBall.png");
+	TextureManager::GetInstance()->EndBatch();
 
 #pragma region 基盤システムの初期化
 
@@ -201,6 +126,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 	Sprite* sprite = new Sprite();
 	sprite->Initialize(spriteBase, "resources/uvChecker.png");
 	sprite->Initialize(spriteBase, "resources/monsterBall.png");
+	//スプライトの親子関係(変更のあったスプライトだけ行列を計算し直す)
+	TransformGraph transformGraph;
+
 	//複数枚描画
 	std::vector<Sprite*> sprites;
 	for (uint32_t i = 0; i < 5; ++i)
@@ -222,8 +150,13 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 		sprites[i]->SetTextureSize(Vector2(64.0f + 64.0f*i, 64.0f + 64.0f * i));
 		sprites[i]->SetIsFilpY(true);
 		sprites[i]->SetIsFilpX(true);
+		sprites[i]->AttachTransformGraph(&transformGraph);
 	}
 
+	//カリング用(毎フレーム確保し直さないように使い回す)
+	ScreenRectBounds spriteScreenRects;
+	std::vector<uint32_t> visibleSpriteIndices;
+
 #pragma endregion 最初のシーンの初期化
 
 	///////////
@@ -249,6 +182,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 		//キー入力の更新
 		input->Update();
 
+		//デコードが終わったテクスチャをGPUに転送する(コマンドを積み始める前に行う)
+		TextureManager::GetInstance()->Update();
+
 		//数字の0キーが押されていたら
 		//if (input->PushKey(DIK_0))
 		if (input->TriggerKey(DIK_A))
@@ -312,12 +248,16 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 
 		//描画処理
 		sprite->Draw();
-		for (Sprite* sprite:sprites)
+		//画面外のスプライトはまとめて判定して描画しない
+		spriteScreenRects.Clear();
+		for (Sprite* s : sprites)
 		{
-			for (uint32_t i = 0; i < 5; ++i)
-			{
-				sprites[i]->Draw();
-			}
+			spriteScreenRects.Add(s->GetScreenRectMin(), s->GetScreenRectMax());
+		}
+		Culling::CullScreenRects(spriteScreenRects, 0.0f, 0.0f, float(WindowsAPI::kClientWidth), float(WindowsAPI::kClientHeight), visibleSpriteIndices);
+		for (uint32_t index : visibleSpriteIndices)
+		{
+			sprites[index]->Draw();
 		}
 
 		//実際のcommandListの描画コマンドを積む
@@ -347,6 +287,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 	//入力解放
 	delete input;
 
+	//モデルマネージャーの終了
+	ModelManager::GetInstance()->Finalize();
+
 	//テクスチャマネージャーの初期化
 	TextureManager::GetInstance()->Finalize();
 
@@ -1,10 +1,20 @@
 #include "Logger.h"
+
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <cstdio>
+#endif
 
 namespace Logger
 {
 	void Log(const std::string& message)
 	{
+#ifdef _WIN32
 		OutputDebugStringA(message.c_str());
+#else
+		//デバッガの出力が無いので標準エラーに出す
+		std::fputs(message.c_str(), stderr);
+#endif
 	}
-}
\ No newline at end of file
+}
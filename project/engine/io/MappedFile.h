@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//ファイルをメモリにマップして読み込む(読み取り専用)
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//開く(失敗したらfalse)
+	bool Open(const std::string& filePath);
+	//閉じる
+	void Close();
+
+	//getter
+	const uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+	bool IsOpen() const { return data != nullptr; }
+
+private:
+	//マップした先頭アドレスと大きさ
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+};
@@ -0,0 +1,25 @@
+// CompactVertexData(VertexCompression.h)の復元
+// positionはR16G16B16A16_UNORM、texcoordはR16G16_FLOAT、normalはR16G16_SNORMで読み込む想定
+
+struct CompactVertexShaderInput
+{
+    float4 position : POSITION0;
+    float2 texcoord : TEXCOORD0;
+    float2 normal : NORMAL0;
+};
+
+// 量子化した位置を戻す(offset/scaleはCompactModelDataのpositionOffset/positionScale)
+float4 DequantizePosition(float4 quantized, float3 offset, float3 scale)
+{
+    return float4(offset + quantized.xyz * scale, 1.0f);
+}
+
+// 八面体エンコードした法線を戻す
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 normal = float3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float t = max(-normal.z, 0.0f);
+    normal.x += normal.x >= 0.0f ? -t : t;
+    normal.y += normal.y >= 0.0f ? -t : t;
+    return normalize(normal);
+}
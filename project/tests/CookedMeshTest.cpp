@@ -0,0 +1,107 @@
+#include "TestCheck.h"
+#include "ObjFixture.h"
+#include "CookedMesh.h"
+#include "MappedFile.h"
+#include "ModelLoader.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	//MapModelでマップした中身が、LoadModelで読み込んだものと同じか
+	void CheckMappedModel(const std::string& directoryPath, const std::string& filename, uint32_t expectedIndexStride)
+	{
+		MappedFile file;
+		CookedMesh::MeshView view{};
+		ModelData fallback;
+		CHECK(ModelLoader::MapModel(directoryPath, filename, 1, file, &view, &fallback));
+		CHECK(fallback.vertices.empty());
+		CHECK(std::filesystem::exists(CookedMesh::GetCookedPath(directoryPath + "/" + filename)));
+
+		const ModelData modelData = ModelLoader::LoadModel(directoryPath, filename, 1);
+		//頂点はそのまま、Indexは保存された幅のまま並んでいる
+		CHECK(view.vertices.size() == modelData.vertices.size());
+		CHECK(std::memcmp(view.vertices.data(), modelData.vertices.data(), view.vertices.size_bytes()) == 0);
+		CHECK(view.indexStride == expectedIndexStride);
+		CHECK(view.indexStride == ModelLoader::GetIndexStride(modelData));
+		CHECK(view.indexCount == modelData.indices.size());
+		std::vector<uint8_t> indices(ModelLoader::GetIndexBufferSize(modelData));
+		ModelLoader::WriteIndices(modelData, indices.data());
+		CHECK(std::memcmp(view.indices, indices.data(), indices.size()) == 0);
+
+		//描画範囲とマテリアルだけを取り出したもの
+		const ModelData drawRanges = CookedMesh::CopyDrawRanges(view);
+		CHECK(drawRanges.vertices.empty() && drawRanges.indices.empty());
+		CHECK(drawRanges.submeshes.size() == modelData.submeshes.size());
+		CHECK(drawRanges.lods.size() == modelData.lods.size());
+		CHECK(drawRanges.materials.size() == modelData.materials.size());
+		for (size_t i = 0; i < drawRanges.submeshes.size() && i < modelData.submeshes.size(); ++i)
+		{
+			CHECK(drawRanges.submeshes[i].indexOffset == modelData.submeshes[i].indexOffset);
+			CHECK(drawRanges.submeshes[i].indexCount == modelData.submeshes[i].indexCount);
+			CHECK(drawRanges.submeshes[i].materialIndex == modelData.submeshes[i].materialIndex);
+		}
+	}
+}
+
+//変換済みファイルをマップして、コピーせずに転送できる形で取り出せるか
+int main()
+{
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "ge3_test_cookedmesh").generic_string();
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+
+	//頂点数が65536未満なら16bit、それ以上なら32bitのIndex
+	CHECK(ObjFixture::WriteSphere(directoryPath, "small.obj", 64));
+	CheckMappedModel(directoryPath, "small.obj", sizeof(uint16_t));
+	CHECK(ObjFixture::WriteSphere(directoryPath, "large.obj", 384));
+	CheckMappedModel(directoryPath, "large.obj", sizeof(uint32_t));
+
+	//2回目は書き出し済みのファイルをそのままマップする
+	CheckMappedModel(directoryPath, "small.obj", sizeof(uint16_t));
+
+	//===mtlだけを書き換えても作り直す===
+	{
+		const std::string sourcePath = directoryPath + "/small.obj";
+		const std::string cookedPath = CookedMesh::GetCookedPath(sourcePath);
+		CHECK(ModelLoader::LoadModel(directoryPath, "small.obj").materials.at(0).textureFilePath == directoryPath + "/uvChecker.png");
+		{
+			MappedFile file;
+			CookedMesh::MeshView view{};
+			CHECK(file.Open(cookedPath) && CookedMesh::Map(file, sourcePath, &view));
+		}
+
+		{
+			std::ofstream mtl(directoryPath + "/small.mtl", std::ios::trunc);
+			mtl << "newmtl North\nmap_Kd edited.png\n\nnewmtl South\nmap_Kd monsterBall.png\n";
+		}
+		{
+			MappedFile file;
+			CookedMesh::MeshView view{};
+			CHECK(file.Open(cookedPath) && !CookedMesh::Map(file, sourcePath, &view));
+		}
+		CHECK(ModelLoader::LoadModel(directoryPath, "small.obj").materials.at(0).textureFilePath == directoryPath + "/edited.png");
+		//作り直したものは新しいmtlを記録している
+		{
+			MappedFile file;
+			CookedMesh::MeshView view{};
+			CHECK(file.Open(cookedPath) && CookedMesh::Map(file, sourcePath, &view));
+		}
+
+		//mtlが無くなっても古いとみなす
+		std::filesystem::remove(directoryPath + "/small.mtl", error);
+		{
+			MappedFile file;
+			CookedMesh::MeshView view{};
+			CHECK(file.Open(cookedPath) && !CookedMesh::Map(file, sourcePath, &view));
+		}
+	}
+
+	std::filesystem::remove_all(directoryPath, error);
+	return TestCheck::Finish("CookedMeshTest");
+}
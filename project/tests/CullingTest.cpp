@@ -0,0 +1,272 @@
+#include "TestCheck.h"
+#include "Culling.h"
+#include "MyMath.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+	//行ベクトルの座標に行列を掛ける(wで割る)
+	Vector3 TransformPoint(const Vector3& point, const Matrix4x4& matrix)
+	{
+		float result[4];
+		for (int column = 0; column < 4; ++column)
+		{
+			result[column] = point.x * matrix.m[0][column] + point.y * matrix.m[1][column] + point.z * matrix.m[2][column] + matrix.m[3][column];
+		}
+		return { result[0] / result[3],result[1] / result[3],result[2] / result[3] };
+	}
+
+	float Distance(const Vector4& plane, const Vector3& point)
+	{
+		return point.x * plane.x + point.y * plane.y + point.z * plane.z + plane.w;
+	}
+
+	//===1個ずつ判定する参照実装(Cullingと同じ式で計算するので、結果は完全に一致する)===
+
+	std::vector<uint32_t> CullSpheresReference(const std::vector<Sphere>& spheres, size_t count, const Frustum& frustum)
+	{
+		std::vector<uint32_t> visibleIndices;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			bool visible = true;
+			for (const Vector4& plane : frustum.planes)
+			{
+				visible = visible && Distance(plane, spheres[i].center) >= -spheres[i].radius;
+			}
+			if (visible)
+			{
+				visibleIndices.push_back(i);
+			}
+		}
+		return visibleIndices;
+	}
+
+	//8つの角のどれか1つでも平面の内側にあれば、その平面では見えている
+	std::vector<uint32_t> CullAABBsReference(const std::vector<AABB>& aabbs, size_t count, const Frustum& frustum)
+	{
+		std::vector<uint32_t> visibleIndices;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const AABB& aabb = aabbs[i];
+			bool visible = true;
+			for (const Vector4& plane : frustum.planes)
+			{
+				bool inside = false;
+				for (int corner = 0; corner < 8; ++corner)
+				{
+					const Vector3 point = {
+						(corner & 1) ? aabb.max.x : aabb.min.x,
+						(corner & 2) ? aabb.max.y : aabb.min.y,
+						(corner & 4) ? aabb.max.z : aabb.min.z };
+					inside = inside || Distance(plane, point) >= 0.0f;
+				}
+				visible = visible && inside;
+			}
+			if (visible)
+			{
+				visibleIndices.push_back(i);
+			}
+		}
+		return visibleIndices;
+	}
+
+	std::vector<uint32_t> CullScreenRectsReference(const std::vector<Vector2>& mins, const std::vector<Vector2>& maxs, size_t count, float left, float top, float right, float bottom)
+	{
+		std::vector<uint32_t> visibleIndices;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (maxs[i].x >= left && mins[i].x <= right && maxs[i].y >= top && mins[i].y <= bottom)
+			{
+				visibleIndices.push_back(i);
+			}
+		}
+		return visibleIndices;
+	}
+
+	//4個ずつの判定と端数の判定の両方を通るように、4の倍数でない数も含めて先頭からの数を変えて試す
+	std::vector<size_t> MakeCounts(size_t total)
+	{
+		std::vector<size_t> counts;
+		for (size_t count = 0; count <= 9 && count <= total; ++count)
+		{
+			counts.push_back(count);
+		}
+		counts.push_back(total - 1);
+		counts.push_back(total);
+		return counts;
+	}
+
+	//視錐台の各平面をまたぐ物体(平面上の点から法線方向に -2倍~2倍の大きさだけずらす)と、ばらまいた物体を作る
+	void MakeObjects(const Frustum& frustum, const Vector3& frustumCenter, std::mt19937& random, std::vector<Sphere>& outSpheres, std::vector<AABB>& outAABBs)
+	{
+		std::uniform_real_distribution<float> size(0.5f, 4.0f);
+		std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+		std::uniform_real_distribution<float> scatter(-150.0f, 150.0f);
+		for (const Vector4& plane : frustum.planes)
+		{
+			//視錐台の中心から平面に下ろした点
+			const float centerDistance = Distance(plane, frustumCenter);
+			const Vector3 onPlane = { frustumCenter.x - plane.x * centerDistance,frustumCenter.y - plane.y * centerDistance,frustumCenter.z - plane.z * centerDistance };
+			for (int i = 0; i < 64; ++i)
+			{
+				const float radius = size(random);
+				const float shift = offset(random) * radius;
+				outSpheres.push_back({ { onPlane.x + plane.x * shift,onPlane.y + plane.y * shift,onPlane.z + plane.z * shift },radius });
+
+				//AABBは平面の法線方向の厚み(半分)を基準にずらす
+				const Vector3 extent = { size(random),size(random),size(random) };
+				const float halfThickness = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+				const float aabbShift = offset(random) * halfThickness;
+				const Vector3 center = { onPlane.x + plane.x * aabbShift,onPlane.y + plane.y * aabbShift,onPlane.z + plane.z * aabbShift };
+				outAABBs.push_back({ { center.x - extent.x,center.y - extent.y,center.z - extent.z },{ center.x + extent.x,center.y + extent.y,center.z + extent.z } });
+			}
+		}
+		//4の倍数にならないように端数を足す
+		for (int i = 0; i < 203; ++i)
+		{
+			const Vector3 center = { frustumCenter.x + scatter(random),frustumCenter.y + scatter(random) * 0.25f,frustumCenter.z + scatter(random) };
+			const float radius = size(random);
+			outSpheres.push_back({ center,radius });
+			outAABBs.push_back({ { center.x - radius,center.y - radius,center.z - radius },{ center.x + radius,center.y + radius,center.z + radius } });
+		}
+	}
+
+	//視錐台ごとに、SoAでまとめて判定した結果が参照実装と一致するか
+	void CheckFrustum(const Matrix4x4& viewProjection, std::mt19937& random)
+	{
+		MyMath myMath;
+		const Frustum frustum = Culling::MakeFrustum(viewProjection);
+		//正規化デバイス座標の中心(0,0,0.5)をワールド座標に戻す
+		const Vector3 frustumCenter = TransformPoint({ 0.0f,0.0f,0.5f }, myMath.Inverse(viewProjection));
+		for (const Vector4& plane : frustum.planes)
+		{
+			CHECK(Distance(plane, frustumCenter) > 0.0f);
+		}
+
+		std::vector<Sphere> spheres;
+		std::vector<AABB> aabbs;
+		MakeObjects(frustum, frustumCenter, random, spheres, aabbs);
+		CHECK(spheres.size() % 4 != 0);
+
+		//平面をまたぐものは、見えるものと見えないものの両方がある
+		const std::vector<uint32_t> allSpheres = CullSpheresReference(spheres, spheres.size(), frustum);
+		const std::vector<uint32_t> allAABBs = CullAABBsReference(aabbs, aabbs.size(), frustum);
+		CHECK(!allSpheres.empty() && allSpheres.size() < spheres.size());
+		CHECK(!allAABBs.empty() && allAABBs.size() < aabbs.size());
+
+		std::vector<uint32_t> visibleIndices;
+		for (size_t count : MakeCounts(spheres.size()))
+		{
+			SphereBounds sphereBounds;
+			AABBBounds aabbBounds;
+			for (size_t i = 0; i < count; ++i)
+			{
+				sphereBounds.Add(spheres[i]);
+				aabbBounds.Add(aabbs[i]);
+			}
+
+			const std::vector<uint32_t> expectedSpheres = CullSpheresReference(spheres, count, frustum);
+			CHECK(Culling::CullSpheres(sphereBounds, frustum, visibleIndices) == expectedSpheres.size());
+			CHECK(visibleIndices == expectedSpheres);
+
+			const std::vector<uint32_t> expectedAABBs = CullAABBsReference(aabbs, count, frustum);
+			CHECK(Culling::CullAABBs(aabbBounds, frustum, visibleIndices) == expectedAABBs.size());
+			CHECK(visibleIndices == expectedAABBs);
+		}
+	}
+
+	//スクリーン矩形(画面の各辺をまたぐもの、ちょうど接するもの、ばらまいたもの)
+	void CheckScreenRects(std::mt19937& random)
+	{
+		constexpr float kLeft = 0.0f;
+		constexpr float kTop = 0.0f;
+		constexpr float kRight = 1280.0f;
+		constexpr float kBottom = 720.0f;
+
+		std::vector<Vector2> mins;
+		std::vector<Vector2> maxs;
+		auto add = [&](const Vector2& min, const Vector2& max) {
+			mins.push_back(min);
+			maxs.push_back(max);
+		};
+
+		//ちょうど接するものは見えている(辺の1つ手前の値なら見えない)
+		const float beforeLeft = std::nextafter(kLeft, -1.0f);
+		const float afterRight = std::nextafter(kRight, kRight + 1.0f);
+		const float beforeTop = std::nextafter(kTop, -1.0f);
+		const float afterBottom = std::nextafter(kBottom, kBottom + 1.0f);
+		add({ -32.0f,100.0f }, { kLeft,132.0f });
+		add({ -32.0f,100.0f }, { beforeLeft,132.0f });
+		add({ kRight,100.0f }, { kRight + 32.0f,132.0f });
+		add({ afterRight,100.0f }, { kRight + 32.0f,132.0f });
+		add({ 100.0f,-32.0f }, { 132.0f,kTop });
+		add({ 100.0f,-32.0f }, { 132.0f,beforeTop });
+		add({ 100.0f,kBottom }, { 132.0f,kBottom + 32.0f });
+		add({ 100.0f,afterBottom }, { 132.0f,kBottom + 32.0f });
+
+		//各辺をまたぐもの
+		std::uniform_real_distribution<float> size(16.0f, 128.0f);
+		std::uniform_real_distribution<float> along(0.0f, 1.0f);
+		std::uniform_real_distribution<float> offset(-1.5f, 0.5f);
+		for (int i = 0; i < 64; ++i)
+		{
+			const Vector2 rectSize = { size(random),size(random) };
+			const float x = kLeft + (kRight - kLeft) * along(random);
+			const float y = kTop + (kBottom - kTop) * along(random);
+			const float shiftX = offset(random) * rectSize.x;
+			const float shiftY = offset(random) * rectSize.y;
+			add({ kLeft + shiftX,y }, { kLeft + shiftX + rectSize.x,y + rectSize.y });
+			add({ kRight - shiftX - rectSize.x,y }, { kRight - shiftX,y + rectSize.y });
+			add({ x,kTop + shiftY }, { x + rectSize.x,kTop + shiftY + rectSize.y });
+			add({ x,kBottom - shiftY - rectSize.y }, { x + rectSize.x,kBottom - shiftY });
+		}
+
+		//画面の3倍の範囲にばらまく(4の倍数にならないように)
+		std::uniform_real_distribution<float> screenX(-kRight, kRight * 2.0f);
+		std::uniform_real_distribution<float> screenY(-kBottom, kBottom * 2.0f);
+		for (int i = 0; i < 203; ++i)
+		{
+			const Vector2 min = { screenX(random),screenY(random) };
+			add(min, { min.x + size(random),min.y + size(random) });
+		}
+		CHECK(mins.size() % 4 != 0);
+
+		//ちょうど接するものの判定
+		const std::vector<uint32_t> touching = CullScreenRectsReference(mins, maxs, 8, kLeft, kTop, kRight, kBottom);
+		CHECK(touching == std::vector<uint32_t>({ 0,2,4,6 }));
+
+		std::vector<uint32_t> visibleIndices;
+		for (size_t count : MakeCounts(mins.size()))
+		{
+			ScreenRectBounds bounds;
+			for (size_t i = 0; i < count; ++i)
+			{
+				bounds.Add(mins[i], maxs[i]);
+			}
+			const std::vector<uint32_t> expected = CullScreenRectsReference(mins, maxs, count, kLeft, kTop, kRight, kBottom);
+			CHECK(Culling::CullScreenRects(bounds, kLeft, kTop, kRight, kBottom, visibleIndices) == expected.size());
+			CHECK(visibleIndices == expected);
+		}
+	}
+}
+
+//CullSpheres / CullAABBs / CullScreenRects が1個ずつ判定した結果と一致するか(平面をまたぐもの、4の倍数でない数も含める)
+int main()
+{
+	MyMath myMath;
+	std::mt19937 random(9);
+
+	//斜めを向いたカメラにして、平面が座標軸に揃わないようにする
+	const Matrix4x4 cameraMatrix = myMath.MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{ 0.3f,-0.8f,0.1f }, Vector3{ 5.0f,2.0f,-20.0f });
+	const Matrix4x4 viewMatrix = myMath.Inverse(cameraMatrix);
+	CheckFrustum(myMath.Multiply(viewMatrix, myMath.MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 300.0f)), random);
+	CheckFrustum(myMath.Multiply(viewMatrix, myMath.MakeOrthographicMatrix(-100.0f, 60.0f, 100.0f, -60.0f, 0.0f, 300.0f)), random);
+
+	CheckScreenRects(random);
+
+	return TestCheck::Finish("Culling");
+}
@@ -0,0 +1,263 @@
+#include "TestCheck.h"
+#include "ObjFixture.h"
+#include "MeshLod.h"
+#include "ModelLoader.h"
+#include "MyMath.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+	using Position = std::tuple<float, float, float>;
+
+	Position GetPosition(const VertexData& vertex)
+	{
+		return { vertex.position.x, vertex.position.y, vertex.position.z };
+	}
+
+	//z=0の平面の格子(UVは位置に比例するので、内側の頂点はずれ無しで縮約できる)
+	ModelData MakeGrid(uint32_t cellCount)
+	{
+		ModelData modelData;
+		const float inverseCount = 1.0f / static_cast<float>(cellCount);
+		for (uint32_t y = 0; y <= cellCount; ++y)
+		{
+			for (uint32_t x = 0; x <= cellCount; ++x)
+			{
+				const float u = x * inverseCount;
+				const float v = y * inverseCount;
+				modelData.vertices.push_back({ { u, v, 0.0f, 1.0f }, { u, v }, { 0.0f,0.0f,1.0f } });
+			}
+		}
+		for (uint32_t y = 0; y < cellCount; ++y)
+		{
+			for (uint32_t x = 0; x < cellCount; ++x)
+			{
+				const uint32_t v0 = y * (cellCount + 1) + x;
+				const uint32_t v1 = v0 + 1;
+				const uint32_t v2 = v0 + cellCount + 1;
+				const uint32_t v3 = v2 + 1;
+				modelData.indices.insert(modelData.indices.end(), { v0, v1, v2, v2, v1, v3 });
+			}
+		}
+		modelData.submeshes.push_back({ 0, static_cast<uint32_t>(modelData.indices.size()), 0 });
+		return modelData;
+	}
+
+	//動かしてはいけない頂点の位置(UVの継ぎ目と、範囲の縁)
+	std::map<Position, bool> FindLockedPositions(const ModelData& modelData, const SubmeshData& submesh)
+	{
+		//同じ位置に複数の頂点があれば継ぎ目
+		std::map<Position, uint32_t> positionCounts;
+		for (const VertexData& vertex : modelData.vertices)
+		{
+			++positionCounts[GetPosition(vertex)];
+		}
+		//面積のある三角形の辺を位置で数えて、1つの三角形でしか使わない辺の頂点は縁
+		std::map<std::pair<Position, Position>, uint32_t> edgeCounts;
+		std::map<Position, bool> isLocked;
+		for (uint32_t i = 0; i < submesh.indexCount; i += 3)
+		{
+			const uint32_t* triangle = &modelData.indices[submesh.indexOffset + i];
+			const Position positions[3] = { GetPosition(modelData.vertices[triangle[0]]), GetPosition(modelData.vertices[triangle[1]]), GetPosition(modelData.vertices[triangle[2]]) };
+			if (positions[0] == positions[1] || positions[1] == positions[2] || positions[2] == positions[0])
+			{
+				continue;
+			}
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const Position& a = positions[corner];
+				const Position& b = positions[(corner + 1) % 3];
+				++edgeCounts[{ (std::min)(a, b), (std::max)(a, b) }];
+				if (positionCounts[a] > 1)
+				{
+					isLocked[a] = true;
+				}
+			}
+		}
+		for (const auto& [edge, count] : edgeCounts)
+		{
+			if (count != 2)
+			{
+				isLocked[edge.first] = true;
+				isLocked[edge.second] = true;
+			}
+		}
+		return isLocked;
+	}
+
+	//簡略化しても、動かしてはいけない位置は全て残っているか(UVの継ぎ目で同じ位置に複数ある頂点は、どれか1つが残っていればよい)
+	void CheckLockedVertices(const ModelData& modelData, const SubmeshData& submesh, const std::vector<uint32_t>& simplified)
+	{
+		const std::map<Position, bool> lockedPositions = FindLockedPositions(modelData, submesh);
+		std::map<Position, bool> usedPositions;
+		for (uint32_t index : simplified)
+		{
+			usedPositions[GetPosition(modelData.vertices[index])] = true;
+		}
+		uint32_t missingCount = 0;
+		for (const auto& [position, isLocked] : lockedPositions)
+		{
+			missingCount += usedPositions.contains(position) ? 0 : 1;
+		}
+		CHECK(!lockedPositions.empty());
+		CHECK(missingCount == 0);
+	}
+
+	//目標のIndex数と、ずれの上限
+	void CheckSimplify(const ModelData& sphere)
+	{
+		//===平面は目標のIndex数まで減らせる(1回の縮約で三角形が2つ減るので、1つ分は下回ってもよい)===
+		const ModelData grid = MakeGrid(32);
+		for (uint32_t targetIndexCount : { 3u * 1500u, 3u * 600u, 3u * 200u })
+		{
+			float error = -1.0f;
+			const std::vector<uint32_t> simplified = MeshLod::Simplify(grid.vertices, grid.indices, targetIndexCount, MeshLod::kDefaultMaxError, &error);
+			CHECK(simplified.size() % 3 == 0);
+			CHECK(simplified.size() <= targetIndexCount);
+			CHECK(simplified.size() + 3 >= targetIndexCount);
+			CHECK(error >= 0.0f && error <= 1.0e-3f);
+			CheckLockedVertices(grid, grid.submeshes[0], simplified);
+		}
+		//目標が元より多ければそのまま
+		CHECK(MeshLod::Simplify(grid.vertices, grid.indices, static_cast<uint32_t>(grid.indices.size())) == grid.indices);
+
+		//===曲面はずれの上限で止まる(上限が小さいほど三角形が残る)===
+		const SubmeshData& submesh = sphere.submeshes[0];
+		const std::span<const uint32_t> indices = std::span(sphere.indices).subspan(submesh.indexOffset, submesh.indexCount);
+		size_t previousSize = SIZE_MAX;
+		for (float maxError : { 0.002f, 0.02f, 0.2f })
+		{
+			float error = -1.0f;
+			const std::vector<uint32_t> simplified = MeshLod::Simplify(sphere.vertices, indices, 0, maxError, &error);
+			CHECK(error >= 0.0f && error <= maxError);
+			CHECK(simplified.size() < previousSize);
+			CHECK(!simplified.empty());
+			//UVの継ぎ目とマテリアルの境目(半球の縁)は動かない
+			CheckLockedVertices(sphere, submesh, simplified);
+			previousSize = simplified.size();
+		}
+		//上限が0なら形の変わる縮約はしない
+		{
+			float error = -1.0f;
+			MeshLod::Simplify(sphere.vertices, indices, 0, 0.0f, &error);
+			CHECK(error == 0.0f);
+		}
+	}
+
+	//LODの段と描画範囲
+	void CheckGenerateLods(const ModelData& sphere)
+	{
+		ModelData modelData = sphere;
+		const uint32_t lodCount = MeshLod::GenerateLods(modelData);
+		CHECK(lodCount > 1);
+		CHECK(modelData.lods.size() == lodCount);
+
+		//0段目は元のメッシュそのもの
+		CHECK(modelData.lods[0].submeshOffset == 0 && modelData.lods[0].submeshCount == sphere.submeshes.size() && modelData.lods[0].error == 0.0f);
+		CHECK(std::equal(sphere.indices.begin(), sphere.indices.end(), modelData.indices.begin()));
+
+		uint32_t previousIndexCount = static_cast<uint32_t>(sphere.indices.size());
+		for (uint32_t lod = 1; lod < lodCount; ++lod)
+		{
+			const LodData& lodData = modelData.lods[lod];
+			CHECK(lodData.error <= MeshLod::kDefaultMaxError);
+			CHECK(lodData.submeshCount == sphere.submeshes.size());
+
+			uint32_t indexCount = 0;
+			const std::span<const SubmeshData> submeshes = MeshLod::GetSubmeshes(modelData, lod);
+			for (size_t i = 0; i < submeshes.size(); ++i)
+			{
+				CHECK(submeshes[i].materialIndex == sphere.submeshes[i].materialIndex);
+				CHECK(submeshes[i].indexOffset + submeshes[i].indexCount <= modelData.indices.size());
+				indexCount += submeshes[i].indexCount;
+			}
+			//前の段より1割以上減っていて、目標の割合を下回らない
+			CHECK(indexCount * 10 <= previousIndexCount * 9);
+			CHECK(indexCount >= static_cast<uint32_t>(sphere.indices.size() * MeshLod::kDefaultTriangleRatios[lod - 1]) - 3 * sphere.submeshes.size());
+			previousIndexCount = indexCount;
+		}
+		//段の番号が大きすぎれば一番粗い段
+		CHECK(MeshLod::GetSubmeshes(modelData, 100).data() == MeshLod::GetSubmeshes(modelData, lodCount - 1).data());
+		//LODが無ければ全体
+		CHECK(MeshLod::GetSubmeshes(sphere, 2).size() == sphere.submeshes.size());
+	}
+
+	//画面上の大きさと段の選び方
+	void CheckSelectLod()
+	{
+		MyMath myMath;
+		const Matrix4x4 identity = myMath.MakeIdentity4x4();
+
+		//===ComputeScreenSize===
+		const Matrix4x4 perspective = myMath.MakePerspectiveFovMatrix(0.5f, 16.0f / 9.0f, 0.1f, 100.0f);
+		const float expected = 2.0f / (std::tan(0.25f) * 10.0f) * 0.5f;
+		CHECK(std::abs(MeshLod::ComputeScreenSize({ { 0.0f,0.0f,10.0f },1.0f }, identity, perspective) - expected) < expected * 1.0e-5f);
+		//カメラが球の中か後ろなら一番細かい段になる値
+		CHECK(MeshLod::ComputeScreenSize({ { 0.0f,0.0f,0.5f },1.0f }, identity, perspective) == FLT_MAX);
+		CHECK(MeshLod::ComputeScreenSize({ { 0.0f,0.0f,-10.0f },1.0f }, identity, perspective) == FLT_MAX);
+		//平行投影は距離によらない
+		const Matrix4x4 orthographic = myMath.MakeOrthographicMatrix(-8.0f, 4.5f, 8.0f, -4.5f, 0.0f, 100.0f);
+		CHECK(std::abs(MeshLod::ComputeScreenSize({ { 0.0f,0.0f,50.0f },1.0f }, identity, orthographic) - 1.0f / 4.5f) < 1.0e-5f);
+
+		//===SelectLod(高さ1000ピクセルなら、半径のピクセル数はscreenSize * 500)===
+		const LodData lods[] = { { 0,1,0.0f },{ 1,1,0.01f },{ 2,1,0.04f },{ 3,1,0.1f } };
+		//0.1 * 半径 <= 1 → 半径10ピクセル(screenSize 0.02)まで3段目
+		CHECK(MeshLod::SelectLod(lods, 0.019f, 1000.0f) == 3);
+		CHECK(MeshLod::SelectLod(lods, 0.021f, 1000.0f) == 2);
+		//0.04 * 半径 <= 1 → 半径25ピクセル(screenSize 0.05)まで2段目
+		CHECK(MeshLod::SelectLod(lods, 0.049f, 1000.0f) == 2);
+		CHECK(MeshLod::SelectLod(lods, 0.051f, 1000.0f) == 1);
+		//0.01 * 半径 <= 1 → 半径100ピクセル(screenSize 0.2)まで1段目
+		CHECK(MeshLod::SelectLod(lods, 0.19f, 1000.0f) == 1);
+		CHECK(MeshLod::SelectLod(lods, 0.21f, 1000.0f) == 0);
+		CHECK(MeshLod::SelectLod(lods, FLT_MAX, 1000.0f) == 0);
+		//許容するずれを2倍にすると、2倍の大きさまで粗い段を使う
+		CHECK(MeshLod::SelectLod(lods, 0.039f, 1000.0f, 2.0f) == 3);
+		CHECK(MeshLod::SelectLod(lods, 0.041f, 1000.0f, 2.0f) == 2);
+		//段が無いか1つだけなら0
+		CHECK(MeshLod::SelectLod({}, 0.001f, 1000.0f) == 0);
+		CHECK(MeshLod::SelectLod(std::span(lods, 1), 0.001f, 1000.0f) == 0);
+
+		//===SelectObjectLod(ワールド行列の移動と拡大を反映する)===
+		const Sphere localSphere = { { 0.0f,0.0f,0.0f },1.0f };
+		//半径1、距離100なら画面の高さの約1/27なので1段目か2段目、拡大すると細かい段、遠ざけると粗い段
+		const Matrix4x4 near = myMath.MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{ 0.0f,0.0f,0.0f }, { 0.0f,0.0f,10.0f });
+		const Matrix4x4 far = myMath.MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{ 0.0f,0.0f,0.0f }, { 0.0f,0.0f,90.0f });
+		const Matrix4x4 scaledFar = myMath.MakeAffineMatrix({ 1.0f,20.0f,1.0f }, Vector3{ 0.0f,0.0f,0.0f }, { 0.0f,0.0f,90.0f });
+		const uint32_t nearLod = MeshLod::SelectObjectLod(lods, localSphere, near, identity, perspective, 1000.0f);
+		const uint32_t farLod = MeshLod::SelectObjectLod(lods, localSphere, far, identity, perspective, 1000.0f);
+		const uint32_t scaledFarLod = MeshLod::SelectObjectLod(lods, localSphere, scaledFar, identity, perspective, 1000.0f);
+		CHECK(nearLod == MeshLod::SelectLod(lods, MeshLod::ComputeScreenSize({ { 0.0f,0.0f,10.0f },1.0f }, identity, perspective), 1000.0f));
+		CHECK(farLod == MeshLod::SelectLod(lods, MeshLod::ComputeScreenSize({ { 0.0f,0.0f,90.0f },1.0f }, identity, perspective), 1000.0f));
+		CHECK(scaledFarLod == MeshLod::SelectLod(lods, MeshLod::ComputeScreenSize({ { 0.0f,0.0f,90.0f },20.0f }, identity, perspective), 1000.0f));
+		CHECK(nearLod < farLod);
+		CHECK(scaledFarLod < farLod);
+	}
+}
+
+//簡略化(目標のIndex数・ずれの上限・動かさない頂点)と、LODの作成と選択
+int main()
+{
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "ge3_test_meshlod").generic_string();
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+	CHECK(ObjFixture::WriteSphere(directoryPath, "sphere.obj", 64));
+	const ModelData sphere = ModelLoader::LoadObjFile(directoryPath, "sphere.obj");
+	CHECK(sphere.submeshes.size() == 2);
+
+	CheckSimplify(sphere);
+	CheckGenerateLods(sphere);
+	CheckSelectLod();
+
+	std::filesystem::remove_all(directoryPath, error);
+	return TestCheck::Finish("MeshLod");
+}
@@ -0,0 +1,158 @@
+#include "TestCheck.h"
+#include "ObjFixture.h"
+#include "MeshLod.h"
+#include "MeshOptimizer.h"
+#include "ModelLoader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	//範囲の三角形を、頂点の中身で並べたもの(頂点の番号が付け直されても比べられる)
+	std::vector<std::string> SortTriangles(const ModelData& modelData, const SubmeshData& submesh)
+	{
+		std::vector<std::string> triangles;
+		for (uint32_t i = 0; i + 2 < submesh.indexCount; i += 3)
+		{
+			std::string triangle(sizeof(VertexData) * 3, '\0');
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				std::memcpy(&triangle[sizeof(VertexData) * corner], &modelData.vertices[modelData.indices[submesh.indexOffset + i + corner]], sizeof(VertexData));
+			}
+			triangles.push_back(std::move(triangle));
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	//Optimizeの前後で、描画範囲ごとの三角形が変わっていないか
+	void CheckSameTriangles(const ModelData& before, const ModelData& after)
+	{
+		CHECK(after.vertices.size() == before.vertices.size());
+		CHECK(after.indices.size() == before.indices.size());
+		CHECK(after.submeshes.size() == before.submeshes.size());
+		for (size_t i = 0; i < before.submeshes.size() && i < after.submeshes.size(); ++i)
+		{
+			CHECK(after.submeshes[i].indexOffset == before.submeshes[i].indexOffset);
+			CHECK(after.submeshes[i].indexCount == before.submeshes[i].indexCount);
+			CHECK(SortTriangles(after, after.submeshes[i]) == SortTriangles(before, before.submeshes[i]));
+		}
+	}
+
+	//元のメッシュ(lods[0])の範囲を並べたもの
+	std::vector<uint32_t> GetBaseLodIndices(const ModelData& modelData)
+	{
+		std::vector<uint32_t> indices;
+		for (const SubmeshData& submesh : MeshLod::GetSubmeshes(modelData, 0))
+		{
+			indices.insert(indices.end(), modelData.indices.begin() + submesh.indexOffset, modelData.indices.begin() + submesh.indexOffset + submesh.indexCount);
+		}
+		return indices;
+	}
+
+	//範囲の中で三角形の並びを混ぜる(最適化されていない並び)
+	void ShuffleTriangles(ModelData& modelData, std::mt19937& random)
+	{
+		for (const SubmeshData& submesh : modelData.submeshes)
+		{
+			const uint32_t triangleCount = submesh.indexCount / 3;
+			for (uint32_t i = triangleCount; i > 1; --i)
+			{
+				const uint32_t j = std::uniform_int_distribution<uint32_t>(0, i - 1)(random);
+				std::swap_ranges(modelData.indices.begin() + submesh.indexOffset + (i - 1) * 3, modelData.indices.begin() + submesh.indexOffset + i * 3, modelData.indices.begin() + submesh.indexOffset + j * 3);
+			}
+		}
+	}
+
+	//頂点を最初に使われる順に並べ替えても、Indexが指す頂点は変わらない
+	void CheckVertexFetch(const ModelData& source)
+	{
+		ModelData modelData = source;
+		//どこからも使われない頂点を足しておく(後ろに残る)
+		modelData.vertices.push_back({ { 9.0f,9.0f,9.0f,1.0f },{ 0.0f,0.0f },{ 0.0f,1.0f,0.0f } });
+		const ModelData before = modelData;
+		MeshOptimizer::OptimizeVertexFetch(modelData);
+
+		CHECK(modelData.vertices.size() == before.vertices.size());
+		CHECK(modelData.indices.size() == before.indices.size());
+		uint32_t mismatchCount = 0;
+		uint32_t nextNewVertex = 0;
+		std::vector<uint32_t> remap(before.vertices.size(), UINT32_MAX);
+		for (size_t i = 0; i < modelData.indices.size() && i < before.indices.size(); ++i)
+		{
+			const uint32_t oldIndex = before.indices[i];
+			const uint32_t newIndex = modelData.indices[i];
+			mismatchCount += std::memcmp(&modelData.vertices[newIndex], &before.vertices[oldIndex], sizeof(VertexData)) != 0 ? 1 : 0;
+			//同じ頂点は同じ番号に付け直し、初めて使う頂点は0から順に番号が増える
+			if (remap[oldIndex] == UINT32_MAX)
+			{
+				mismatchCount += newIndex != nextNewVertex ? 1 : 0;
+				remap[oldIndex] = nextNewVertex++;
+			}
+			mismatchCount += remap[oldIndex] != newIndex ? 1 : 0;
+		}
+		CHECK(mismatchCount == 0);
+		CHECK(nextNewVertex == before.vertices.size() - 1);
+		CHECK(std::memcmp(&modelData.vertices.back(), &before.vertices.back(), sizeof(VertexData)) == 0);
+	}
+}
+
+//最適化で頂点キャッシュの効率が下がらず、三角形と頂点の中身は変わらないか
+int main()
+{
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "ge3_test_meshoptimizer").generic_string();
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+	CHECK(ObjFixture::WriteSphere(directoryPath, "sphere.obj", 64));
+	const ModelData sphere = ModelLoader::LoadObjFile(directoryPath, "sphere.obj");
+	CHECK(sphere.submeshes.size() == 2);
+
+	CheckVertexFetch(sphere);
+
+	//===読み込んだままの並びと、混ぜた並びを最適化する===
+	std::mt19937 random(3);
+	ModelData shuffled = sphere;
+	ShuffleTriangles(shuffled, random);
+	for (const ModelData* source : { &sphere, static_cast<const ModelData*>(&shuffled) })
+	{
+		ModelData modelData = *source;
+		const MeshOptimizer::Report report = MeshOptimizer::Optimize(modelData);
+		CheckSameTriangles(*source, modelData);
+
+		const uint32_t vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+		CHECK(report.before.acmr == MeshOptimizer::AnalyzeVertexCache(source->indices, vertexCount).acmr);
+		CHECK(report.after.acmr == MeshOptimizer::AnalyzeVertexCache(modelData.indices, vertexCount).acmr);
+		CHECK(report.after.acmr <= report.before.acmr);
+		CHECK(report.after.atvr <= report.before.atvr);
+	}
+	{
+		ModelData modelData = shuffled;
+		const MeshOptimizer::Report report = MeshOptimizer::Optimize(modelData);
+		//混ぜた並び(ほぼ三角形ごとに3回)よりはっきり良くなる
+		CHECK(report.after.acmr < report.before.acmr * 0.5f);
+	}
+
+	//===LODがあっても範囲ごとの三角形は変わらず、効率は元のメッシュの範囲だけで測る===
+	{
+		ModelData source = shuffled;
+		CHECK(MeshLod::GenerateLods(source) > 1);
+		ModelData modelData = source;
+		const MeshOptimizer::Report report = MeshOptimizer::Optimize(modelData);
+		CheckSameTriangles(source, modelData);
+		CHECK(modelData.lods.size() == source.lods.size());
+
+		const uint32_t vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+		CHECK(report.before.acmr == MeshOptimizer::AnalyzeVertexCache(GetBaseLodIndices(source), vertexCount).acmr);
+		CHECK(report.after.acmr == MeshOptimizer::AnalyzeVertexCache(GetBaseLodIndices(modelData), vertexCount).acmr);
+		CHECK(report.after.acmr <= report.before.acmr);
+	}
+
+	std::filesystem::remove_all(directoryPath, error);
+	return TestCheck::Finish("MeshOptimizer");
+}
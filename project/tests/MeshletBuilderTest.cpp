@@ -0,0 +1,243 @@
+#include "TestCheck.h"
+#include "ObjFixture.h"
+#include "Culling.h"
+#include "MeshletBuilder.h"
+#include "ModelLoader.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using Triangle = std::array<uint32_t, 3>;
+
+	//三角形の一覧(並びだけ変わっても比べられるように並べ替える。三角形の中の頂点の順は変えない)
+	std::vector<Triangle> SortTriangles(const uint32_t* indices, uint32_t indexCount)
+	{
+		std::vector<Triangle> triangles;
+		for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	//三角形の法線(cross(p1 - p0, p2 - p0)。正規化しない)
+	Vector3 ComputeFaceNormal(const ModelData& modelData, const uint32_t* triangle)
+	{
+		const Vector4& p0 = modelData.vertices[triangle[0]].position;
+		const Vector4& p1 = modelData.vertices[triangle[1]].position;
+		const Vector4& p2 = modelData.vertices[triangle[2]].position;
+		const Vector3 e1{ p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+		const Vector3 e2{ p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+		return { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+	}
+
+	//全てを内側とする視錐台(コーンの判定だけを確かめる)
+	Frustum MakeUnboundedFrustum()
+	{
+		constexpr float kFar = 1.0e6f;
+		return { { { 1.0f,0.0f,0.0f,kFar },{ -1.0f,0.0f,0.0f,kFar },{ 0.0f,1.0f,0.0f,kFar },{ 0.0f,-1.0f,0.0f,kFar },{ 0.0f,0.0f,1.0f,kFar },{ 0.0f,0.0f,-1.0f,kFar } } };
+	}
+
+	//上限・三角形の過不足・境界が正しいか
+	void CheckMeshlets(const ModelData& modelData, const MeshletData& meshletData, uint32_t maxVertexCount, uint32_t maxTriangleCount)
+	{
+		CHECK(meshletData.groups.size() == modelData.submeshes.size());
+		CHECK(meshletData.sphereBounds.Size() == meshletData.meshlets.size());
+		CHECK(meshletData.coneBounds.Size() == meshletData.meshlets.size());
+
+		//===1つのメッシュレットの頂点数と三角形数は上限以下で、vertexCountは実際に使う頂点の数===
+		uint32_t nextIndexOffset = 0;
+		for (size_t meshletIndex = 0; meshletIndex < meshletData.meshlets.size(); ++meshletIndex)
+		{
+			const Meshlet& meshlet = meshletData.meshlets[meshletIndex];
+			CHECK(meshlet.indexOffset == nextIndexOffset);
+			CHECK(meshlet.indexCount % 3 == 0 && meshlet.indexCount != 0);
+			CHECK(meshlet.indexCount / 3 <= maxTriangleCount);
+			CHECK(meshlet.vertexCount <= maxVertexCount);
+			nextIndexOffset = meshlet.indexOffset + meshlet.indexCount;
+
+			const uint32_t* indices = meshletData.indices.data() + meshlet.indexOffset;
+			std::vector<uint32_t> uniqueVertices(indices, indices + meshlet.indexCount);
+			std::sort(uniqueVertices.begin(), uniqueVertices.end());
+			uniqueVertices.erase(std::unique(uniqueVertices.begin(), uniqueVertices.end()), uniqueVertices.end());
+			CHECK(uniqueVertices.size() == meshlet.vertexCount);
+
+			//===バウンディングスフィアは全ての頂点を含む===
+			const SphereBounds& spheres = meshletData.sphereBounds;
+			uint32_t outsideCount = 0;
+			for (uint32_t vertex : uniqueVertices)
+			{
+				const Vector4& position = modelData.vertices[vertex].position;
+				const float dx = position.x - spheres.centerX[meshletIndex];
+				const float dy = position.y - spheres.centerY[meshletIndex];
+				const float dz = position.z - spheres.centerZ[meshletIndex];
+				outsideCount += std::sqrt(dx * dx + dy * dy + dz * dz) > spheres.radius[meshletIndex] * 1.0001f + 1.0e-6f ? 1 : 0;
+			}
+			CHECK(outsideCount == 0);
+		}
+		CHECK(nextIndexOffset == meshletData.indices.size());
+
+		//===submeshごとに、全ての三角形がちょうど1回ずつ入っている===
+		for (size_t groupIndex = 0; groupIndex < meshletData.groups.size() && groupIndex < modelData.submeshes.size(); ++groupIndex)
+		{
+			const MeshletGroup& group = meshletData.groups[groupIndex];
+			const SubmeshData& submesh = modelData.submeshes[groupIndex];
+			CHECK(group.materialIndex == submesh.materialIndex);
+
+			std::vector<uint32_t> groupIndices;
+			for (uint32_t meshletIndex = group.meshletOffset; meshletIndex < group.meshletOffset + group.meshletCount; ++meshletIndex)
+			{
+				const Meshlet& meshlet = meshletData.meshlets[meshletIndex];
+				CHECK(meshlet.groupIndex == groupIndex);
+				groupIndices.insert(groupIndices.end(), meshletData.indices.begin() + meshlet.indexOffset, meshletData.indices.begin() + meshlet.indexOffset + meshlet.indexCount);
+			}
+			CHECK(SortTriangles(groupIndices.data(), static_cast<uint32_t>(groupIndices.size())) == SortTriangles(modelData.indices.data() + submesh.indexOffset, submesh.indexCount));
+		}
+	}
+
+	//コーンで除いたメッシュレットは、カメラから全ての三角形が裏を向いているか(除いた数を返す)
+	uint32_t CheckConeCulling(const ModelData& modelData, const MeshletData& meshletData, const Vector3& cameraPosition)
+	{
+		const Frustum frustum = MakeUnboundedFrustum();
+		MeshletCullResult result;
+
+		//コーンを使わなければ全て見える
+		CHECK(Culling::CullMeshlets(meshletData, frustum, cameraPosition, false, result) == meshletData.meshlets.size());
+		CHECK(result.indices == meshletData.indices);
+
+		Culling::CullMeshlets(meshletData, frustum, cameraPosition, true, result);
+		std::vector<bool> isVisible(meshletData.meshlets.size(), false);
+		for (uint32_t meshletIndex : result.visibleMeshlets)
+		{
+			isVisible[meshletIndex] = true;
+		}
+
+		uint32_t culledCount = 0;
+		uint32_t frontFacingCount = 0;
+		for (size_t meshletIndex = 0; meshletIndex < meshletData.meshlets.size(); ++meshletIndex)
+		{
+			if (isVisible[meshletIndex])
+			{
+				continue;
+			}
+			++culledCount;
+			const Meshlet& meshlet = meshletData.meshlets[meshletIndex];
+			for (uint32_t i = 0; i < meshlet.indexCount; i += 3)
+			{
+				const uint32_t* triangle = meshletData.indices.data() + meshlet.indexOffset + i;
+				const Vector4& p0 = modelData.vertices[triangle[0]].position;
+				const Vector3 normal = ComputeFaceNormal(modelData, triangle);
+				//カメラから三角形への向きと法線が同じ向きなら裏
+				const float facing = (p0.x - cameraPosition.x) * normal.x + (p0.y - cameraPosition.y) * normal.y + (p0.z - cameraPosition.z) * normal.z;
+				frontFacingCount += facing < 0.0f ? 1 : 0;
+			}
+		}
+		CHECK(frontFacingCount == 0);
+
+		//残したものの描画範囲は、見えているメッシュレットのIndexを順に詰めたもの
+		uint32_t indexCount = 0;
+		for (uint32_t meshletIndex : result.visibleMeshlets)
+		{
+			indexCount += meshletData.meshlets[meshletIndex].indexCount;
+		}
+		CHECK(result.indices.size() == indexCount);
+		uint32_t submeshIndexCount = 0;
+		for (const SubmeshData& submesh : result.submeshes)
+		{
+			CHECK(submesh.indexOffset == submeshIndexCount);
+			submeshIndexCount += submesh.indexCount;
+		}
+		CHECK(submeshIndexCount == indexCount);
+		return culledCount;
+	}
+
+	//z=0の平面の格子(法線は全て+z)
+	ModelData MakeGrid(uint32_t cellCount, float cellSize)
+	{
+		ModelData modelData;
+		for (uint32_t y = 0; y <= cellCount; ++y)
+		{
+			for (uint32_t x = 0; x <= cellCount; ++x)
+			{
+				modelData.vertices.push_back({ { x * cellSize, y * cellSize, 0.0f, 1.0f }, { 0.0f,0.0f }, { 0.0f,0.0f,1.0f } });
+			}
+		}
+		for (uint32_t y = 0; y < cellCount; ++y)
+		{
+			for (uint32_t x = 0; x < cellCount; ++x)
+			{
+				const uint32_t v0 = y * (cellCount + 1) + x;
+				const uint32_t v1 = v0 + 1;
+				const uint32_t v2 = v0 + cellCount + 1;
+				const uint32_t v3 = v2 + 1;
+				modelData.indices.insert(modelData.indices.end(), { v0, v1, v2, v2, v1, v3 });
+			}
+		}
+		modelData.submeshes.push_back({ 0, static_cast<uint32_t>(modelData.indices.size()), 0 });
+		return modelData;
+	}
+}
+
+//メッシュレットの上限・三角形の過不足・スフィアとコーンの境界
+int main()
+{
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "ge3_test_meshletbuilder").generic_string();
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+
+	//===UV球(マテリアル2つ)を、既定の上限と小さい上限で分ける===
+	CHECK(ObjFixture::WriteSphere(directoryPath, "sphere.obj", 48));
+	const ModelData sphere = ModelLoader::LoadObjFile(directoryPath, "sphere.obj");
+	CHECK(sphere.submeshes.size() == 2);
+	{
+		const MeshletData meshletData = MeshletBuilder::Build(sphere, sphere.submeshes);
+		CheckMeshlets(sphere, meshletData, MeshletBuilder::kDefaultMaxVertexCount, MeshletBuilder::kDefaultMaxTriangleCount);
+		CHECK(meshletData.meshlets.size() > 2);
+
+		//球の外から見れば、おおよそ手前か奥の半分は裏を向いている
+		const Vector3 cameraPositions[] = { { 0.0f,0.0f,-5.0f },{ 3.0f,2.0f,4.0f },{ 0.0f,-6.0f,0.0f } };
+		for (const Vector3& cameraPosition : cameraPositions)
+		{
+			const uint32_t culledCount = CheckConeCulling(sphere, meshletData, cameraPosition);
+			CHECK(culledCount != 0 && culledCount < meshletData.meshlets.size());
+		}
+	}
+	{
+		const MeshletData meshletData = MeshletBuilder::Build(sphere, sphere.submeshes, 16, 20);
+		CheckMeshlets(sphere, meshletData, 16, 20);
+		CheckConeCulling(sphere, meshletData, { 0.0f,0.0f,-5.0f });
+	}
+	//頂点数の上限が厳しい場合(3なら三角形1つずつ)
+	{
+		const MeshletData meshletData = MeshletBuilder::Build(sphere, sphere.submeshes, 3, 8);
+		CheckMeshlets(sphere, meshletData, 3, 8);
+		CHECK(meshletData.meshlets.size() == sphere.indices.size() / 3);
+	}
+
+	//===平面は、裏から見れば全て除き、表から見れば全て残す===
+	{
+		const ModelData grid = MakeGrid(32, 0.1f);
+		const MeshletData meshletData = MeshletBuilder::Build(grid, grid.submeshes);
+		CheckMeshlets(grid, meshletData, MeshletBuilder::kDefaultMaxVertexCount, MeshletBuilder::kDefaultMaxTriangleCount);
+		CHECK(CheckConeCulling(grid, meshletData, { 1.6f,1.6f,-10.0f }) == meshletData.meshlets.size());
+		CHECK(CheckConeCulling(grid, meshletData, { 1.6f,1.6f,10.0f }) == 0);
+
+		//平面のコーンは広がりが無い
+		for (size_t i = 0; i < meshletData.coneBounds.Size(); ++i)
+		{
+			CHECK(meshletData.coneBounds.axisZ[i] > 0.9999f);
+			CHECK(meshletData.coneBounds.cutoff[i] < 1.0e-3f);
+		}
+	}
+
+	std::filesystem::remove_all(directoryPath, error);
+	return TestCheck::Finish("MeshletBuilder");
+}
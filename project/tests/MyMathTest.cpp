@@ -0,0 +1,136 @@
+#include "TestCheck.h"
+#include "MathUtility.h"
+#include "MyMath.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+//MyMath::Multiply / MyMath::Inverse / MyMath::MakeTransformationMatrices の確認(test_mymath_scalarはスカラー版で同じ確認をする)
+int main()
+{
+	MyMath myMath;
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+	//Multiplyは加算順が同じなので、スカラーの参照実装とビット単位で一致する
+	int mismatchCount = 0;
+	for (int trial = 0; trial < 100000; ++trial)
+	{
+		Matrix4x4 m1{};
+		Matrix4x4 m2{};
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				m1.m[row][column] = distribution(random);
+				m2.m[row][column] = distribution(random);
+			}
+		}
+		const Matrix4x4 result = myMath.Multiply(m1, m2);
+		const Matrix4x4 expected = MathUtility::Multiply(m1, m2);
+		mismatchCount += std::memcmp(&result, &expected, sizeof(Matrix4x4)) != 0 ? 1 : 0;
+	}
+	CHECK(mismatchCount == 0);
+
+	//Inverseは計算の順が違うので、元の行列に掛けて単位行列に戻るかで確認する
+	float maxError = 0.0f;
+	for (int trial = 0; trial < 100000; ++trial)
+	{
+		const Vector3 scale = { 1.5f + distribution(random) * 0.5f,1.5f + distribution(random) * 0.5f,1.5f + distribution(random) * 0.5f };
+		const Vector3 rotate = { distribution(random),distribution(random),distribution(random) };
+		const Vector3 translate = { distribution(random) * 10.0f,distribution(random) * 10.0f,distribution(random) * 10.0f };
+		Matrix4x4 m = myMath.MakeAffineMatrix(scale, rotate, translate);
+		//射影行列も混ぜて、4列目が(0,0,0,1)でない場合も見る
+		if (trial % 2 == 1)
+		{
+			m = myMath.Multiply(m, myMath.MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+		}
+		//誤差は行列の大きさに比例するので、掛け算の各項の絶対値の和で割って比べる
+		const Matrix4x4 inverse = myMath.Inverse(m);
+		const Matrix4x4 identity = myMath.Multiply(m, inverse);
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				float magnitude = 0.0f;
+				for (int k = 0; k < 4; ++k)
+				{
+					magnitude += std::abs(m.m[row][k] * inverse.m[k][column]);
+				}
+				const float error = std::abs(identity.m[row][column] - (row == column ? 1.0f : 0.0f)) / magnitude;
+				maxError = error > maxError ? error : maxError;
+			}
+		}
+	}
+	//射影行列を掛けたものは条件が悪く、スカラー版・SSE2版・AVX2版のどれでも2e-4程度になる
+	std::printf("Inverse max relative residual: %g\n", maxError);
+	CHECK(maxError < 1.0e-3f);
+
+	//単位行列の逆行列は単位行列
+	const Matrix4x4 identity = myMath.Inverse(myMath.MakeIdentity4x4());
+	const Matrix4x4 expectedIdentity = myMath.MakeIdentity4x4();
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int column = 0; column < 4; ++column)
+		{
+			CHECK(identity.m[row][column] == expectedIdentity.m[row][column]);
+		}
+	}
+
+	//MakeTransformationMatricesは、1個ずつMakeAffineMatrixとMultiplyで作ったものとビット単位で一致する
+	//(三角関数はブロックごとにまとめて求めるので、ブロックの境目をまたぐ個数と端数も見る)
+	const Matrix4x4 viewProjection = myMath.Multiply(myMath.Inverse(myMath.MakeAffineMatrix({ 1.0f,1.0f,1.0f }, Vector3{ 0.3f,-0.2f,0.0f }, { 0.0f,2.0f,-10.0f })),
+		myMath.MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+	std::uniform_real_distribution<float> angle(-6.3f, 6.3f);
+	for (size_t count : { size_t(0), size_t(1), size_t(3), size_t(64), size_t(65), size_t(200) })
+	{
+		std::vector<Transform> transforms(count);
+		for (Transform& transform : transforms)
+		{
+			transform = { { 1.5f + distribution(random) * 0.5f,1.5f + distribution(random) * 0.5f,1.5f + distribution(random) * 0.5f },
+				{ angle(random),angle(random),angle(random) },
+				{ distribution(random) * 10.0f,distribution(random) * 10.0f,distribution(random) * 10.0f } };
+		}
+		std::vector<TransformationMatrix> matrices(count + 1);
+		//書き込むのはtransformsと同じ数だけ
+		std::memset(&matrices[count], 0x7F, sizeof(TransformationMatrix));
+		myMath.MakeTransformationMatrices(transforms, viewProjection, matrices);
+
+		int matrixMismatchCount = 0;
+		int compositionMismatchCount = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Transform& transform = transforms[i];
+			const Matrix4x4 world = myMath.MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+			const Matrix4x4 wvp = myMath.Multiply(world, viewProjection);
+			matrixMismatchCount += std::memcmp(&matrices[i].World, &world, sizeof(Matrix4x4)) != 0 ? 1 : 0;
+			matrixMismatchCount += std::memcmp(&matrices[i].WVP, &wvp, sizeof(Matrix4x4)) != 0 ? 1 : 0;
+
+			//展開した式は、以前のMakeAffineMatrix(Rx * Ry * Rzを掛けてから各行を拡大し、平行移動を書き込む)とも同じ順で計算するのでビット単位で一致する
+			Matrix4x4 composition = myMath.Multiply(myMath.Multiply(myMath.MakeRotateXMatrix(transform.rotate.x), myMath.MakeRotateYMatrix(transform.rotate.y)), myMath.MakeRotateZMatrix(transform.rotate.z));
+			const float scales[3] = { transform.scale.x,transform.scale.y,transform.scale.z };
+			for (int row = 0; row < 3; ++row)
+			{
+				for (int column = 0; column < 3; ++column)
+				{
+					composition.m[row][column] *= scales[row];
+				}
+			}
+			composition.m[3][0] = transform.translate.x;
+			composition.m[3][1] = transform.translate.y;
+			composition.m[3][2] = transform.translate.z;
+			compositionMismatchCount += std::memcmp(&world, &composition, sizeof(Matrix4x4)) != 0 ? 1 : 0;
+		}
+		CHECK(matrixMismatchCount == 0);
+		CHECK(compositionMismatchCount == 0);
+
+		uint8_t untouched[sizeof(TransformationMatrix)];
+		std::memset(untouched, 0x7F, sizeof(untouched));
+		CHECK(std::memcmp(&matrices[count], untouched, sizeof(untouched)) == 0);
+	}
+
+	return TestCheck::Finish("MyMathTest");
+}
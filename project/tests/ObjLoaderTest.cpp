@@ -0,0 +1,228 @@
+#include "TestCheck.h"
+#include "ObjFixture.h"
+#include "ModelLoader.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	//読み込み結果が全く同じか
+	bool IsSameModel(const ModelData& lhs, const ModelData& rhs)
+	{
+		if (lhs.vertices.size() != rhs.vertices.size() || lhs.indices != rhs.indices ||
+			lhs.submeshes.size() != rhs.submeshes.size() || lhs.materials.size() != rhs.materials.size() || lhs.lods.size() != rhs.lods.size() ||
+			lhs.materialLibraryPaths != rhs.materialLibraryPaths)
+		{
+			return false;
+		}
+		//浮動小数点の値もビット単位で比べる
+		if (!lhs.vertices.empty() && std::memcmp(lhs.vertices.data(), rhs.vertices.data(), lhs.vertices.size() * sizeof(VertexData)) != 0)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < lhs.submeshes.size(); ++i)
+		{
+			if (lhs.submeshes[i].indexOffset != rhs.submeshes[i].indexOffset || lhs.submeshes[i].indexCount != rhs.submeshes[i].indexCount ||
+				lhs.submeshes[i].materialIndex != rhs.submeshes[i].materialIndex)
+			{
+				return false;
+			}
+		}
+		for (size_t i = 0; i < lhs.materials.size(); ++i)
+		{
+			if (lhs.materials[i].name != rhs.materials[i].name || lhs.materials[i].textureFilePath != rhs.materials[i].textureFilePath)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//小さなobjを書き出して読む
+	ModelData LoadText(const std::string& directoryPath, const std::string& filename, const std::string& text)
+	{
+		{
+			std::ofstream file(directoryPath + "/" + filename, std::ios::binary | std::ios::trunc);
+			file << text;
+		}
+		return ModelLoader::LoadObjFile(directoryPath, filename, 1);
+	}
+
+	//面の頂点定義の書き方(省略・相対Index・範囲外)
+	void CheckFaceForms(const std::string& directoryPath)
+	{
+		const std::string elements =
+			"v 1 0 0\nv 0 1 0\nv 0 0 1\nv 1 1 1\n"
+			"vt 0.25 0.5\nvt 0.75 0.5\n"
+			"vn 1 0 0\nvn 0 1 0\nvn 0 0 1\n";
+
+		//位置/テクスチャ座標/法線
+		const ModelData full = LoadText(directoryPath, "full.obj", elements + "f 1/1/1 2/2/2 3/1/3\n");
+		CHECK(full.vertices.size() == 3 && full.indices.size() == 3);
+		if (full.vertices.size() == 3)
+		{
+			//回り順を逆にするので、最初の頂点定義は最後のIndexになる
+			const VertexData& first = full.vertices[full.indices[2]];
+			CHECK(first.position.x == -1.0f && first.texcoord.x == 0.25f && first.texcoord.y == 0.5f);
+			CHECK(first.normal.x == -1.0f && first.normal.y == 0.0f && first.normal.z == 0.0f);
+			CHECK(full.vertices[full.indices[0]].normal.z == 1.0f);
+		}
+
+		//テクスチャ座標を省略(UVは0)
+		const ModelData noTexcoord = LoadText(directoryPath, "no_texcoord.obj", elements + "f 1//1 2//2 3//3\n");
+		CHECK(noTexcoord.vertices.size() == 3 && noTexcoord.indices.size() == 3);
+		for (const VertexData& vertex : noTexcoord.vertices)
+		{
+			CHECK(vertex.texcoord.x == 0.0f && vertex.texcoord.y == 0.0f);
+		}
+		if (noTexcoord.vertices.size() == 3)
+		{
+			CHECK(noTexcoord.vertices[noTexcoord.indices[1]].normal.y == 1.0f);
+		}
+
+		//位置だけ(UVも法線も0)
+		const ModelData positionOnly = LoadText(directoryPath, "position_only.obj", elements + "f 1 2 3\nf 3 2 4\n");
+		CHECK(positionOnly.vertices.size() == 4 && positionOnly.indices.size() == 6);
+		for (const VertexData& vertex : positionOnly.vertices)
+		{
+			CHECK(vertex.texcoord.x == 0.0f && vertex.texcoord.y == 0.0f);
+			CHECK(vertex.normal.x == 0.0f && vertex.normal.y == 0.0f && vertex.normal.z == 0.0f);
+		}
+
+		//位置とテクスチャ座標だけ
+		const ModelData noNormal = LoadText(directoryPath, "no_normal.obj", elements + "f 1/1 2/2 3/1\n");
+		CHECK(noNormal.vertices.size() == 3 && noNormal.indices.size() == 3);
+
+		//負のIndexはその行までに定義された要素からの相対(後から要素を足しても変わらない)
+		const ModelData relative = LoadText(directoryPath, "relative.obj", elements + "f -4/-2/-3 -3/-1/-2 -2/-2/-1\nv 9 9 9\nvt 0 0\nvn 0 0 0\n");
+		CHECK(IsSameModel(full, relative));
+
+		//範囲外や形の違うものは空のモデルになる(読み込みは続けられる)
+		const char* const invalidFaces[] = {
+			"f 1/1/1 2/2/2 5/1/1\n",
+			"f 1/3/1 2/2/2 3/1/1\n",
+			"f 1/1/4 2/2/2 3/1/1\n",
+			"f 0/1/1 2/2/2 3/1/1\n",
+			"f -5/1/1 2/2/2 3/1/1\n",
+			"f 1/-3/1 2/2/2 3/1/1\n",
+			"f 1/a/1 2/2/2 3/1/1\n",
+			"f 1/1/1 2/2/2\n",
+			"f //1 2//2 3//3\n",
+		};
+		for (const char* invalidFace : invalidFaces)
+		{
+			const ModelData invalid = LoadText(directoryPath, "invalid.obj", elements + invalidFace);
+			if (!invalid.vertices.empty() || !invalid.indices.empty())
+			{
+				std::printf("accepted invalid face: %s", invalidFace);
+				CHECK(false);
+			}
+		}
+	}
+
+	//面の頂点定義を全て負の相対Indexに書き換える
+	void WriteRelative(const std::string& sourcePath, const std::string& destinationPath)
+	{
+		std::ifstream source(sourcePath, std::ios::binary);
+		std::ofstream destination(destinationPath, std::ios::binary | std::ios::trunc);
+		std::string line;
+		long counts[3] = { 0, 0, 0 };
+		while (std::getline(source, line))
+		{
+			if (line.starts_with("v ")) { ++counts[0]; }
+			else if (line.starts_with("vt ")) { ++counts[1]; }
+			else if (line.starts_with("vn ")) { ++counts[2]; }
+			else if (line.starts_with("f "))
+			{
+				std::istringstream face(line.substr(2));
+				std::string vertexDefinition;
+				destination << "f";
+				while (face >> vertexDefinition)
+				{
+					long elements[3] = { 0, 0, 0 };
+					std::sscanf(vertexDefinition.c_str(), "%ld/%ld/%ld", &elements[0], &elements[1], &elements[2]);
+					destination << " " << elements[0] - counts[0] - 1 << "/" << elements[1] - counts[1] - 1 << "/" << elements[2] - counts[2] - 1;
+				}
+				destination << "\n";
+				continue;
+			}
+			destination << line << "\n";
+		}
+	}
+}
+
+//LoadObjFileを複数スレッドで読んだ結果が、1スレッドで読んだ結果と同じか
+int main()
+{
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "ge3_test_objloader").generic_string();
+
+	//チャンクに分けられる大きさ(数MB)で、途中でマテリアルが切り替わるもの
+	CHECK(ObjFixture::WriteSphere(directoryPath, "sphere.obj", 256));
+	const ModelData serial = ModelLoader::LoadObjFile(directoryPath, "sphere.obj", 1);
+	CHECK(!serial.vertices.empty());
+	CHECK(serial.submeshes.size() == 2);
+	CHECK(serial.materials.size() == 2);
+	CHECK(serial.materialLibraryPaths == std::vector<std::string>{ directoryPath + "/sphere.mtl" });
+	for (uint32_t threadCount : { 2u, 3u, 4u, 7u, 8u, 16u, 0u })
+	{
+		const ModelData parallel = ModelLoader::LoadObjFile(directoryPath, "sphere.obj", threadCount);
+		if (!IsSameModel(serial, parallel))
+		{
+			std::printf("threads:%u differs from serial\n", threadCount);
+			CHECK(false);
+		}
+	}
+
+	//改行がCRLFで、コメントや空行が混ざっていても同じ
+	{
+		std::ifstream source(directoryPath + "/sphere.obj", std::ios::binary);
+		std::ofstream destination(directoryPath + "/sphere_crlf.obj", std::ios::binary | std::ios::trunc);
+		std::string line;
+		uint32_t lineCount = 0;
+		while (std::getline(source, line))
+		{
+			destination << line << "\r\n";
+			if (++lineCount % 1000 == 0)
+			{
+				destination << "# comment\r\n\r\n";
+			}
+		}
+	}
+	const ModelData serialCrlf = ModelLoader::LoadObjFile(directoryPath, "sphere_crlf.obj", 1);
+	CHECK(IsSameModel(serial, serialCrlf));
+	for (uint32_t threadCount : { 2u, 5u, 8u })
+	{
+		CHECK(IsSameModel(serialCrlf, ModelLoader::LoadObjFile(directoryPath, "sphere_crlf.obj", threadCount)));
+	}
+
+	//負の相対Indexは、区間をまたいで前の区間の要素を指しても同じ結果になる
+	WriteRelative(directoryPath + "/sphere.obj", directoryPath + "/sphere_relative.obj");
+	CHECK(IsSameModel(serial, ModelLoader::LoadObjFile(directoryPath, "sphere_relative.obj", 1)));
+	for (uint32_t threadCount : { 2u, 3u, 8u })
+	{
+		CHECK(IsSameModel(serial, ModelLoader::LoadObjFile(directoryPath, "sphere_relative.obj", threadCount)));
+	}
+
+	//複数スレッドで読んでも、範囲外のIndexがあれば空のモデルになる
+	{
+		std::ifstream source(directoryPath + "/sphere.obj", std::ios::binary);
+		std::ofstream destination(directoryPath + "/sphere_invalid.obj", std::ios::binary | std::ios::trunc);
+		destination << source.rdbuf() << "f 1/1/1 2/2/2 99999999/1/1\n";
+	}
+	for (uint32_t threadCount : { 1u, 4u })
+	{
+		CHECK(ModelLoader::LoadObjFile(directoryPath, "sphere_invalid.obj", threadCount).vertices.empty());
+	}
+
+	CheckFaceForms(directoryPath);
+
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+	return TestCheck::Finish("ObjLoaderTest");
+}
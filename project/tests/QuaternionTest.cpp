@@ -0,0 +1,148 @@
+#include "TestCheck.h"
+#include "MyMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numbers>
+#include <random>
+
+namespace
+{
+	float Dot(const Quaternion& q0, const Quaternion& q1)
+	{
+		return q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+	}
+
+	//同じ回転か(qと-qは同じ回転なので、内積の絶対値で比べる)
+	bool SameRotation(const Quaternion& q0, const Quaternion& q1, float tolerance)
+	{
+		return std::abs(std::abs(Dot(q0, q1)) - 1.0f) <= tolerance;
+	}
+
+	//行列の要素の差の最大
+	float MaxDifference(const Matrix4x4& m1, const Matrix4x4& m2)
+	{
+		float maxDifference = 0.0f;
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				maxDifference = (std::max)(maxDifference, std::abs(m1.m[row][column] - m2.m[row][column]));
+			}
+		}
+		return maxDifference;
+	}
+
+	//ランダムな単位クォータニオン
+	Quaternion MakeRandomQuaternion(MyMath& myMath, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+		return myMath.Normalize({ distribution(random),distribution(random),distribution(random),distribution(random) });
+	}
+}
+
+//クォータニオンの変換(オイラー角/行列)とSlerpの確認(test_quaternion_scalarはMyMathをスカラー版にして同じ確認をする)
+int main()
+{
+	MyMath myMath;
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> angleXZ(-3.1f, 3.1f);
+	//Y回転はジンバルロック(±π/2付近)を避ける
+	std::uniform_real_distribution<float> angleY(-1.55f, 1.55f);
+	std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+	//===オイラー角→クォータニオン→オイラー角で元に戻る===
+	{
+		float maxError = 0.0f;
+		for (int trial = 0; trial < 10000; ++trial)
+		{
+			const Vector3 rotate = { angleXZ(random),angleY(random),angleXZ(random) };
+			const Vector3 result = myMath.MakeEulerAngles(myMath.MakeQuaternion(rotate));
+			maxError = (std::max)({ maxError, std::abs(result.x - rotate.x), std::abs(result.y - rotate.y), std::abs(result.z - rotate.z) });
+		}
+		std::printf("Euler round trip max error: %g\n", maxError);
+		CHECK(maxError < 1e-4f);
+
+		//ジンバルロックではオイラー角は一つに決まらないので、同じ回転になるかで確かめる
+		for (float y : { std::numbers::pi_v<float> / 2.0f, -std::numbers::pi_v<float> / 2.0f })
+		{
+			const Quaternion quaternion = myMath.MakeQuaternion(Vector3{ 0.3f,y,-0.7f });
+			const Vector3 result = myMath.MakeEulerAngles(quaternion);
+			CHECK(result.z == 0.0f);
+			CHECK(SameRotation(myMath.MakeQuaternion(result), quaternion, 1e-5f));
+		}
+	}
+
+	//===クォータニオンのAffine変換が、オイラー角のAffine変換と同じ行列になる===
+	{
+		float maxError = 0.0f;
+		for (int trial = 0; trial < 10000; ++trial)
+		{
+			const Vector3 scale = { 1.5f + distribution(random) * 0.5f,1.5f + distribution(random) * 0.5f,1.5f + distribution(random) * 0.5f };
+			const Vector3 rotate = { angleXZ(random),angleXZ(random),angleXZ(random) };
+			const Vector3 translate = { distribution(random) * 10.0f,distribution(random) * 10.0f,distribution(random) * 10.0f };
+			const Matrix4x4 euler = myMath.MakeAffineMatrix(scale, rotate, translate);
+			const Matrix4x4 quaternion = myMath.MakeAffineMatrix(scale, myMath.MakeQuaternion(rotate), translate);
+			maxError = (std::max)(maxError, MaxDifference(euler, quaternion));
+
+			//行列から取り出したクォータニオンも同じ回転になる(拡大縮小は取り除かれる)
+			CHECK(SameRotation(myMath.MakeQuaternion(euler), myMath.MakeQuaternion(rotate), 1e-5f));
+		}
+		//拡大縮小は最大2倍なので、回転の誤差の2倍程度まで
+		std::printf("Quaternion affine max difference: %g\n", maxError);
+		CHECK(maxError < 1e-5f);
+	}
+
+	//===Slerpの両端は入力そのもの(向きが揃えられた時は同じ回転)===
+	{
+		int mismatchCount = 0;
+		for (int trial = 0; trial < 1000; ++trial)
+		{
+			const Quaternion q0 = MakeRandomQuaternion(myMath, random);
+			const Quaternion q1 = MakeRandomQuaternion(myMath, random);
+			mismatchCount += Dot(myMath.Slerp(q0, q1, 0.0f), q0) < 1.0f - 1e-6f ? 1 : 0;
+			//終わりは遠回りしないように符号が揃えられるので、q0との内積は必ず0以上
+			const Quaternion end = myMath.Slerp(q0, q1, 1.0f);
+			const float sign = Dot(q0, q1) < 0.0f ? -1.0f : 1.0f;
+			mismatchCount += Dot(end, q1) * sign < 1.0f - 1e-5f ? 1 : 0;
+			mismatchCount += Dot(end, q0) < 0.0f ? 1 : 0;
+
+			//途中は近い方の回りで、角度がtに比例する
+			const float theta = std::acos((std::min)(std::abs(Dot(q0, q1)), 1.0f));
+			for (float t : { 0.25f, 0.5f, 0.75f })
+			{
+				const Quaternion middle = myMath.Slerp(q0, q1, t);
+				mismatchCount += std::abs(Dot(q0, middle) - std::cos(t * theta)) > 1e-4f ? 1 : 0;
+			}
+		}
+		CHECK(mismatchCount == 0);
+	}
+
+	//===内積が負の時は符号を反転して近い方を回る===
+	{
+		const Vector3 axisZ = { 0.0f,0.0f,1.0f };
+		const Quaternion q0 = myMath.IdentityQuaternion();
+		//200度回転(w = cos100° < 0)は、-160度回転と同じ
+		const Quaternion q1 = myMath.MakeRotateAxisAngleQuaternion(axisZ, 200.0f * std::numbers::pi_v<float> / 180.0f);
+		CHECK(Dot(q0, q1) < 0.0f);
+		const Quaternion middle = myMath.Slerp(q0, q1, 0.5f);
+		//遠回りなら+100度、近い方なら-80度
+		CHECK(SameRotation(middle, myMath.MakeRotateAxisAngleQuaternion(axisZ, -80.0f * std::numbers::pi_v<float> / 180.0f), 1e-5f));
+		CHECK(!SameRotation(middle, myMath.MakeRotateAxisAngleQuaternion(axisZ, 100.0f * std::numbers::pi_v<float> / 180.0f), 1e-2f));
+		//q1を反転して渡しても同じ結果になる
+		const Quaternion flipped = myMath.Slerp(q0, { -q1.x,-q1.y,-q1.z,-q1.w }, 0.5f);
+		CHECK(Dot(middle, flipped) > 1.0f - 1e-6f);
+	}
+
+	//===ほぼ同じ向きの時は線形補間になるが、正規化されている===
+	{
+		const Quaternion q0 = myMath.MakeRotateAxisAngleQuaternion({ 1.0f,0.0f,0.0f }, 0.5f);
+		const Quaternion q1 = myMath.MakeRotateAxisAngleQuaternion({ 1.0f,0.0f,0.0f }, 0.51f);
+		const Quaternion middle = myMath.Slerp(q0, q1, 0.5f);
+		CHECK(std::abs(Dot(middle, middle) - 1.0f) < 1e-6f);
+		CHECK(SameRotation(middle, myMath.MakeRotateAxisAngleQuaternion({ 1.0f,0.0f,0.0f }, 0.505f), 1e-6f));
+	}
+
+	return TestCheck::Finish("Quaternion");
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+//SinCosの精度を測る(確認と計測で共通)
+namespace SinCosAccuracy
+{
+	//倍精度で求めた真値との差をulp(真値をfloatにしたときの最下位桁)で表す
+	inline double ComputeUlpError(float actual, double expected)
+	{
+		const float rounded = static_cast<float>(expected);
+		if (rounded == 0.0f)
+		{
+			return actual == 0.0f ? 0.0 : INFINITY;
+		}
+		const double ulp = std::ldexp(1.0, std::ilogb(rounded) - 23);
+		return std::abs(static_cast<double>(actual) - expected) / ulp;
+	}
+
+	//範囲ごとの最大誤差
+	struct Result {
+		//最大ulp誤差(全ての値)
+		double maxUlp = 0.0;
+		//|値| >= 1/8 のときの最大ulp誤差
+		double maxUlpAwayFromZero = 0.0;
+		//最大絶対誤差
+		double maxAbsoluteError = 0.0;
+	};
+
+	//1つの値の誤差を加える
+	inline void Accumulate(Result& result, float actual, double expected)
+	{
+		const double ulpError = ComputeUlpError(actual, expected);
+		result.maxUlp = ulpError > result.maxUlp ? ulpError : result.maxUlp;
+		if (std::abs(expected) >= 0.125)
+		{
+			result.maxUlpAwayFromZero = ulpError > result.maxUlpAwayFromZero ? ulpError : result.maxUlpAwayFromZero;
+		}
+		const double absoluteError = std::abs(static_cast<double>(actual) - expected);
+		result.maxAbsoluteError = absoluteError > result.maxAbsoluteError ? absoluteError : result.maxAbsoluteError;
+	}
+}
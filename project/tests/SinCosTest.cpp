@@ -0,0 +1,99 @@
+#include "TestCheck.h"
+#include "SinCosAccuracy.h"
+#include "SinCos.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	//[-range, range]を等間隔に取った角度(両端と0を含む)
+	std::vector<float> MakeRadians(float range, size_t count)
+	{
+		std::vector<float> radians(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			radians[i] = static_cast<float>(-static_cast<double>(range) + 2.0 * static_cast<double>(range) * static_cast<double>(i) / static_cast<double>(count - 1));
+		}
+		return radians;
+	}
+
+	//スカラー版とまとめて計算する版の両方の誤差を測る(まとめて計算する版はスカラー版とビット単位で一致することも確かめる)
+	void Measure(const std::vector<float>& radians, SinCosAccuracy::Result& sinResult, SinCosAccuracy::Result& cosResult, size_t& mismatchCount)
+	{
+		std::vector<float> sins(radians.size());
+		std::vector<float> coss(radians.size());
+		MathUtility::SinCos(radians.data(), sins.data(), coss.data(), radians.size());
+		for (size_t i = 0; i < radians.size(); ++i)
+		{
+			float sinValue = 0.0f;
+			float cosValue = 0.0f;
+			MathUtility::SinCos(radians[i], &sinValue, &cosValue);
+			if (std::memcmp(&sinValue, &sins[i], sizeof(float)) != 0 || std::memcmp(&cosValue, &coss[i], sizeof(float)) != 0)
+			{
+				++mismatchCount;
+			}
+			SinCosAccuracy::Accumulate(sinResult, sinValue, std::sin(static_cast<double>(radians[i])));
+			SinCosAccuracy::Accumulate(cosResult, cosValue, std::cos(static_cast<double>(radians[i])));
+		}
+	}
+}
+
+//SinCos.hに書いた精度を満たしているか
+int main()
+{
+	//|radian| <= π : 最大2ulp
+	{
+		SinCosAccuracy::Result sinResult;
+		SinCosAccuracy::Result cosResult;
+		size_t mismatchCount = 0;
+		Measure(MakeRadians(3.14159265f, 4000001), sinResult, cosResult, mismatchCount);
+		std::printf("|x| <= pi   : sin %.3f ulp, cos %.3f ulp\n", sinResult.maxUlp, cosResult.maxUlp);
+		CHECK(sinResult.maxUlp <= 2.0);
+		CHECK(cosResult.maxUlp <= 2.0);
+		CHECK(mismatchCount == 0);
+	}
+
+	//|radian| <= 8192 : 絶対誤差は最大8e-8、|値| >= 1/8 なら最大2ulp
+	{
+		SinCosAccuracy::Result sinResult;
+		SinCosAccuracy::Result cosResult;
+		size_t mismatchCount = 0;
+		Measure(MakeRadians(8192.0f, 4000001), sinResult, cosResult, mismatchCount);
+		std::printf("|x| <= 8192 : sin %.3g abs / %.3f ulp (|sin| >= 1/8), cos %.3g abs / %.3f ulp (|cos| >= 1/8)\n",
+			sinResult.maxAbsoluteError, sinResult.maxUlpAwayFromZero, cosResult.maxAbsoluteError, cosResult.maxUlpAwayFromZero);
+		CHECK(sinResult.maxAbsoluteError <= 8.0e-8);
+		CHECK(cosResult.maxAbsoluteError <= 8.0e-8);
+		CHECK(sinResult.maxUlpAwayFromZero <= 2.0);
+		CHECK(cosResult.maxUlpAwayFromZero <= 2.0);
+		CHECK(mismatchCount == 0);
+	}
+
+	//範囲外の角度を含むブロックは標準ライブラリで計算される(他の要素も正しい)
+	{
+		std::vector<float> radians = { 0.5f, 1.0e6f, -2.0f, 3.0f, 1.0f, -1.0e7f, 0.25f, 8192.0f, 8193.0f, -0.75f };
+		std::vector<float> sins(radians.size());
+		std::vector<float> coss(radians.size());
+		MathUtility::SinCos(radians.data(), sins.data(), coss.data(), radians.size());
+		for (size_t i = 0; i < radians.size(); ++i)
+		{
+			CHECK(std::abs(static_cast<double>(sins[i]) - std::sin(static_cast<double>(radians[i]))) <= 1.0e-6);
+			CHECK(std::abs(static_cast<double>(coss[i]) - std::cos(static_cast<double>(radians[i]))) <= 1.0e-6);
+		}
+	}
+
+	//0と符号
+	{
+		float sinValue = 1.0f;
+		float cosValue = 0.0f;
+		MathUtility::SinCos(0.0f, &sinValue, &cosValue);
+		CHECK(sinValue == 0.0f && cosValue == 1.0f);
+		MathUtility::SinCos(-0.5f, &sinValue, &cosValue);
+		CHECK(sinValue < 0.0f && cosValue > 0.0f);
+	}
+
+	return TestCheck::Finish("SinCosTest");
+}
@@ -0,0 +1,73 @@
+#include "TestCheck.h"
+#include "StagingRingAllocator.h"
+
+#include <cstdint>
+
+//転送用バッファの切り出し(揃えの埋め草、末尾での折り返し、満杯、フェンスでの解放)
+int main()
+{
+	constexpr uint64_t kInvalid = StagingRingAllocator::kInvalidOffset;
+	StagingRingAllocator allocator;
+	allocator.Initialize(1024);
+	CHECK(allocator.GetCapacity() == 1024);
+	CHECK(allocator.GetUsedSize() == 0);
+
+	//===切り出せない大きさ===
+	CHECK(allocator.Allocate(0, 1) == kInvalid);
+	CHECK(allocator.Allocate(1025, 1) == kInvalid);
+	CHECK(allocator.GetUsedSize() == 0);
+
+	//===揃えの埋め草も使用中に数える===
+	CHECK(allocator.Allocate(100, 1) == 0);
+	CHECK(allocator.Allocate(10, 256) == 256);
+	CHECK(allocator.GetUsedSize() == 266);
+	allocator.Submit(1);
+	CHECK(allocator.Allocate(600, 1) == 266);
+	CHECK(allocator.GetUsedSize() == 866);
+	allocator.Submit(2);
+	CHECK(allocator.GetOldestPendingFenceValue() == 1);
+
+	//末尾に収まらず、先頭もまだGPUが使っているので切り出せない
+	CHECK(allocator.Allocate(200, 1) == kInvalid);
+	CHECK(allocator.GetUsedSize() == 866);
+
+	//===折り返し(末尾の残りは埋め草として使用中に数える)===
+	allocator.Retire(1);
+	CHECK(allocator.GetUsedSize() == 600);
+	CHECK(allocator.GetOldestPendingFenceValue() == 2);
+	CHECK(allocator.Allocate(200, 1) == 0);
+	CHECK(allocator.GetUsedSize() == 600 + (1024 - 866) + 200);
+
+	//===満杯===
+	//折り返した後は、まだ使っている所(266から)の手前までしか切り出せない
+	CHECK(allocator.Allocate(100, 1) == kInvalid);
+	CHECK(allocator.Allocate(66, 1) == 200);
+	CHECK(allocator.GetUsedSize() == 1024);
+	CHECK(allocator.Allocate(1, 1) == kInvalid);
+	allocator.Submit(3);
+
+	//完了していないフェンスでは何も空かない
+	allocator.Retire(1);
+	CHECK(allocator.GetUsedSize() == 1024);
+	CHECK(allocator.Allocate(1, 1) == kInvalid);
+
+	//===全て空いたら先頭に戻る===
+	allocator.Retire(2);
+	CHECK(allocator.GetUsedSize() == 1024 - 600);
+	CHECK(allocator.GetOldestPendingFenceValue() == 3);
+	allocator.Retire(3);
+	CHECK(allocator.GetUsedSize() == 0);
+	CHECK(allocator.GetOldestPendingFenceValue() == 0);
+	//先頭に戻っていなければ(266から)全体は切り出せない
+	CHECK(allocator.Allocate(1024, 1) == 0);
+	CHECK(allocator.GetUsedSize() == 1024);
+	allocator.Submit(4);
+	allocator.Retire(4);
+	CHECK(allocator.GetUsedSize() == 0);
+
+	//切り出していなければSubmitしても何も記録しない
+	allocator.Submit(5);
+	CHECK(allocator.GetOldestPendingFenceValue() == 0);
+
+	return TestCheck::Finish("StagingRingAllocator");
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdio>
+
+//確認用の簡単な仕組み(assertと違ってNDEBUGでも消えず、失敗しても続けて全て報告する)
+namespace TestCheck
+{
+	//失敗した数
+	inline int& GetFailureCount()
+	{
+		static int failureCount = 0;
+		return failureCount;
+	}
+
+	//失敗を報告する
+	inline void ReportFailure(const char* expression, const char* file, int line)
+	{
+		std::fprintf(stderr, "%s(%d): CHECK failed: %s\n", file, line, expression);
+		++GetFailureCount();
+	}
+
+	//結果を表示して終了コードを返す
+	inline int Finish(const char* testName)
+	{
+		const int failureCount = GetFailureCount();
+		std::printf("%s: %s (%d failures)\n", testName, failureCount == 0 ? "passed" : "FAILED", failureCount);
+		return failureCount == 0 ? 0 : 1;
+	}
+}
+
+#define CHECK(condition) \
+	do { if (!(condition)) { TestCheck::ReportFailure(#condition, __FILE__, __LINE__); } } while (false)
@@ -0,0 +1,201 @@
+#include "TestCheck.h"
+#include "TextureCooker.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+	//width x heightの画像(画素は場所ごとに変える)
+	DirectX::ScratchImage MakeImage(DXGI_FORMAT format, size_t width, size_t height, size_t mipLevels = 1)
+	{
+		DirectX::ScratchImage image{};
+		CHECK(SUCCEEDED(image.Initialize2D(format, width, height, 1, mipLevels)));
+		for (size_t mip = 0; mip < mipLevels; ++mip)
+		{
+			const DirectX::Image* pixels = image.GetImage(mip, 0, 0);
+			for (size_t i = 0; pixels != nullptr && i < pixels->slicePitch; ++i)
+			{
+				pixels->pixels[i] = static_cast<uint8_t>(i * 7 + mip);
+			}
+		}
+		return image;
+	}
+
+	//幅と高さから、1x1までのミップマップの段数
+	size_t GetFullMipLevels(size_t width, size_t height)
+	{
+		size_t mipLevels = 1;
+		while (width > 1 || height > 1)
+		{
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+			++mipLevels;
+		}
+		return mipLevels;
+	}
+
+	//Cookした結果のフォーマットとミップマップの段数
+	void CheckCook(DXGI_FORMAT sourceFormat, size_t width, size_t height, TextureCompression compression, DXGI_FORMAT expectedFormat)
+	{
+		DirectX::ScratchImage cookedImage{};
+		CHECK(SUCCEEDED(TextureCooker::Cook(MakeImage(sourceFormat, width, height), { true, compression }, cookedImage)));
+		const DirectX::TexMetadata& metadata = cookedImage.GetMetadata();
+		CHECK(metadata.format == expectedFormat);
+		CHECK(metadata.width == width && metadata.height == height);
+		CHECK(metadata.mipLevels == GetFullMipLevels(width, height));
+	}
+
+	//ファイルを全て読む
+	std::vector<uint8_t> ReadFile(const std::filesystem::path& filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	//一時ファイル(.tmp)が残っていないか
+	bool HasTemporaryFile(const std::filesystem::path& directoryPath)
+	{
+		std::error_code error;
+		for (auto it = std::filesystem::directory_iterator(directoryPath, error); !error && it != std::filesystem::directory_iterator(); it.increment(error))
+		{
+			if (it->path().extension() == ".tmp")
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+//変換済みファイルのキー、ミップマップの作成とブロック圧縮、DDSの書き出しの確認
+int main()
+{
+	//===ComputeKey===
+	{
+		std::vector<uint8_t> data(1000);
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			data[i] = static_cast<uint8_t>(i * 31);
+		}
+		const TextureCooker::CookSettings none{ true, TextureCompression::None };
+		const uint64_t key = TextureCooker::ComputeKey(data.data(), data.size(), none);
+		//同じ中身と設定なら同じキー(使うかどうかはキーに含めない)
+		CHECK(TextureCooker::ComputeKey(data.data(), data.size(), none) == key);
+		CHECK(TextureCooker::ComputeKey(data.data(), data.size(), { false, TextureCompression::None }) == key);
+
+		//中身が1バイトでも違えば、長さが違えば、圧縮の種類が違えば別のキー
+		std::vector<uint8_t> changed = data;
+		changed[500] ^= 1;
+		CHECK(TextureCooker::ComputeKey(changed.data(), changed.size(), none) != key);
+		CHECK(TextureCooker::ComputeKey(data.data(), data.size() - 1, none) != key);
+		const uint64_t keys[] = {
+			key,
+			TextureCooker::ComputeKey(data.data(), data.size(), { true, TextureCompression::BC1 }),
+			TextureCooker::ComputeKey(data.data(), data.size(), { true, TextureCompression::BC3 }),
+			TextureCooker::ComputeKey(data.data(), data.size(), { true, TextureCompression::BC7 }),
+		};
+		for (size_t i = 0; i < std::size(keys); ++i)
+		{
+			for (size_t j = i + 1; j < std::size(keys); ++j)
+			{
+				CHECK(keys[i] != keys[j]);
+			}
+		}
+		//空のファイルでも作れる
+		CHECK(TextureCooker::ComputeKey(nullptr, 0, none) != TextureCooker::ComputeKey(nullptr, 0, { true, TextureCompression::BC7 }));
+
+		//パスは変換済みファイルのディレクトリの中の、キーの16進数16桁の名前
+		CHECK(TextureCooker::GetCookedPath(0x0123456789abcdefull) == std::string(TextureCooker::kCacheDirectory) + "/0123456789abcdef.dds");
+		CHECK(TextureCooker::GetCookedPath(1) == std::string(TextureCooker::kCacheDirectory) + "/0000000000000001.dds");
+	}
+
+	//===ParseCompression===
+	{
+		TextureCompression compression = TextureCompression::None;
+		CHECK(TextureCooker::ParseCompression("bc1", compression) && compression == TextureCompression::BC1);
+		CHECK(TextureCooker::ParseCompression("BC3", compression) && compression == TextureCompression::BC3);
+		CHECK(TextureCooker::ParseCompression("Bc7", compression) && compression == TextureCompression::BC7);
+		CHECK(TextureCooker::ParseCompression("none", compression) && compression == TextureCompression::None);
+		//分からない名前では書き換えない
+		compression = TextureCompression::BC7;
+		CHECK(!TextureCooker::ParseCompression("bc2", compression));
+		CHECK(!TextureCooker::ParseCompression("", compression));
+		CHECK(!TextureCooker::ParseCompression("bc7 ", compression));
+		CHECK(compression == TextureCompression::BC7);
+	}
+
+	//===Cook===
+	{
+		//ミップマップを作り、圧縮の種類に合わせたフォーマットにする(sRGBかどうかは元に合わせる)
+		CheckCook(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 32, TextureCompression::None, DXGI_FORMAT_R8G8B8A8_UNORM);
+		CheckCook(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 32, TextureCompression::BC1, DXGI_FORMAT_BC1_UNORM);
+		CheckCook(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 32, TextureCompression::BC3, DXGI_FORMAT_BC3_UNORM);
+		CheckCook(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 32, TextureCompression::BC7, DXGI_FORMAT_BC7_UNORM);
+		CheckCook(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 64, 32, TextureCompression::BC1, DXGI_FORMAT_BC1_UNORM_SRGB);
+		CheckCook(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 64, 32, TextureCompression::BC7, DXGI_FORMAT_BC7_UNORM_SRGB);
+		//縦横が4の倍数でなければ圧縮しない
+		CheckCook(DXGI_FORMAT_R8G8B8A8_UNORM, 30, 32, TextureCompression::BC7, DXGI_FORMAT_R8G8B8A8_UNORM);
+		CheckCook(DXGI_FORMAT_R8G8B8A8_UNORM, 32, 30, TextureCompression::BC1, DXGI_FORMAT_R8G8B8A8_UNORM);
+
+		//ミップマップが入っていれば作り直さない
+		DirectX::ScratchImage cookedImage{};
+		CHECK(SUCCEEDED(TextureCooker::Cook(MakeImage(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 64, 3), { true, TextureCompression::None }, cookedImage)));
+		CHECK(cookedImage.GetMetadata().mipLevels == 3);
+		const DirectX::Image* lastMip = cookedImage.GetImage(2, 0, 0);
+		CHECK(lastMip != nullptr && lastMip->pixels[0] == 2);
+	}
+
+	//===Save===
+	{
+		//変換済みファイルのディレクトリは相対パスなので、一時ディレクトリで書き出す
+		const std::filesystem::path directoryPath = std::filesystem::temp_directory_path() / "ge3_test_texturecooker";
+		std::error_code error;
+		std::filesystem::remove_all(directoryPath, error);
+		std::filesystem::create_directories(directoryPath, error);
+		const std::filesystem::path previousPath = std::filesystem::current_path();
+		std::filesystem::current_path(directoryPath, error);
+		CHECK(!error);
+
+		DirectX::ScratchImage cookedImage{};
+		CHECK(SUCCEEDED(TextureCooker::Cook(MakeImage(DXGI_FORMAT_R8G8B8A8_UNORM, 32, 32), { true, TextureCompression::BC3 }, cookedImage)));
+		const std::string cookedPath = TextureCooker::GetCookedPath(42);
+		//ディレクトリが無くても作って書き出す
+		CHECK(TextureCooker::Save(cookedImage, cookedPath));
+		//上書きもできる
+		CHECK(TextureCooker::Save(cookedImage, cookedPath));
+		CHECK(!HasTemporaryFile(TextureCooker::kCacheDirectory));
+
+		//読み戻すと同じ画像になる
+		const std::vector<uint8_t> fileData = ReadFile(cookedPath);
+		DirectX::TexMetadata metadata{};
+		DirectX::ScratchImage loadedImage{};
+		CHECK(SUCCEEDED(DirectX::LoadFromDDSMemory(fileData.data(), fileData.size(), DirectX::DDS_FLAGS_NONE, &metadata, loadedImage)));
+		CHECK(loadedImage.GetMetadata().format == cookedImage.GetMetadata().format);
+		CHECK(loadedImage.GetMetadata().width == 32 && loadedImage.GetMetadata().height == 32);
+		CHECK(loadedImage.GetMetadata().mipLevels == cookedImage.GetMetadata().mipLevels);
+		CHECK(loadedImage.GetImageCount() == cookedImage.GetImageCount());
+		for (size_t i = 0; i < loadedImage.GetImageCount() && i < cookedImage.GetImageCount(); ++i)
+		{
+			const DirectX::Image& loaded = loadedImage.GetImages()[i];
+			const DirectX::Image& cooked = cookedImage.GetImages()[i];
+			CHECK(loaded.slicePitch == cooked.slicePitch && std::memcmp(loaded.pixels, cooked.pixels, cooked.slicePitch) == 0);
+		}
+
+		//書き出せない場所なら失敗して、一時ファイルも残さない
+		const std::string missingPath = std::string(TextureCooker::kCacheDirectory) + "/missing/0000000000000000.dds";
+		CHECK(!TextureCooker::Save(cookedImage, missingPath));
+		CHECK(!std::filesystem::exists(missingPath));
+		CHECK(!HasTemporaryFile(TextureCooker::kCacheDirectory));
+
+		std::filesystem::current_path(previousPath, error);
+		std::filesystem::remove_all(directoryPath, error);
+	}
+
+	return TestCheck::Finish("TextureCooker");
+}
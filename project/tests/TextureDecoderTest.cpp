@@ -0,0 +1,182 @@
+#include "TestCheck.h"
+#include "TextureDecoder.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	//受け取った順と中身を記録するだけの受け取り側(GPUの代わり)
+	class RecordingSink : public TextureUploadSink
+	{
+	public:
+		struct Record {
+			uint32_t textureIndex;
+			HRESULT result;
+			size_t width;
+			//先頭の画素(書き出したときの番号が入っている)
+			uint8_t firstPixel;
+		};
+
+		void Upload(DecodedTexture& decodedTexture) override
+		{
+			Record record{ decodedTexture.textureIndex, decodedTexture.result, 0, 0 };
+			if (SUCCEEDED(decodedTexture.result) && !decodedTexture.subresources.empty())
+			{
+				record.width = decodedTexture.mipImages.GetMetadata().width;
+				record.firstPixel = *static_cast<const uint8_t*>(decodedTexture.subresources[0].pixels);
+			}
+			records.push_back(record);
+		}
+
+		std::vector<Record> records;
+	};
+
+	//width x 16の画像をDDSで書き出す(画素は全てvalue)
+	bool WriteDds(const std::string& filePath, size_t width, uint8_t value)
+	{
+		DirectX::ScratchImage image{};
+		if (FAILED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, 16, 1, 1)))
+		{
+			return false;
+		}
+		const DirectX::Image* pixels = image.GetImage(0, 0, 0);
+		std::memset(pixels->pixels, value, pixels->slicePitch);
+
+		DirectX::Blob blob{};
+		if (FAILED(DirectX::SaveToDDSMemory(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::DDS_FLAGS_NONE, blob)))
+		{
+			return false;
+		}
+		std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+		file.write(static_cast<const char*>(blob.GetBufferPointer()), static_cast<std::streamsize>(blob.GetBufferSize()));
+		return file.good();
+	}
+
+	//積んだ順(番号はわざと並べない)
+	constexpr uint32_t kTextureCount = 12;
+	uint32_t GetTextureIndex(uint32_t order)
+	{
+		return 100 + (order * 7) % kTextureCount;
+	}
+
+	//積んだ順に受け取っていて、中身が取り違えられていないか
+	void CheckRecords(const std::vector<RecordingSink::Record>& records, uint32_t firstOrder, uint32_t count)
+	{
+		CHECK(records.size() == count);
+		for (uint32_t i = 0; i < count && i < records.size(); ++i)
+		{
+			const uint32_t order = firstOrder + i;
+			CHECK(records[i].textureIndex == GetTextureIndex(order));
+			CHECK(SUCCEEDED(records[i].result));
+			CHECK(records[i].firstPixel == static_cast<uint8_t>(order));
+		}
+	}
+}
+
+//デコードの終わる順によらず、積んだ順に受け取り側へ渡すか
+int main()
+{
+	const std::filesystem::path directoryPath = std::filesystem::temp_directory_path() / "ge3_test_texturedecoder";
+	std::error_code error;
+	std::filesystem::remove_all(directoryPath, error);
+	std::filesystem::create_directories(directoryPath, error);
+
+	//先に積むものほど大きくして、後に積んだものが先に終わるようにする
+	std::vector<std::string> filePaths;
+	for (uint32_t order = 0; order < kTextureCount; ++order)
+	{
+		filePaths.push_back((directoryPath / ("texture" + std::to_string(order) + ".dds")).generic_string());
+		CHECK(WriteDds(filePaths.back(), size_t(2048) >> (order % 6), static_cast<uint8_t>(order)));
+	}
+	//DDSは変換済みファイルを使わない
+	const TextureCooker::CookSettings cookSettings{ false, TextureCompression::None };
+
+	//===DrainAll===
+	{
+		TextureDecoder decoder(4);
+		decoder.SetCookSettings(cookSettings);
+		for (uint32_t order = 0; order < kTextureCount; ++order)
+		{
+			decoder.Submit(GetTextureIndex(order), filePaths[order]);
+		}
+		RecordingSink sink;
+		CHECK(decoder.DrainAll(sink) == kTextureCount);
+		CHECK(decoder.GetPendingCount() == 0);
+		CheckRecords(sink.records, 0, kTextureCount);
+		CHECK(sink.records.empty() || sink.records[0].width == 2048);
+	}
+
+	//===DrainUntil===
+	{
+		TextureDecoder decoder(4);
+		decoder.SetCookSettings(cookSettings);
+		for (uint32_t order = 0; order < kTextureCount; ++order)
+		{
+			decoder.Submit(GetTextureIndex(order), filePaths[order]);
+		}
+		//5番目までと、その前に積んだものだけを渡す
+		RecordingSink sink;
+		CHECK(decoder.DrainUntil(sink, GetTextureIndex(4)));
+		CheckRecords(sink.records, 0, 5);
+		CHECK(decoder.GetPendingCount() == kTextureCount - 5);
+
+		//渡し終えたものと積んでいないものは何もしない
+		CHECK(!decoder.DrainUntil(sink, GetTextureIndex(2)));
+		CHECK(!decoder.DrainUntil(sink, 0));
+		CHECK(sink.records.size() == 5);
+
+		RecordingSink restSink;
+		CHECK(decoder.DrainAll(restSink) == kTextureCount - 5);
+		CheckRecords(restSink.records, 5, kTextureCount - 5);
+	}
+
+	//===Drain===
+	{
+		TextureDecoder decoder(4);
+		decoder.SetCookSettings(cookSettings);
+		for (uint32_t order = 0; order < kTextureCount; ++order)
+		{
+			decoder.Submit(GetTextureIndex(order), filePaths[order]);
+		}
+		//終わっているものだけを渡すので、何度かに分けて全て受け取る
+		RecordingSink sink;
+		const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+		while (decoder.GetPendingCount() != 0 && std::chrono::steady_clock::now() < deadline)
+		{
+			const size_t pendingCount = decoder.GetPendingCount();
+			const uint32_t uploadCount = decoder.Drain(sink);
+			CHECK(decoder.GetPendingCount() == pendingCount - uploadCount);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		CHECK(decoder.GetPendingCount() == 0);
+		CheckRecords(sink.records, 0, kTextureCount);
+	}
+
+	//===読めなかったものも順番を崩さずに渡す===
+	{
+		TextureDecoder decoder(2);
+		decoder.SetCookSettings(cookSettings);
+		decoder.Submit(1, filePaths[0]);
+		decoder.Submit(2, (directoryPath / "missing.dds").generic_string());
+		decoder.Submit(3, filePaths[1]);
+		RecordingSink sink;
+		CHECK(decoder.DrainAll(sink) == 3);
+		CHECK(sink.records.size() == 3);
+		if (sink.records.size() == 3)
+		{
+			CHECK(sink.records[0].textureIndex == 1 && SUCCEEDED(sink.records[0].result));
+			CHECK(sink.records[1].textureIndex == 2 && FAILED(sink.records[1].result));
+			CHECK(sink.records[2].textureIndex == 3 && SUCCEEDED(sink.records[2].result));
+		}
+	}
+
+	std::filesystem::remove_all(directoryPath, error);
+	return TestCheck::Finish("TextureDecoder");
+}
@@ -0,0 +1,201 @@
+#include "TestCheck.h"
+#include "MyMath.h"
+#include "SpriteGeometry.h"
+#include "TransformGraph.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	//行列の要素が全て一致するか(同じ計算をしているので誤差は出ない。0と-0は同じとみなす)
+	bool SameMatrix(const Matrix4x4& m1, const Matrix4x4& m2)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				if (m1.m[row][column] != m2.m[row][column])
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	Transform MakeTransform(const Vector3& scale, const Vector3& rotate, const Vector3& translate)
+	{
+		Transform transform{};
+		transform.scale = scale;
+		transform.rotate = rotate;
+		transform.translate = translate;
+		return transform;
+	}
+
+	//ローカル変換から作った行列
+	Matrix4x4 MakeLocalMatrix(MyMath& myMath, const TransformGraph& graph, uint32_t node)
+	{
+		const Transform& local = graph.GetLocalTransform(node);
+		return myMath.MakeAffineMatrix(local.scale, local.rotate, local.translate);
+	}
+
+	//ワールド行列が ローカル行列 * 親のワールド行列 になっているか
+	bool CheckWorldMatrix(MyMath& myMath, TransformGraph& graph, uint32_t node)
+	{
+		const uint32_t parent = graph.GetParent(node);
+		const Matrix4x4 localMatrix = MakeLocalMatrix(myMath, graph, node);
+		const Matrix4x4 expected = parent == TransformGraph::kNoParent ? localMatrix : myMath.Multiply(localMatrix, graph.GetWorldMatrix(parent));
+		return SameMatrix(graph.GetWorldMatrix(node), expected);
+	}
+
+	//全ノードの更新回数
+	void GetVersions(TransformGraph& graph, uint32_t* outVersions)
+	{
+		for (uint32_t node = 0; node < graph.GetNodeCount(); ++node)
+		{
+			outVersions[node] = graph.GetWorldVersion(node);
+		}
+	}
+}
+
+//変更のあったノードとその子孫だけが計算し直され、親の付け替えや値の変わらない設定でも行列と更新回数が正しいか
+int main()
+{
+	MyMath myMath;
+	TransformGraph graph;
+
+	//root ─ child ─ grandchild と、別の root2 ─ other
+	const uint32_t root = graph.CreateNode();
+	const uint32_t child = graph.CreateNode(root);
+	const uint32_t grandchild = graph.CreateNode(child);
+	const uint32_t root2 = graph.CreateNode();
+	const uint32_t other = graph.CreateNode(root2);
+	constexpr uint32_t kNodeCount = 5;
+	CHECK(graph.GetNodeCount() == kNodeCount);
+
+	graph.SetLocalTransform(root, MakeTransform({ 2.0f,2.0f,2.0f }, { 0.1f,0.2f,0.3f }, { 10.0f,0.0f,0.0f }));
+	graph.SetLocalTransform(child, MakeTransform({ 1.0f,0.5f,1.0f }, { 0.0f,0.0f,0.7f }, { 0.0f,5.0f,0.0f }));
+	graph.SetLocalTransform(grandchild, MakeTransform({ 1.0f,1.0f,1.0f }, { 0.4f,0.0f,0.0f }, { 1.0f,2.0f,3.0f }));
+	graph.SetLocalTransform(root2, MakeTransform({ 1.0f,1.0f,1.0f }, { 0.0f,0.5f,0.0f }, { -4.0f,0.0f,1.0f }));
+	graph.SetLocalTransform(other, MakeTransform({ 3.0f,3.0f,3.0f }, { 0.0f,0.0f,0.0f }, { 0.0f,0.0f,2.0f }));
+
+	//===Updateを呼ばなくても、取得した時に親から辿って計算される===
+	CHECK(CheckWorldMatrix(myMath, graph, grandchild));
+	graph.Update();
+	uint32_t versions[kNodeCount];
+	GetVersions(graph, versions);
+	for (uint32_t node = 0; node < kNodeCount; ++node)
+	{
+		CHECK(CheckWorldMatrix(myMath, graph, node));
+		CHECK(versions[node] == 1);
+	}
+
+	//===変更が無ければ、Updateしても同じ値を設定しても計算し直さない===
+	{
+		graph.Update();
+		graph.SetLocalTransform(child, graph.GetLocalTransform(child));
+		graph.Update();
+		uint32_t after[kNodeCount];
+		GetVersions(graph, after);
+		CHECK(std::memcmp(after, versions, sizeof(versions)) == 0);
+	}
+
+	//===子を変えると、親と別の木はそのままで子孫だけ計算し直す===
+	{
+		Transform transform = graph.GetLocalTransform(child);
+		transform.translate.x += 1.0f;
+		graph.SetLocalTransform(child, transform);
+		graph.Update();
+		uint32_t after[kNodeCount];
+		GetVersions(graph, after);
+		CHECK(after[root] == versions[root]);
+		CHECK(after[child] == versions[child] + 1);
+		CHECK(after[grandchild] == versions[grandchild] + 1);
+		CHECK(after[root2] == versions[root2]);
+		CHECK(after[other] == versions[other]);
+		CHECK(CheckWorldMatrix(myMath, graph, child));
+		CHECK(CheckWorldMatrix(myMath, graph, grandchild));
+		std::memcpy(versions, after, sizeof(versions));
+	}
+
+	//===親を変えると、子孫まで全て伝わる===
+	{
+		Transform transform = graph.GetLocalTransform(root);
+		transform.rotate.z += 0.25f;
+		graph.SetLocalTransform(root, transform);
+		graph.Update();
+		uint32_t after[kNodeCount];
+		GetVersions(graph, after);
+		CHECK(after[root] == versions[root] + 1);
+		CHECK(after[child] == versions[child] + 1);
+		CHECK(after[grandchild] == versions[grandchild] + 1);
+		CHECK(after[root2] == versions[root2]);
+		CHECK(after[other] == versions[other]);
+		for (uint32_t node = 0; node < kNodeCount; ++node)
+		{
+			CHECK(CheckWorldMatrix(myMath, graph, node));
+		}
+		std::memcpy(versions, after, sizeof(versions));
+	}
+
+	//===親の付け替え===
+	{
+		//同じ親なら何も変わらない
+		graph.SetParent(grandchild, child);
+		graph.Update();
+		CHECK(graph.GetWorldVersion(grandchild) == versions[grandchild]);
+
+		//別の木(前に並んでいるroot2)に付け替えると、新しい親のワールド行列を引き継ぐ
+		graph.SetParent(grandchild, root2);
+		CHECK(graph.GetParent(grandchild) == root2);
+		graph.Update();
+		CHECK(graph.GetWorldVersion(grandchild) == versions[grandchild] + 1);
+		CHECK(CheckWorldMatrix(myMath, graph, grandchild));
+		versions[grandchild] = graph.GetWorldVersion(grandchild);
+
+		//前の親を変えても、もう伝わらない
+		Transform transform = graph.GetLocalTransform(child);
+		transform.translate.y -= 2.0f;
+		graph.SetLocalTransform(child, transform);
+		graph.Update();
+		CHECK(graph.GetWorldVersion(grandchild) == versions[grandchild]);
+
+		//新しい親を変えると伝わる(Updateを呼ばずに取得しても同じ)
+		transform = graph.GetLocalTransform(root2);
+		transform.translate.z += 3.0f;
+		graph.SetLocalTransform(root2, transform);
+		CHECK(graph.GetWorldVersion(grandchild) == versions[grandchild] + 1);
+		CHECK(CheckWorldMatrix(myMath, graph, grandchild));
+		versions[grandchild] = graph.GetWorldVersion(grandchild);
+
+		//親を外すとローカル行列がそのままワールド行列になる
+		graph.SetParent(grandchild, TransformGraph::kNoParent);
+		CHECK(graph.GetWorldVersion(grandchild) == versions[grandchild] + 1);
+		CHECK(SameMatrix(graph.GetWorldMatrix(grandchild), MakeLocalMatrix(myMath, graph, grandchild)));
+	}
+
+	//===スプライトの大きさは四角形だけに掛かり、子のノードには伝わらない===
+	{
+		TransformGraph spriteGraph;
+		const uint32_t parentSprite = spriteGraph.CreateNode();
+		const uint32_t childSprite = spriteGraph.CreateNode(parentSprite);
+		spriteGraph.SetLocalTransform(parentSprite, MakeTransform({ 1.0f,1.0f,1.0f }, { 0.0f,0.0f,0.5f }, { 100.0f,50.0f,0.0f }));
+		spriteGraph.SetLocalTransform(childSprite, MakeTransform({ 1.0f,1.0f,1.0f }, { 0.0f,0.0f,0.0f }, { 20.0f,0.0f,0.0f }));
+		const Vector2 parentSize = { 640.0f,360.0f };
+		const Vector2 childSize = { 32.0f,16.0f };
+
+		const Matrix4x4& parentWorld = spriteGraph.GetWorldMatrix(parentSprite);
+		const Matrix4x4 parentQuad = SpriteGeometry::MakeQuadWorldMatrix(parentWorld, parentSize);
+		CHECK(SameMatrix(parentQuad, myMath.Multiply(myMath.MakeAffineMatrix({ parentSize.x,parentSize.y,1.0f }, Vector3{ 0.0f,0.0f,0.0f }, Vector3{ 0.0f,0.0f,0.0f }), parentWorld)));
+
+		//子の位置は親の回転だけを受け、親の大きさ(640倍)は受けない
+		const Matrix4x4 childQuad = SpriteGeometry::MakeQuadWorldMatrix(spriteGraph.GetWorldMatrix(childSprite), childSize);
+		const Matrix4x4 expectedChildQuad = myMath.Multiply(myMath.MakeAffineMatrix({ childSize.x,childSize.y,1.0f }, Vector3{ 0.0f,0.0f,0.0f }, Vector3{ 0.0f,0.0f,0.0f }), myMath.Multiply(MakeLocalMatrix(myMath, spriteGraph, childSprite), parentWorld));
+		CHECK(SameMatrix(childQuad, expectedChildQuad));
+		CHECK(childQuad.m[3][0] > 100.0f && childQuad.m[3][0] < 120.0f);
+		CHECK(childQuad.m[3][1] > 50.0f && childQuad.m[3][1] < 70.0f);
+	}
+
+	return TestCheck::Finish("TransformGraph");
+}
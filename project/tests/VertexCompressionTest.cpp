@@ -0,0 +1,109 @@
+#include "TestCheck.h"
+#include "VertexCompression.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+	//半精度浮動小数点の変換(既知の値・丸め・全ての値の往復)
+	void CheckHalf()
+	{
+		using VertexCompression::FloatToHalf;
+		using VertexCompression::HalfToFloat;
+
+		CHECK(FloatToHalf(0.0f) == 0x0000);
+		CHECK(FloatToHalf(-0.0f) == 0x8000);
+		CHECK(FloatToHalf(1.0f) == 0x3C00);
+		CHECK(FloatToHalf(-2.0f) == 0xC000);
+		CHECK(FloatToHalf(0.5f) == 0x3800);
+		CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+		//最小の非正規化数
+		CHECK(FloatToHalf(std::ldexp(1.0f, -24)) == 0x0001);
+		//範囲外は無限大、小さすぎれば0
+		CHECK(FloatToHalf(65520.0f) == 0x7C00);
+		CHECK(FloatToHalf(-1.0e10f) == 0xFC00);
+		CHECK(FloatToHalf(std::ldexp(1.0f, -26)) == 0x0000);
+		CHECK(FloatToHalf(INFINITY) == 0x7C00);
+		CHECK(std::isnan(HalfToFloat(FloatToHalf(NAN))));
+
+		//最近接偶数への丸め(1の次は1+2^-10)
+		CHECK(FloatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3C00);
+		CHECK(FloatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3C02);
+		CHECK(FloatToHalf(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)) == 0x3C01);
+
+		//NaN以外の全ての半精度は、floatにして戻すと同じビットになる
+		uint32_t mismatchCount = 0;
+		for (uint32_t bits = 0; bits <= 0xFFFF; ++bits)
+		{
+			const uint16_t half = static_cast<uint16_t>(bits);
+			const float value = HalfToFloat(half);
+			if (std::isnan(value))
+			{
+				CHECK((half & 0x7C00) == 0x7C00 && (half & 0x03FF) != 0);
+				continue;
+			}
+			mismatchCount += FloatToHalf(value) != half ? 1 : 0;
+		}
+		CHECK(mismatchCount == 0);
+	}
+
+	//モデルの圧縮と復元の誤差が、VertexCompression.hに書いた上限に収まるか
+	void CheckModel()
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> position(-3.0f, 5.0f);
+		std::uniform_real_distribution<float> texcoord(0.0f, 1.0f);
+		std::normal_distribution<float> direction(0.0f, 1.0f);
+
+		ModelData modelData;
+		for (uint32_t i = 0; i < 4096; ++i)
+		{
+			Vector3 normal{ direction(random), direction(random), direction(random) };
+			const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			normal = { normal.x / length, normal.y / length, normal.z / length };
+			modelData.vertices.push_back({ { position(random), position(random) * 0.25f, position(random) * 2.0f, 1.0f }, { texcoord(random), texcoord(random) }, normal });
+		}
+		//軸の向きの法線と、長さ0の法線(誤差からは除く)
+		const Vector3 axes[] = { { 1.0f,0.0f,0.0f },{ -1.0f,0.0f,0.0f },{ 0.0f,1.0f,0.0f },{ 0.0f,-1.0f,0.0f },{ 0.0f,0.0f,1.0f },{ 0.0f,0.0f,-1.0f },{ 0.0f,0.0f,0.0f } };
+		for (const Vector3& axis : axes)
+		{
+			modelData.vertices.push_back({ { 0.0f,0.0f,0.0f,1.0f }, { 1.0f,0.0f }, axis });
+		}
+		modelData.indices = { 0, 1, 2 };
+		modelData.submeshes = { { 0, 3, 0 } };
+
+		const CompactModelData compactModelData = VertexCompression::Compress(modelData);
+		CHECK(compactModelData.vertices.size() == modelData.vertices.size());
+		CHECK(compactModelData.indices == modelData.indices);
+		CHECK(compactModelData.submeshes.size() == 1);
+
+		const CompressionError error = VertexCompression::MeasureError(modelData, compactModelData);
+		const Vector3& scale = compactModelData.positionScale;
+		const float positionBound = std::sqrt(scale.x * scale.x + scale.y * scale.y + scale.z * scale.z) * VertexCompression::kPositionErrorPerScale;
+		std::printf("position %g (bound %g), texcoord %g (bound %g), normal %g rad (bound %g)\n",
+			error.maxPositionError, positionBound, error.maxTexcoordError, VertexCompression::kTexcoordError, error.maxNormalAngleError, VertexCompression::kNormalAngleError);
+		CHECK(error.maxPositionError <= positionBound);
+		CHECK(error.maxTexcoordError <= VertexCompression::kTexcoordError);
+		CHECK(error.maxNormalAngleError <= VertexCompression::kNormalAngleError);
+
+		//軸の向きの法線はそのまま戻る
+		const ModelData decompressed = VertexCompression::Decompress(compactModelData);
+		for (size_t i = 0; i < 6; ++i)
+		{
+			const Vector3& restored = decompressed.vertices[4096 + i].normal;
+			CHECK(restored.x == axes[i].x && restored.y == axes[i].y && restored.z == axes[i].z);
+		}
+	}
+}
+
+//頂点の圧縮(半精度、位置の量子化、八面体エンコード)
+int main()
+{
+	CheckHalf();
+	CheckModel();
+	return TestCheck::Finish("VertexCompression");
+}